@@ -0,0 +1,42 @@
+#include "a2dp_dsp.h"
+#include "telemetry.h"
+#include "power.h"
+
+bool A2DPDspVolumeControl::addEffect(AudioEffectBlock* effect) {
+    if (_count >= A2DP_DSP_MAX_EFFECTS) return false;
+    _effects[_count++] = effect;
+    return true;
+}
+
+void A2DPDspVolumeControl::update_audio_data(Frame* data, uint16_t frameCount) {
+    // Lautstärke wie gehabt von der Standard-Implementierung
+    A2DPDefaultVolumeControl::update_audio_data(data, frameCount);
+    if (data == nullptr || frameCount == 0) return;
+    telemetry_a2dp_packet();
+
+    // Frame ist ein gepacktes Paar aus int16_t (links, rechts), also dasselbe Layout wie im Radio-Pfad.
+    // Gepackt heißt aber Ausrichtung 1: die Effekte lesen int16_t und brauchen 2-Byte-Ausrichtung,
+    // die der Typ nicht zusichert. Voraussetzung ist daher, dass der Stack den PCM-Puffer aus dem
+    // Heap übergibt (ESP32-A2DP: mindestens 4-Byte-ausgerichtet); ein ungerader Zeiger würde auf dem
+    // Xtensa eine Ausnahme auslösen und wird ohne DSP durchgereicht.
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(data);
+    if (reinterpret_cast<uintptr_t>(bytes) % alignof(int16_t) != 0) return;
+    int16_t* frames = reinterpret_cast<int16_t*>(bytes);
+
+    DSP_PROFILE_BEGIN();
+    uint32_t start = ESP.getCycleCount();
+
+    // Ratenwechsel im selben Thread wie die Verarbeitung übernehmen
+    uint16_t rate = _pendingRate;
+    if (rate != 0) {
+        _pendingRate = 0;
+        for (uint8_t i = 0; i < _count; i++) _effects[i]->SetRate(rate);
+    }
+
+    for (uint8_t i = 0; i < _count; i++) {
+        _effects[i]->ProcessInPlace(frames, frameCount);
+    }
+
+    power_work(ESP.getCycleCount() - start);
+    DSP_PROFILE_END(_profile, 1);
+}
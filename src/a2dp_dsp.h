@@ -0,0 +1,29 @@
+#pragma once
+#include "BluetoothA2DPSink.h"
+#include "audio_effect.h"
+
+#define A2DP_DSP_MAX_EFFECTS 2
+
+/**
+ * @brief Hängt die DSP-Effekte in den Bluetooth-Datenpfad.
+ * ESP32-A2DP ruft update_audio_data() für jedes dekodierte Paket auf, bevor es zur I2S-Ausgabe geht.
+ * Die Effekte rechnen dort in-place auf dem Paketpuffer: keine Kopie, keine Allokation pro Paket.
+ */
+class A2DPDspVolumeControl : public A2DPDefaultVolumeControl {
+public:
+    // Effekte laufen in der Reihenfolge, in der sie hinzugefügt wurden
+    bool addEffect(AudioEffectBlock* effect);
+
+    // Aus dem Sample-Rate-Callback des A2DP-Stacks; übernommen wird erst im Datenpfad
+    void setSampleRate(uint16_t hz) { _pendingRate = hz; }
+
+    void update_audio_data(Frame* data, uint16_t frameCount) override;
+
+private:
+    AudioEffectBlock* _effects[A2DP_DSP_MAX_EFFECTS];
+    uint8_t _count = 0;
+    volatile uint16_t _pendingRate = 0;
+#ifdef DSP_PROFILE
+    DspProfile _profile{"A2DP", "Paket", 2000};
+#endif
+};
@@ -0,0 +1,127 @@
+#include "a2dp_output.h"
+#include "power.h"
+
+// Wie der Audio-Task im Radio-Modus: Kern 1, über loop()
+#define A2DP_TASK_CORE 1
+#define A2DP_TASK_PRIORITY 5
+#define A2DP_TASK_STACK 4096
+
+A2DPBufferedOutput::A2DPBufferedOutput() {
+    _bytes = (uint32_t)A2DP_BUFFER_RATE * A2DP_BUFFER_MS / 1000 * 4;
+    if (psramFound()) _mem = (uint8_t*)ps_malloc(_bytes);
+    if (!_mem) {
+        Serial.println("A2DP-Puffer: kein PSRAM, Ausgabe direkt auf I2S.");
+        return;
+    }
+    // Ring-Größe ist ein Vielfaches von 4: Frames liegen nie über dem Pufferende verteilt
+    _ring.init(_mem, _bytes);
+    _wake = xSemaphoreCreateBinary();
+    _idle = xSemaphoreCreateBinary();
+    xTaskCreatePinnedToCore(outputTask, "a2dp_out", A2DP_TASK_STACK, this,
+                            A2DP_TASK_PRIORITY, &_task, A2DP_TASK_CORE);
+    Serial.printf("A2DP-Puffer: %u ms im PSRAM\n", A2DP_BUFFER_MS);
+}
+
+A2DPBufferedOutput::~A2DPBufferedOutput() {
+    end();
+    if (_task) vTaskDelete(_task);
+    if (_wake) vSemaphoreDelete(_wake);
+    if (_idle) vSemaphoreDelete(_idle);
+    free(_mem);
+}
+
+bool A2DPBufferedOutput::begin() {
+    if (!BluetoothA2DPOutputLegacy::begin()) return false;
+    if (_task && !_running) {
+        _ring.init(_mem, _bytes);
+        _resampler.reset();
+        _controller.reset();
+        _running = true;
+        xSemaphoreGive(_wake);
+    }
+    return true;
+}
+
+void A2DPBufferedOutput::end() {
+    if (_running) {
+        _running = false;
+        // Der Task darf I2S nicht mehr beschreiben, wenn der Treiber freigegeben wird
+        xSemaphoreTake(_idle, portMAX_DELAY);
+    }
+    BluetoothA2DPOutputLegacy::end();
+}
+
+size_t A2DPBufferedOutput::write(const uint8_t* data, size_t len) {
+    if (!_running) return BluetoothA2DPOutputLegacy::write(data, len);
+
+    // Nur ganze Frames; ist der Ring voll, hat die Regelung versagt und das Paket wird verworfen
+    size_t frames = len / 4;
+    size_t space = _ring.space() / 4;
+    if (frames > space) {
+        _dropped += frames - space;
+        frames = space;
+    }
+    _ring.write(data, frames * 4);
+    return len;
+}
+
+void A2DPBufferedOutput::outputTask(void* arg) {
+    A2DPBufferedOutput* self = (A2DPBufferedOutput*)arg;
+    for (;;) {
+        xSemaphoreTake(self->_wake, portMAX_DELAY);
+        self->run();
+        xSemaphoreGive(self->_idle);
+    }
+}
+
+void A2DPBufferedOutput::run() {
+    int16_t in[2 * A2DP_OUTPUT_BLOCK];
+    int16_t out[2 * A2DP_OUTPUT_BLOCK];
+    uint16_t in_pos = 0;
+    uint16_t in_len = 0;
+    bool priming = true;
+    uint32_t last_stats = millis();
+
+    while (_running) {
+        uint32_t fill = _ring.fill() / 4 + (in_len - in_pos);
+
+        // Erst halb voll puffern; bis dahin hält Stille den I2S-Takt am Laufen
+        if (priming && fill < targetFrames()) {
+            memset(out, 0, sizeof(out));
+            BluetoothA2DPOutputLegacy::write((const uint8_t*)out, sizeof(out));
+            continue;
+        }
+        priming = false;
+
+        uint32_t start = ESP.getCycleCount();
+        _resampler.setPpm(_controller.update(fill, targetFrames()));
+
+        uint16_t produced = 0;
+        while (produced < A2DP_OUTPUT_BLOCK) {
+            if (in_pos == in_len) {
+                in_len = _ring.read((uint8_t*)in, sizeof(in)) / 4;
+                in_pos = 0;
+                if (in_len == 0) break;
+            }
+            uint16_t used;
+            produced += _resampler.process(in + 2 * in_pos, in_len - in_pos, used,
+                                           out + 2 * produced, A2DP_OUTPUT_BLOCK - produced);
+            in_pos += used;
+        }
+        if (produced < A2DP_OUTPUT_BLOCK) {
+            // Ring leer (Telefon pausiert oder Verbindung gestört): Rest mit Stille, neu puffern
+            memset(out + 2 * produced, 0, (A2DP_OUTPUT_BLOCK - produced) * 4);
+            _underruns++;
+            priming = true;
+        }
+        power_work(ESP.getCycleCount() - start);
+        // Blockiert, bis die DMA-Puffer Platz haben: gibt dem Task den I2S-Takt vor
+        BluetoothA2DPOutputLegacy::write((const uint8_t*)out, sizeof(out));
+
+        if (millis() - last_stats >= A2DP_STATS_INTERVAL_MS) {
+            Serial.printf("[A2DP] Puffer %u ms, Drift %d ppm, leergelaufen %u, verworfen %u Frames\n",
+                          fill * 1000 / A2DP_BUFFER_RATE, _controller.integralPpm(), _underruns, _dropped);
+            last_stats = millis();
+        }
+    }
+}
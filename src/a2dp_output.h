@@ -0,0 +1,55 @@
+#pragma once
+#include <Arduino.h>
+#include "BluetoothA2DPOutput.h"
+#include "spsc_ring.h"
+#include "drift_resampler.h"
+
+// Tiefe des Puffers zwischen A2DP-Stack und I2S; geregelt wird auf die Hälfte
+#ifndef A2DP_BUFFER_MS
+#define A2DP_BUFFER_MS 400
+#endif
+// Für diese Rate wird der Puffer angelegt (48 kHz bekommt entsprechend weniger ms)
+#define A2DP_BUFFER_RATE 44100
+// Frames pro Schreibzugriff auf I2S
+#define A2DP_OUTPUT_BLOCK 128
+#define A2DP_STATS_INTERVAL_MS 10000
+
+/**
+ * @brief A2DP-Ausgabe mit PSRAM-Puffer und Driftausgleich.
+ * write() wird vom A2DP-Stack mit den (bereits gefilterten) PCM-Paketen aufgerufen und legt sie nur
+ * im SPSC-Ring ab. Ein eigener Task (Kern 1, wie der Audio-Task im Radio) liest den Ring, gleicht
+ * mit DriftResampler den Taktunterschied Telefon <-> I2S aus und schreibt blockweise auf I2S;
+ * DriftController hält dabei den Füllstand in der Mitte. Läuft der Ring leer, spielt der Task
+ * Stille, bis er wieder halb voll ist.
+ * Ohne PSRAM verhält sich die Klasse wie BluetoothA2DPOutputLegacy.
+ */
+class A2DPBufferedOutput : public BluetoothA2DPOutputLegacy {
+public:
+    A2DPBufferedOutput();
+    virtual ~A2DPBufferedOutput();
+
+    bool begin() override;
+    void end() override;
+    size_t write(const uint8_t* data, size_t len) override;
+
+    // Aussetzer (Ring leer) seit dem Start
+    uint32_t underruns() const { return _underruns; }
+
+private:
+    uint8_t* _mem = nullptr;
+    uint32_t _bytes = 0;
+    SpscRing _ring;
+    DriftResampler _resampler;
+    DriftController _controller;
+    uint32_t _dropped = 0;
+
+    TaskHandle_t _task = nullptr;
+    SemaphoreHandle_t _wake = nullptr;
+    SemaphoreHandle_t _idle = nullptr;
+    volatile bool _running = false;
+    volatile uint32_t _underruns = 0;
+
+    static void outputTask(void* arg);
+    void run();
+    uint32_t targetFrames() const { return _ring.capacity() / 4 / 2; }
+};
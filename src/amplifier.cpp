@@ -1,12 +1,68 @@
 #include <Arduino.h>
 #include <tas5805m.hpp>
 #include <Wire.h>
-#include <Preferences.h>
 #include "amplifier.h"
+#include "tas5805m_dsp.h"
+#include "settings.h"
 
-extern Preferences preferences;
 static tas5805m amplifier(&Wire);
-static int currentVolume = TAS5805M_VOLUME_DEFAULT;  // z.B. 48 = 0 dB
+
+// Registerzugriff auf den TAS5805M über den gemeinsamen I2C-Bus
+class WireRegisterBus : public TasRegisterBus {
+public:
+    bool write(uint8_t reg, const uint8_t* data, uint8_t len) override {
+        Wire.beginTransmission(AMP_I2C_ADDR);
+        Wire.write(reg);
+        Wire.write(data, len);
+        return Wire.endTransmission() == 0;
+    }
+
+    bool read(uint8_t reg, uint8_t* data, uint8_t len) override {
+        Wire.beginTransmission(AMP_I2C_ADDR);
+        Wire.write(reg);
+        if (Wire.endTransmission(false) != 0) return false;
+        if (Wire.requestFrom((uint8_t)AMP_I2C_ADDR, len) != len) return false;
+        for (uint8_t i = 0; i < len; i++) data[i] = Wire.read();
+        return true;
+    }
+};
+
+// Biquad-Sequenzen wechseln die Page; Lautstärke-Zugriffe dürfen nicht dazwischen kommen
+static SemaphoreHandle_t amp_lock = nullptr;
+static WireRegisterBus amp_bus;
+static Tas5805mVolumeSink amp_volume(amp_bus);
+static VolumeEngine volume;
+static TaskHandle_t volume_task_handle = nullptr;
+
+// Im NVS steht die Lautstärke wie bisher als TAS5805M_VOLUME_MAX - Registerwert
+static uint16_t levelFromStored(int stored) {
+    int reg = constrain(TAS5805M_VOLUME_MAX - stored, 0, TAS5805M_DIG_VOL_MUTE);
+    if (reg == TAS5805M_DIG_VOL_MUTE) return 0;
+    return VolumeEngine::fromDb(Tas5805mVolumeSink::toDb(reg));
+}
+
+static int storedFromLevel(uint16_t level) {
+    return TAS5805M_VOLUME_MAX - Tas5805mVolumeSink::registerValue(VolumeEngine::toDb(level), level == 0);
+}
+
+// Fährt die Lautstärke-Rampe: höchstens ein Schreibzugriff pro Zeitscheibe, ruht ohne Änderungen
+static void volume_task(void* param) {
+    for (;;) {
+        if (!volume.busy()) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        xSemaphoreTake(amp_lock, portMAX_DELAY);
+        volume.tick();
+        xSemaphoreGive(amp_lock);
+
+        // Nur im RAM; settings_poll() schreibt, wenn der Encoder ruht
+        if (volume.sink() == &amp_volume) settings_set_volume(storedFromLevel(volume.target()));
+        vTaskDelay(pdMS_TO_TICKS(VOLUME_SLICE_MS));
+    }
+}
+
+static void volume_wake() {
+    if (volume_task_handle) xTaskNotifyGive(volume_task_handle);
+}
 
 void init_amplifier() {
     Wire.begin(PIN_I2C_SDA, PIN_I2C_SCL);
@@ -14,29 +70,56 @@ void init_amplifier() {
     if (err != ESP_OK) {
         Serial.printf("TAS5805M Init fehlgeschlagen! Fehlercode: 0x%X (%s)\n", err, esp_err_to_name(err));
     } else {
-        amplifier.setVolume(currentVolume);
         Serial.println("TAS5805M erfolgreich initialisiert.");
     }
 
-    preferences.begin("audio_config", true);
-    currentVolume = preferences.getUInt("audio_volume", TAS5805M_VOLUME_DEFAULT);
-    preferences.end();
+    amp_lock = xSemaphoreCreateMutex();
+    xTaskCreatePinnedToCore(volume_task, "volume", VOLUME_TASK_STACK, nullptr,
+                            VOLUME_TASK_PRIORITY, &volume_task_handle, VOLUME_TASK_CORE);
+    volume_use_amplifier();
+}
 
-    amplifier.setVolume(TAS5805M_VOLUME_MAX -currentVolume);
+void volume_step(int detents) {
+    volume.step(detents);
+    volume_wake();
 }
 
-void inc_amplifier(int inc) {
-    currentVolume = constrain(currentVolume + inc, TAS5805M_VOLUME_MIN, TAS5805M_VOLUME_MAX);
-    amplifier.setVolume(TAS5805M_VOLUME_MAX - currentVolume);
-    preferences.begin("audio_config", false);
-    preferences.putUInt("audio_volume", currentVolume);
-    preferences.end();
+void volume_use_amplifier() {
+    volume.route(&amp_volume, levelFromStored(settings_volume()));
+    volume_wake();
+}
+
+void volume_use_sink(VolumeSink* sink, uint16_t level, uint8_t amp_percent) {
+    volume.route(sink, level);
+    volume_wake();
+
+    // Verstärker fest einstellen; die Engine schreibt ihn nicht mehr, sobald sie umgeschaltet hat
+    int vol = map(constrain(amp_percent, 0, 100), 0, 100, TAS5805M_VOLUME_MIN, TAS5805M_VOLUME_MAX);
+    xSemaphoreTake(amp_lock, portMAX_DELAY);
+    amplifier.setVolume(TAS5805M_VOLUME_MAX - vol);
+    xSemaphoreGive(amp_lock);
 }
 
-void set_amplifier_temp_volume(uint8_t percent) {
-    percent = constrain(percent, 0, 100);
-    int vol = map(percent,0, 100, TAS5805M_VOLUME_MIN, TAS5805M_VOLUME_MAX);
-    currentVolume = vol;
-    Serial.println(TAS5805M_VOLUME_MAX - currentVolume);
-    amplifier.setVolume(TAS5805M_VOLUME_MAX - currentVolume);
+void volume_sync(uint16_t level) {
+    volume.sync(level);
+    volume_wake();
+}
+
+bool amplifier_load_biquads(const BiquadCoefficients* biquads, uint8_t count) {
+    Tas5805mDsp dsp(amp_bus);
+    xSemaphoreTake(amp_lock, portMAX_DELAY);
+
+    bool ok = count <= TAS5805M_BQ_PER_CHANNEL;
+    for (uint8_t i = 0; ok && i < count; i++) {
+        ok = dsp.writeBiquad(0, i, biquads[i]) && dsp.writeBiquad(1, i, biquads[i]);
+    }
+    ok = ok && dsp.setEqEnabled(true);
+    // Auch im Fehlerfall zurück auf Page 0, damit die Lautstärke-Zugriffe weiter stimmen
+    ok = dsp.restoreDefaultPage() && ok;
+    xSemaphoreGive(amp_lock);
+
+    if (!ok) {
+        Serial.println("TAS5805M: Laden der DSP-Koeffizienten fehlgeschlagen.");
+    }
+    return ok;
 }
@@ -1,17 +1,49 @@
 #ifndef AMPLIFIER_H
 #define AMPLIFIER_H
 
+#include <stdint.h>
+#include "biquad.h"
+#include "volume_engine.h"
 
+// Lautstärke-Task: niedrige Priorität, auf dem Netzwerk-Kern (der Audio-Task läuft auf Kern 1)
+#define VOLUME_TASK_CORE     0
+#define VOLUME_TASK_PRIORITY 2
+#define VOLUME_TASK_STACK    3072
 
 /**
- * @brief Initialisiert den Rotary Encoder und den TAS5805M Verstärker.
- * Muss einmal in der setup()-Funktion aufgerufen werden.
+ * @brief Initialisiert den TAS5805M Verstärker und startet den Lautstärke-Task.
+ * Muss einmal in der setup()-Funktion aufgerufen werden. Danach regelt der Encoder den Verstärker.
  */
 void init_amplifier();
 
-void inc_amplifier(int inc);
+/**
+ * @brief Ändert die Lautstärke der gerade gewählten Ausgabe um Encoder-Rasten (VOLUME_STEP_DB je Raste).
+ * Kehrt sofort zurück: der Lautstärke-Task fasst schnelle Drehungen zusammen, fährt sie als Rampe an
+ * und schreibt höchstens einmal pro VOLUME_SLICE_MS.
+ */
+void volume_step(int detents);
+
+/**
+ * @brief Der Encoder regelt den Verstärker, ausgehend von der gespeicherten Lautstärke
+ * (z.B. beim Wechsel von Bluetooth zurück ins Radio).
+ */
+void volume_use_amplifier();
 
-void set_amplifier_temp_volume(uint8_t percent);
+/**
+ * @brief Der Encoder regelt eine andere Ausgabe (z.B. A2DP) ab 'level';
+ * der Verstärker steht dabei fest auf amp_percent.
+ */
+void volume_use_sink(VolumeSink* sink, uint16_t level, uint8_t amp_percent);
+
+// Die Ausgabe wurde von außen geändert (z.B. am Telefon): Pegel übernehmen, ohne zu schreiben
+void volume_sync(uint16_t level);
+
+/**
+ * @brief Lädt Biquads in den DSP des TAS5805M (beide Kanäle, ab Biquad 0) und schaltet dessen EQ ein.
+ * Damit kostet die Filterung keine ESP32-Zyklen mehr.
+ * @return false, wenn ein I2C-Zugriff fehlschlägt; dann bleibt die Filterung in Software.
+ */
+bool amplifier_load_biquads(const BiquadCoefficients* biquads, uint8_t count);
 
 
 #endif // AMPLIFIER_H
\ No newline at end of file
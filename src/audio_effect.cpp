@@ -0,0 +1,147 @@
+#include "audio_effect.h"
+#include <string.h>
+
+// Übliche Raten von Internet-Radio (MP3/AAC) und A2DP; seltenere Raten nutzen die nächstliegende Spalte
+const uint32_t dsp_rates[DSP_RATE_COUNT] = { 22050, 24000, 32000, 44100, 48000 };
+
+uint8_t dsp_rate_index(uint32_t hz) {
+    uint8_t best = 0;
+    uint32_t best_diff = UINT32_MAX;
+    for (uint8_t i = 0; i < DSP_RATE_COUNT; i++) {
+        uint32_t diff = (hz > dsp_rates[i]) ? hz - dsp_rates[i] : dsp_rates[i] - hz;
+        if (diff < best_diff) {
+            best_diff = diff;
+            best = i;
+        }
+    }
+    return best;
+}
+
+AudioEffectBlock::AudioEffectBlock(AudioOutput* next, const char* name)
+    : _next(next)
+#ifdef DSP_PROFILE
+    , _profile(name)
+#endif
+{
+    (void)name;
+    hertz = 0; // erster SetRate() des Decoders gilt immer als Wechsel
+}
+
+bool AudioEffectBlock::begin() {
+    return _next ? _next->begin() : true;
+}
+
+// Format-Änderungen des Decoders an die Ausgabe durchreichen.
+// Der MP3-Decoder ruft SetRate() bei jedem Frame, daher nur bei echter Änderung reagieren.
+bool AudioEffectBlock::SetRate(int hz) {
+    if (hz != hertz) {
+        // Noch gesammelte Samples gehören zur alten Rate und werden mit den alten Koeffizienten abgegeben
+        closeBlock();
+        flushBlock();
+        hertz = hz;
+        rateChanged(hz);
+    }
+    return _next ? _next->SetRate(hz) : true;
+}
+
+bool AudioEffectBlock::SetBitsPerSample(int bits) {
+    bps = bits;
+    return _next ? _next->SetBitsPerSample(bits) : true;
+}
+
+bool AudioEffectBlock::SetChannels(int chan) {
+    channels = chan;
+    return _next ? _next->SetChannels(chan) : true;
+}
+
+bool AudioEffectBlock::stop() {
+    // Halbfertigen Block und Filter-Zustand verwerfen, damit der nächste Stream sauber startet
+    _blockFill = _blockSent = _blockReady = 0;
+    reset();
+    return _next ? _next->stop() : true;
+}
+
+void AudioEffectBlock::flush() {
+    closeBlock();
+    flushBlock();
+    if (_next) _next->flush();
+}
+
+bool AudioEffectBlock::loop() {
+    flushBlock();
+    return _next ? _next->loop() : true;
+}
+
+void AudioEffectBlock::runProcess(int16_t* frames, uint16_t count) {
+    if (_bypass) return;
+    DSP_PROFILE_BEGIN();
+    process(frames, count);
+    DSP_PROFILE_END(_profile, count);
+}
+
+// Verarbeitet einen angefangenen Sammelblock, damit er abgegeben werden kann
+void AudioEffectBlock::closeBlock() {
+    if (_blockReady == 0 && _blockFill > 0) {
+        runProcess(_block, _blockFill);
+        _blockReady = _blockFill;
+    }
+}
+
+// Gibt den Sammelblock weiter. false, solange die Ausgabe noch nicht alles abgenommen hat.
+bool AudioEffectBlock::flushBlock() {
+    if (_blockReady == 0) return true;
+    if (!_next) {
+        // Ohne nächste Stufe (z.B. nach dem Abbau der Radio-Ausgabe) gibt es niemanden, der abnimmt
+        _blockFill = _blockSent = _blockReady = 0;
+        return true;
+    }
+    _blockSent += _next->ConsumeSamples(_block + 2 * _blockSent, _blockReady - _blockSent);
+    if (_blockSent < _blockReady) return false;
+    _blockFill = _blockSent = _blockReady = 0;
+    return true;
+}
+
+bool AudioEffectBlock::ConsumeSample(int16_t* sample) {
+    // Erst muss der vorige Block vollständig bei der Ausgabe sein (Gegendruck an den Generator)
+    if (!flushBlock()) return false;
+
+    _block[2 * _blockFill]     = sample[LEFTCHANNEL];
+    _block[2 * _blockFill + 1] = sample[RIGHTCHANNEL];
+    _blockFill++;
+
+    if (_blockFill == DSP_BLOCK_FRAMES) {
+        closeBlock();
+        flushBlock();
+    }
+    return true;
+}
+
+uint16_t AudioEffectBlock::ConsumeSamples(int16_t* frames, uint16_t count) {
+    if (!_next) {
+        // Ohne nächste Stufe verwerfen wie in flushBlock(), statt ins Leere zu schreiben
+        flushBlock();
+        return count;
+    }
+    // Reihenfolge wahren: einzeln gesammelte Samples gehen zuerst raus
+    closeBlock();
+
+    uint16_t done = 0;
+    while (done < count) {
+        if (!flushBlock()) break;
+
+        uint16_t n = count - done;
+        if (n > DSP_BLOCK_FRAMES) n = DSP_BLOCK_FRAMES;
+        int16_t* chunk = frames + 2 * done;
+
+        runProcess(chunk, n);
+        uint16_t sent = _next->ConsumeSamples(chunk, n);
+        if (sent < n) {
+            // Schon verarbeiteter Rest wird übernommen, sonst würde er beim erneuten Aufruf doppelt gefiltert
+            memcpy(_block, chunk + 2 * sent, (n - sent) * 2 * sizeof(int16_t));
+            _blockFill = _blockReady = n - sent;
+            _blockSent = 0;
+        }
+        done += n;
+    }
+    return done;
+}
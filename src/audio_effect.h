@@ -0,0 +1,87 @@
+#pragma once
+#include "AudioOutput.h"
+#include "dsp_profile.h"
+
+// Blockgröße der Batch-Verarbeitung. 1152 = ein MP3-Frame (MPEG-1 Layer III).
+// Mit -D DSP_BLOCK_FRAMES=1 läuft der alte Pro-Sample-Pfad (z.B. für den Zyklenvergleich).
+#ifndef DSP_BLOCK_FRAMES
+#define DSP_BLOCK_FRAMES 1152
+#endif
+
+// Abtastrate, bis der Decoder über SetRate() die tatsächliche meldet
+#define DSP_DEFAULT_RATE 44100
+
+// Abtastraten, für die Koeffizienten-Tabellen vorausberechnet werden
+#define DSP_RATE_COUNT 5
+extern const uint32_t dsp_rates[DSP_RATE_COUNT];
+// Index der Tabellenspalte, die am nächsten an 'hz' liegt
+uint8_t dsp_rate_index(uint32_t hz);
+
+// Koeffizienten-Wechsel werden über DSP_RAMP_STEPS Schritte zu je DSP_RAMP_STEP_FRAMES Frames
+// linear überblendet (ca. 23 ms bei 44,1 kHz), das vermeidet Klicks beim Drehen
+#define DSP_RAMP_STEPS 32
+#define DSP_RAMP_STEP_FRAMES 32
+
+/**
+ * @brief Basis für Effekt-Stufen in der AudioOutput-Kette (Decoder -> Effekt -> ... -> I2S).
+ * Kümmert sich um das Sammeln einzelner Samples zu Blöcken, das Weiterreichen an die
+ * nächste Stufe und den Gegendruck, wenn die Ausgabe voll ist. Abgeleitete Klassen
+ * implementieren nur process() (in-place auf einem Block) und reset().
+ * Ohne nächste Stufe (next = nullptr) lässt sich ein Effekt über ProcessInPlace() direkt benutzen.
+ */
+class AudioEffectBlock : public AudioOutput {
+public:
+    AudioEffectBlock(AudioOutput* next, const char* name);
+    virtual ~AudioEffectBlock() {}
+
+    virtual bool begin() override;
+    virtual bool SetRate(int hz) override;
+    virtual bool SetBitsPerSample(int bits) override;
+    virtual bool SetChannels(int chan) override;
+    virtual bool stop() override;
+    virtual void flush() override;
+    virtual bool loop() override;
+
+    // Fallback für Generatoren, die einzeln liefern: sammelt Samples zu einem Block
+    virtual bool ConsumeSample(int16_t* sample) override;
+    // Verarbeitet 'count' Stereo-Frames in-place und gibt sie als Block weiter
+    virtual uint16_t ConsumeSamples(int16_t* frames, uint16_t count) override;
+
+    // Verarbeitet 'count' Stereo-Frames in-place ohne Weitergabe (für Pfade außerhalb der AudioOutput-Kette)
+    void ProcessInPlace(int16_t* frames, uint16_t count) { runProcess(frames, count); }
+
+    // Reicht die Frames unverändert durch, z.B. wenn der Verstärker-DSP die Filterung übernimmt
+    void SetBypass(bool bypass) { _bypass = bypass; }
+    bool IsBypassed() const { return _bypass; }
+    // Zuletzt vom Decoder gemeldete Abtastrate (0 = noch keine)
+    int GetRate() const { return hertz; }
+    // Nächste Stufe umhängen, z.B. beim Moduswechsel; nur, während kein Audio durchläuft
+    void SetNext(AudioOutput* next) { _next = next; }
+
+protected:
+    AudioOutput* _next;
+
+    // Verarbeitet 'count' Stereo-Frames in-place
+    virtual void process(int16_t* frames, uint16_t count) = 0;
+    // Setzt den Filter-Zustand zurück (Stream-Wechsel)
+    virtual void reset() = 0;
+    // Abtastrate hat sich geändert; läuft im Audio-Pfad, darf also nicht rechnen, nur nachschlagen
+    virtual void rateChanged(int hz) { (void)hz; }
+
+private:
+    volatile bool _bypass = false;
+
+    // Sammelpuffer für ConsumeSample(); verarbeitet, aber evtl. noch nicht ganz abgenommen
+    int16_t _block[DSP_BLOCK_FRAMES * 2];
+    uint16_t _blockFill = 0;   // gesammelte Frames
+    uint16_t _blockReady = 0;  // davon verarbeitet und abgabebereit (0 = Block wird noch gesammelt)
+    uint16_t _blockSent = 0;   // davon bereits von der Ausgabe abgenommen
+
+#ifdef DSP_PROFILE
+    DspProfile _profile;
+#endif
+
+    void runProcess(int16_t* frames, uint16_t count);
+    void closeBlock();
+    bool flushBlock();
+};
@@ -1,85 +1,147 @@
 #include "bass_boost.h"
 #include <math.h>
 
-#define SAMPLE_RATE 44100.0
+static int gain_to_step(float gain_db) {
+    int step = (int)lroundf((gain_db - BASS_GAIN_MIN_DB) / BASS_GAIN_STEP_DB);
+    if (step < 0) return 0;
+    if (step >= BASS_GAIN_STEPS) return BASS_GAIN_STEPS - 1;
+    return step;
+}
 
-AudioEffectBassBoost::AudioEffectBassBoost(AudioOutput* output, float gain_db, float cutoff)
-    : _next(output), _gain(gain_db), _cutoff(cutoff) {
-    calculateCoefficients(gain_db, cutoff);
+template <class Kernel>
+AudioEffectBassBoostT<Kernel>::AudioEffectBassBoostT(AudioOutput* output, float gain_db, float cutoff)
+    : AudioEffectBlock(output, "BassBoost"), _cutoff(cutoff) {
+    int step = gain_to_step(gain_db);
+    _gain = BASS_GAIN_MIN_DB + step * BASS_GAIN_STEP_DB;
+    buildTable();
+
+    // Noch läuft kein Audio-Pfad, daher direkt übernehmen statt über die Mailbox
+    _set = _table[step];
+    _rateIndex = dsp_rate_index(DSP_DEFAULT_RATE);
+    _coeffs = _set.rate[_rateIndex];
 }
 
-AudioEffectBassBoost::~AudioEffectBassBoost() {}
+template <class Kernel>
+AudioEffectBassBoostT<Kernel>::~AudioEffectBassBoostT() {}
 
-bool AudioEffectBassBoost::begin() {
-    return _next->begin();
+template <class Kernel>
+bool AudioEffectBassBoostT<Kernel>::SetGain(float gain_db) {
+    int step = gain_to_step(gain_db);
+    _gain = BASS_GAIN_MIN_DB + step * BASS_GAIN_STEP_DB;
+    _mailbox.publish(_table[step]);
+    return true;
 }
 
-bool AudioEffectBassBoost::SetGain(float gain_db) {
-    _gain = gain_db;
-    calculateCoefficients(_gain, _cutoff);
+template <class Kernel>
+bool AudioEffectBassBoostT<Kernel>::SetCutoff(float cutoff) {
+    _cutoff = cutoff;
+    buildTable();
+    _mailbox.publish(_table[gain_to_step(_gain)]);
     return true;
 }
-void AudioEffectBassBoost::calculateCoefficients(float gain_db, float cutoff_freq) {
-    // Wandelt den Gain von dB in einen linearen Faktor A um
-    float A = pow(10, gain_db / 40.0);
-    
-    // Berechne die normalisierte Frequenz (omega) und alpha
-    float omega = 2.0 * M_PI * cutoff_freq / SAMPLE_RATE;
-    float cos_omega = cos(omega);
-    float sin_omega = sin(omega);
-    
-    // Der Parameter S für die Steilheit des Shelving-Filters. 1.0 ist ein guter Standardwert.
-    // In deiner alten Formel war dies durch sqrt((...)*(1.0/0.707 - 1)+2) fest einkodiert.
-    // Diese Formel ist etwas sauberer.
-    float alpha = sin_omega / 2.0 * sqrt( (A + 1.0/A) * (1.0/1.0 - 1.0) + 2.0 );
-
-    // --- KORREKTE KOEFFIZIENTEN-BERECHNUNG (nach R. Bristow-Johnson) ---
-
-    // Nenner-Koeffizienten (a)
-    float a0 = (A + 1) + (A - 1) * cos_omega + 2 * sqrt(A) * alpha;
-    a1 = -2 * ((A - 1) + (A + 1) * cos_omega);
-    a2 = (A + 1) + (A - 1) * cos_omega - 2 * sqrt(A) * alpha;
-
-    // Zähler-Koeffizienten (b)
-    b0 = A * ((A + 1) - (A - 1) * cos_omega + 2 * sqrt(A) * alpha);
-    b1 = 2 * A * ((A - 1) - (A + 1) * cos_omega);
-    b2 = A * ((A + 1) - (A - 1) * cos_omega - 2 * sqrt(A) * alpha);
-
-    // --- Normalisieren aller Koeffizienten durch a0 ---
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0; // a1 und a2 werden durch a0 geteilt, um die Form y[n] = ... - a1*y[n-1] ... zu erhalten
-    a2 /= a0;
-}
 
+template <class Kernel>
+void AudioEffectBassBoostT<Kernel>::calculateCoefficients(float gain_db, float cutoff_freq, float rate,
+                                                          typename Kernel::Coeffs& out) {
+    // Low-Shelf mit Steilheit S = 1 (R. Bristow-Johnson), entworfen in Float
+    BiquadCoefficients k;
+    biquad_design(k, BIQUAD_LOWSHELF, cutoff_freq, gain_db, BIQUAD_Q_BUTTERWORTH, rate);
 
-bool AudioEffectBassBoost::ConsumeSample(int16_t* sample) {
-    // 1. Lade die int16_t-Werte
-    float xL = sample[0];
-    float xR = sample[1];
+    // Erst hier entscheidet der Kern über das Zahlenformat
+    Kernel::load(out, k);
+}
 
-    // 2. Normalisieren: Skaliere den Wertebereich von int16_t auf float [-1.0, 1.0]
-    float xL_norm = xL / 32768.0f;
-    float xR_norm = xR / 32768.0f;
+// Einmalig (und bei SetCutoff) alle Gain-Schritte für alle Abtastraten vorausberechnen,
+// damit im Betrieb keine pow/cos/sin/sqrt mehr anfallen
+template <class Kernel>
+void AudioEffectBassBoostT<Kernel>::buildTable() {
+    for (int step = 0; step < BASS_GAIN_STEPS; step++) {
+        float gain_db = BASS_GAIN_MIN_DB + step * BASS_GAIN_STEP_DB;
+        for (uint8_t r = 0; r < DSP_RATE_COUNT; r++) {
+            calculateCoefficients(gain_db, _cutoff, dsp_rates[r], _table[step].rate[r]);
+        }
+    }
+}
 
-    // 3. Wende den Filter auf die normalisierten Daten an
-    float yL_norm = b0 * xL_norm + b1 * xl1 + b2 * xl2 - a1 * yl1 - a2 * yl2;
-    float yR_norm = b0 * xR_norm + b1 * xr1 + b2 * xr2 - a1 * yr1 - a2 * yr2;
+template <class Kernel>
+void AudioEffectBassBoostT<Kernel>::reset() {
+    _left = typename Kernel::State();
+    _right = typename Kernel::State();
+}
 
-    // 4. Aktualisiere die Filter-Zustände mit den *normalisierten* Werten
-    xl2 = xl1; xl1 = xL_norm; yl2 = yl1; yl1 = yL_norm;
-    xr2 = xr1; xr1 = xR_norm; yr2 = yr1; yr1 = yR_norm;
-    
-    // Optional, aber empfohlen: Clipping im Float-Bereich, um Hard-Clipping-Artefakte zu reduzieren
-    yL_norm = fmaxf(-1.0f, fminf(1.0f, yL_norm));
-    yR_norm = fmaxf(-1.0f, fminf(1.0f, yR_norm));
+template <class Kernel>
+void AudioEffectBassBoostT<Kernel>::rateChanged(int hz) {
+    uint8_t index = dsp_rate_index(hz);
+    if (index != _rateIndex) {
+        _rateIndex = index;
+        // Kein Neuberechnen, nur Spalte wechseln; die Überblendung vermeidet einen Sprung
+        startRamp(_set.rate[_rateIndex]);
+    }
+}
 
-    // 5. De-normalisieren: Skaliere zurück in den int16_t Bereich
-    int16_t outL = (int16_t)(yL_norm * 32767.0f);
-    int16_t outR = (int16_t)(yR_norm * 32767.0f);
+template <class Kernel>
+void AudioEffectBassBoostT<Kernel>::startRamp(const typename Kernel::Coeffs& target) {
+    // Lineare Interpolation zwischen zwei stabilen Filtern bleibt stabil
+    // (das Stabilitätsdreieck von a1/a2 ist konvex)
+    _target = target;
+    _delta.b0 = (target.b0 - _coeffs.b0) / DSP_RAMP_STEPS;
+    _delta.b1 = (target.b1 - _coeffs.b1) / DSP_RAMP_STEPS;
+    _delta.b2 = (target.b2 - _coeffs.b2) / DSP_RAMP_STEPS;
+    _delta.a1 = (target.a1 - _coeffs.a1) / DSP_RAMP_STEPS;
+    _delta.a2 = (target.a2 - _coeffs.a2) / DSP_RAMP_STEPS;
+    _rampSteps = DSP_RAMP_STEPS;
+}
 
-    int16_t stereoOut[2] = { outL, outR };
+template <class Kernel>
+void AudioEffectBassBoostT<Kernel>::filter(int16_t* frames, uint16_t count) {
+    // Koeffizienten und Zustände lokal halten, damit sie über den ganzen Block in Registern bleiben
+    const typename Kernel::Coeffs c = _coeffs;
+    typename Kernel::State l = _left;
+    typename Kernel::State r = _right;
+
+    for (uint16_t i = 0; i < count; i++) {
+        frames[LEFTCHANNEL]  = Kernel::toPcm(Kernel::step(c, l, Kernel::fromPcm(frames[LEFTCHANNEL])));
+        frames[RIGHTCHANNEL] = Kernel::toPcm(Kernel::step(c, r, Kernel::fromPcm(frames[RIGHTCHANNEL])));
+        frames += 2;
+    }
+
+    _left = l;
+    _right = r;
+}
+
+template <class Kernel>
+void AudioEffectBassBoostT<Kernel>::process(int16_t* frames, uint16_t count) {
+    // Neue Koeffizienten aus dem UI-Thread werden nur an Blockgrenzen übernommen
+    if (_mailbox.fetch(_set)) {
+        startRamp(_set.rate[_rateIndex]);
+    }
+
+    if (_rampSteps == 0) {
+        filter(frames, count);
+        return;
+    }
+
+    // Während einer Überblendung in Teilblöcken rechnen und die Koeffizienten dazwischen nachführen
+    while (count > 0) {
+        uint16_t n = count;
+        if (_rampSteps > 0 && n > DSP_RAMP_STEP_FRAMES) n = DSP_RAMP_STEP_FRAMES;
+        filter(frames, n);
+        frames += 2 * n;
+        count -= n;
+
+        if (_rampSteps > 0) {
+            if (--_rampSteps == 0) {
+                _coeffs = _target;
+            } else {
+                _coeffs.b0 += _delta.b0;
+                _coeffs.b1 += _delta.b1;
+                _coeffs.b2 += _delta.b2;
+                _coeffs.a1 += _delta.a1;
+                _coeffs.a2 += _delta.a2;
+            }
+        }
+    }
+}
 
-    return _next->ConsumeSample(stereoOut);
-}
\ No newline at end of file
+template class AudioEffectBassBoostT<BiquadFloat>;
+template class AudioEffectBassBoostT<BiquadQ31>;
@@ -1,25 +1,69 @@
 #pragma once
-#include "AudioOutput.h"
+#include "audio_effect.h"
+#include "biquad.h"
 
-class AudioEffectBassBoost : public AudioOutput {
+// Einstellbereich des Bass-Gains. Die Koeffizienten liegen in 0,5-dB-Schritten vorausberechnet vor.
+#define BASS_GAIN_MIN_DB  -6.0f
+#define BASS_GAIN_MAX_DB  12.0f
+#define BASS_GAIN_STEP_DB  0.5f
+#define BASS_GAIN_STEPS   37 // (MAX - MIN) / STEP + 1
+
+/**
+ * @brief Low-Shelf-Filter als Stufe zwischen Decoder und Ausgabe.
+ * @tparam Kernel Rechenkern aus biquad.h (BiquadFloat oder BiquadQ31).
+ * Beide Varianten teilen sich den Koeffizientenentwurf in calculateCoefficients().
+ *
+ * SetGain() darf aus dem UI-Thread aufgerufen werden, während der Audio-Pfad läuft: es schlägt die
+ * Koeffizienten nur in der Tabelle nach und übergibt sie lock-frei. Der Audio-Pfad blendet
+ * dann über DSP_RAMP_STEPS Schritte linear auf die neuen Koeffizienten über.
+ * Meldet der Decoder eine andere Abtastrate, wird ebenso auf die passende Tabellenspalte überblendet.
+ */
+template <class Kernel>
+class AudioEffectBassBoostT : public AudioEffectBlock {
 public:
-    AudioEffectBassBoost(AudioOutput* output, float gain = 3.0, float cutoff = 200.0);
-    virtual ~AudioEffectBassBoost();
-    
-    virtual bool begin() override;
-    virtual bool ConsumeSample(int16_t* sample) override;
+    AudioEffectBassBoostT(AudioOutput* output, float gain = 3.0, float cutoff = 200.0);
+    virtual ~AudioEffectBassBoostT();
+
+    // Wird auf BASS_GAIN_STEP_DB gerundet und auf den Einstellbereich begrenzt
     virtual bool SetGain(float gain_db);
-    
+    // Baut die Tabelle neu auf (rechenintensiv, nicht pro Encoder-Schritt gedacht)
+    virtual bool SetCutoff(float cutoff);
+    float GetGain() const { return _gain; }
+    float GetCutoff() const { return _cutoff; }
+
 protected:
-    AudioOutput* _next;
+    // Koeffizienten eines Gain-Schritts für alle Tabellen-Abtastraten
+    struct CoeffSet {
+        typename Kernel::Coeffs rate[DSP_RATE_COUNT];
+    };
+
+    // --- UI-Seite ---
     float _gain;
     float _cutoff;
-    
-    // Simple IIR Filter state
-    float xl1 = 0, xl2 = 0, yl1 = 0, yl2 = 0;
-    float xr1 = 0, xr2 = 0, yr1 = 0, yr2 = 0;
-    
-    float b0, b1, b2, a1, a2;
-
-    void calculateCoefficients(float gain_db, float cutoff_freq);
+    CoeffSet _table[BASS_GAIN_STEPS];
+    CoeffMailbox<CoeffSet> _mailbox;
+
+    // --- Audio-Seite ---
+    CoeffSet _set;
+    uint8_t _rateIndex;
+    typename Kernel::Coeffs _coeffs;  // aktuell benutzt
+    typename Kernel::Coeffs _target;  // Ziel der laufenden Überblendung
+    typename Kernel::Coeffs _delta;   // Änderung pro Überblend-Schritt
+    uint8_t _rampSteps = 0;
+    typename Kernel::State _left, _right;
+
+    void calculateCoefficients(float gain_db, float cutoff_freq, float rate, typename Kernel::Coeffs& out);
+    void buildTable();
+    void startRamp(const typename Kernel::Coeffs& target);
+    void filter(int16_t* frames, uint16_t count);
+    virtual void process(int16_t* frames, uint16_t count) override;
+    virtual void reset() override;
+    virtual void rateChanged(int hz) override;
 };
+
+// Standard ist der Festkomma-Kern; -D DSP_FLOAT wählt den Float-Kern
+#ifdef DSP_FLOAT
+typedef AudioEffectBassBoostT<BiquadFloat> AudioEffectBassBoost;
+#else
+typedef AudioEffectBassBoostT<BiquadQ31> AudioEffectBassBoost;
+#endif
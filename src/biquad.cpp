@@ -0,0 +1,59 @@
+#include "biquad.h"
+#include <math.h>
+
+void biquad_design(BiquadCoefficients& k, BiquadType type, float freq, float gain_db, float q, float rate) {
+    // Wandelt den Gain von dB in einen linearen Faktor A um
+    float A = pow(10, gain_db / 40.0);
+
+    // Berechne die normalisierte Frequenz (omega) und alpha
+    float omega = 2.0 * M_PI * freq / rate;
+    float cos_omega = cos(omega);
+    float sin_omega = sin(omega);
+    float alpha = sin_omega / (2.0 * q);
+    float sqrtA2alpha = 2 * sqrt(A) * alpha;
+
+    float a0;
+    switch (type) {
+        case BIQUAD_LOWSHELF:
+            a0   = (A + 1) + (A - 1) * cos_omega + sqrtA2alpha;
+            k.a1 = -2 * ((A - 1) + (A + 1) * cos_omega);
+            k.a2 = (A + 1) + (A - 1) * cos_omega - sqrtA2alpha;
+            k.b0 = A * ((A + 1) - (A - 1) * cos_omega + sqrtA2alpha);
+            k.b1 = 2 * A * ((A - 1) - (A + 1) * cos_omega);
+            k.b2 = A * ((A + 1) - (A - 1) * cos_omega - sqrtA2alpha);
+            break;
+        case BIQUAD_HIGHSHELF:
+            a0   = (A + 1) - (A - 1) * cos_omega + sqrtA2alpha;
+            k.a1 = 2 * ((A - 1) - (A + 1) * cos_omega);
+            k.a2 = (A + 1) - (A - 1) * cos_omega - sqrtA2alpha;
+            k.b0 = A * ((A + 1) + (A - 1) * cos_omega + sqrtA2alpha);
+            k.b1 = -2 * A * ((A - 1) + (A + 1) * cos_omega);
+            k.b2 = A * ((A + 1) + (A - 1) * cos_omega - sqrtA2alpha);
+            break;
+        case BIQUAD_PEAKING:
+            a0   = 1 + alpha / A;
+            k.a1 = -2 * cos_omega;
+            k.a2 = 1 - alpha / A;
+            k.b0 = 1 + alpha * A;
+            k.b1 = -2 * cos_omega;
+            k.b2 = 1 - alpha * A;
+            break;
+        case BIQUAD_HIGHPASS:
+        default:
+            a0   = 1 + alpha;
+            k.a1 = -2 * cos_omega;
+            k.a2 = 1 - alpha;
+            k.b0 = (1 + cos_omega) / 2;
+            k.b1 = -(1 + cos_omega);
+            k.b2 = (1 + cos_omega) / 2;
+            break;
+    }
+
+    // --- Normalisieren aller Koeffizienten durch a0 ---
+    // a1 und a2 werden durch a0 geteilt, um die Form y[n] = ... - a1*y[n-1] ... zu erhalten
+    k.b0 /= a0;
+    k.b1 /= a0;
+    k.b2 /= a0;
+    k.a1 /= a0;
+    k.a2 /= a0;
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+// Biquad-Kerne für die DSP-Effekte. Bewusst ohne Arduino-Abhängigkeiten,
+// damit sie sich auch auf dem Host (Linux) übersetzen und vergleichen lassen.
+
+/**
+ * @brief Normalisierte Biquad-Koeffizienten (a0 = 1) aus dem Filterentwurf.
+ * Gemeinsame Basis für alle Kerne: y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2
+ */
+struct BiquadCoefficients {
+    float b0, b1, b2, a1, a2;
+};
+
+enum BiquadType : uint8_t {
+    BIQUAD_LOWSHELF = 0,
+    BIQUAD_PEAKING,
+    BIQUAD_HIGHSHELF,
+    BIQUAD_HIGHPASS
+};
+
+// Güte für Shelf-Filter mit Steilheit S = 1 bzw. Butterworth-Hochpass
+#define BIQUAD_Q_BUTTERWORTH 0.7071f
+
+/**
+ * @brief Filterentwurf nach R. Bristow-Johnson (Audio EQ Cookbook).
+ * @param freq Eck- bzw. Mittenfrequenz in Hz
+ * @param gain_db Verstärkung in dB (für Hochpass ohne Bedeutung)
+ * @param q Güte; für Shelf-Filter entspricht BIQUAD_Q_BUTTERWORTH der Steilheit S = 1
+ * @param rate Abtastrate in Hz
+ */
+void biquad_design(BiquadCoefficients& k, BiquadType type, float freq, float gain_db, float q, float rate);
+
+/**
+ * @brief Float-Kern, Direct Form I. Samples werden auf [-1.0, 1.0] normalisiert.
+ */
+struct BiquadFloat {
+    typedef float sample_t;
+    typedef float coeff_t;
+
+    struct Coeffs {
+        float b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+    };
+    struct State {
+        float x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    };
+
+    static void load(Coeffs& c, const BiquadCoefficients& k) {
+        c.b0 = k.b0; c.b1 = k.b1; c.b2 = k.b2; c.a1 = k.a1; c.a2 = k.a2;
+    }
+
+    static inline sample_t fromPcm(int16_t s) {
+        // Multiplikation statt Division: die ESP32-FPU hat keine Hardware-Division
+        return s * (1.0f / 32768.0f);
+    }
+
+    static inline int16_t toPcm(sample_t y) {
+        // Sättigung im Integer-Bereich statt fmaxf/fminf im Float-Bereich
+        int32_t s = (int32_t)(y * 32767.0f);
+        if (s > 32767) return 32767;
+        if (s < -32768) return -32768;
+        return (int16_t)s;
+    }
+
+    // Skalare Variante für Kaskaden, deren Koeffizienten als Structure-of-Arrays vorliegen
+    static inline sample_t tick(coeff_t b0, coeff_t b1, coeff_t b2, coeff_t a1, coeff_t a2,
+                                State& s, sample_t x) {
+        float y = b0 * x + b1 * s.x1 + b2 * s.x2 - a1 * s.y1 - a2 * s.y2;
+        s.x2 = s.x1; s.x1 = x;
+        s.y2 = s.y1; s.y1 = y;
+        return y;
+    }
+
+    static inline sample_t step(const Coeffs& c, State& s, sample_t x) {
+        return tick(c.b0, c.b1, c.b2, c.a1, c.a2, s, x);
+    }
+};
+
+/**
+ * @brief Festkomma-Kern, Direct Form I mit Fehlerrückführung 1. Ordnung (Noise Shaping).
+ *
+ * Koeffizienten: Q1.31 mit festem Post-Shift (CMSIS-Konvention), gespeichert wird c / 2^POST_SHIFT.
+ * Damit sind Koeffizienten bis ±8 darstellbar (Shelf-/Peak-Filter bis ca. +15 dB).
+ * Samples: int16 << HEADROOM, d.h. Vollaussteuerung = 2^23, 8 Bit Reserve für Überhöhungen.
+ * Akkumulator: 64 Bit. Der beim Zurückschieben abgeschnittene Rest wird im nächsten
+ * Sample wieder addiert, so bleibt der Quantisierungsfehler bei tiefen Eckfrequenzen klein.
+ */
+struct BiquadQ31 {
+    typedef int32_t sample_t;
+    typedef int32_t coeff_t;
+
+    static const int POST_SHIFT = 3;
+    static const int HEADROOM = 8;
+    static const int ACC_SHIFT = 31 - POST_SHIFT;
+
+    struct Coeffs {
+        int32_t b0 = (int32_t)1 << ACC_SHIFT, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+    };
+    struct State {
+        int32_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+        int64_t err = 0;
+    };
+
+    static int32_t toFixed(float c) {
+        double v = (double)c * (double)((int64_t)1 << ACC_SHIFT);
+        v += (v >= 0) ? 0.5 : -0.5;
+        if (v >  2147483647.0) return INT32_MAX;
+        if (v < -2147483648.0) return INT32_MIN;
+        return (int32_t)v;
+    }
+
+    static void load(Coeffs& c, const BiquadCoefficients& k) {
+        c.b0 = toFixed(k.b0); c.b1 = toFixed(k.b1); c.b2 = toFixed(k.b2);
+        c.a1 = toFixed(k.a1); c.a2 = toFixed(k.a2);
+    }
+
+    static inline sample_t fromPcm(int16_t s) {
+        return (int32_t)s * (1 << HEADROOM);
+    }
+
+    static inline int16_t toPcm(sample_t y) {
+        int32_t s = (y + (1 << (HEADROOM - 1))) >> HEADROOM;
+        if (s > 32767) return 32767;
+        if (s < -32768) return -32768;
+        return (int16_t)s;
+    }
+
+    // Skalare Variante für Kaskaden, deren Koeffizienten als Structure-of-Arrays vorliegen
+    static inline sample_t tick(coeff_t b0, coeff_t b1, coeff_t b2, coeff_t a1, coeff_t a2,
+                                State& s, sample_t x) {
+        int64_t acc = (int64_t)b0 * x
+                    + (int64_t)b1 * s.x1
+                    + (int64_t)b2 * s.x2
+                    - (int64_t)a1 * s.y1
+                    - (int64_t)a2 * s.y2
+                    + s.err;
+        int64_t q = acc >> ACC_SHIFT;
+        s.err = acc - (q << ACC_SHIFT);
+        int32_t y = (q > INT32_MAX) ? INT32_MAX : (q < INT32_MIN) ? INT32_MIN : (int32_t)q;
+        s.x2 = s.x1; s.x1 = x;
+        s.y2 = s.y1; s.y1 = y;
+        return y;
+    }
+
+    static inline sample_t step(const Coeffs& c, State& s, sample_t x) {
+        return tick(c.b0, c.b1, c.b2, c.a1, c.a2, s, x);
+    }
+};
+
+/**
+ * @brief Lock-freie Übergabe von Koeffizienten vom UI- an den Audio-Thread (ein Schreiber, ein Leser).
+ *
+ * Seqlock über zwei Slots: publish() markiert den Zähler ungerade (Schreiben läuft), schreibt in den
+ * gerade nicht veröffentlichten Slot und macht den Zähler mit Release wieder gerade. fetch() liest den
+ * Zähler mit Acquire, kopiert den veröffentlichten Slot und liest den Zähler nach einem Acquire-Fence
+ * erneut. Ist der Zähler ungerade oder um mehr als eine Veröffentlichung weitergelaufen (der Schreiber
+ * hat den kopierten Slot schon wieder angefasst), wird nichts übernommen und beim nächsten Block
+ * erneut geholt. Eine einzelne Veröffentlichung dazwischen schreibt nur in den anderen Slot und stört nicht.
+ * Keiner der beiden Seiten blockiert oder alloziert.
+ */
+template <class T>
+class CoeffMailbox {
+public:
+    void publish(const T& value) {
+        uint32_t seq = _seq.load(std::memory_order_relaxed);
+        _seq.store(seq + 1, std::memory_order_relaxed);
+        // Ungerader Zähler muss sichtbar sein, bevor der Slot beschrieben wird
+        std::atomic_thread_fence(std::memory_order_release);
+        _slot[(seq / 2 + 1) & 1] = value;
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // true, wenn seit dem letzten Aufruf ein neuer Wert veröffentlicht wurde
+    bool fetch(T& out) {
+        uint32_t seq = _seq.load(std::memory_order_acquire);
+        if ((seq & 1) || seq == _seen) return false;  // ungerade: Schreiben läuft, nächster Block
+        T copy = _slot[(seq / 2) & 1];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_seq.load(std::memory_order_relaxed) - seq > 2) return false;
+        out = copy;
+        _seen = seq;
+        return true;
+    }
+
+private:
+    T _slot[2];
+    std::atomic<uint32_t> _seq{0};
+    uint32_t _seen = 0; // nur vom Leser benutzt
+};
@@ -0,0 +1,68 @@
+#include "boot_timeline.h"
+#include <atomic>
+
+namespace {
+struct BootMark {
+    const char* phase;
+    uint32_t us;
+};
+
+BootMark marks[BOOT_MAX_MARKS];
+std::atomic<uint8_t> reserved{0};   // vergebene Plätze
+std::atomic<uint8_t> written{0};    // fertig beschriebene Plätze
+std::atomic<bool> finished{false};
+std::atomic<bool> dumped{false};
+}
+
+void boot_mark(const char* phase) {
+    if (dumped.load(std::memory_order_acquire)) return;
+    uint32_t now = micros();
+    uint8_t slot = reserved.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= BOOT_MAX_MARKS) return;
+    marks[slot].phase = phase;
+    marks[slot].us = now;
+    written.fetch_add(1, std::memory_order_release);
+}
+
+void boot_finish(const char* phase) {
+    boot_mark(phase);
+    finished.store(true, std::memory_order_release);
+}
+
+bool boot_timeline_active() {
+    return !dumped.load(std::memory_order_acquire);
+}
+
+void boot_timeline_poll() {
+    if (dumped.load(std::memory_order_acquire)) return;
+    if (!finished.load(std::memory_order_acquire) && millis() < BOOT_TIMELINE_TIMEOUT_MS) return;
+    dumped.store(true, std::memory_order_release);
+
+    // Eine Marke, die gerade noch geschrieben wird, fehlt in der Ausgabe lieber, als halb zu erscheinen
+    uint8_t count = written.load(std::memory_order_acquire);
+    uint8_t slots = reserved.load(std::memory_order_relaxed);
+    if (count > slots) count = slots;
+    if (count > BOOT_MAX_MARKS) count = BOOT_MAX_MARKS;
+
+    // Marken aus verschiedenen Tasks können in anderer Reihenfolge eingetragen sein
+    BootMark sorted[BOOT_MAX_MARKS];
+    memcpy(sorted, marks, count * sizeof(BootMark));
+    for (uint8_t i = 1; i < count; i++) {
+        BootMark m = sorted[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1].us > m.us) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = m;
+    }
+
+    Serial.printf("[BOOT] Zeitleiste seit Reset%s:\n",
+                  finished.load(std::memory_order_acquire) ? "" : " (unvollständig)");
+    uint32_t prev = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        Serial.printf("[BOOT] %6u ms  (+%5u ms)  %s\n",
+                      sorted[i].us / 1000, (sorted[i].us - prev) / 1000, sorted[i].phase);
+        prev = sorted[i].us;
+    }
+}
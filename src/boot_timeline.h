@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+
+// Mehr Marken werden nicht aufgezeichnet (die übrigen werden still verworfen)
+#define BOOT_MAX_MARKS 16
+// Ohne Abschlussmarke (z.B. kein WLAN) wird die Zeitleiste nach dieser Zeit trotzdem ausgegeben
+#ifndef BOOT_TIMELINE_TIMEOUT_MS
+#define BOOT_TIMELINE_TIMEOUT_MS 30000
+#endif
+
+/**
+ * @brief Zeitleiste des Startvorgangs: jede Phase (NVS gelesen, I2S, Verstärker, WLAN, DNS,
+ * HTTP, erstes Sample) setzt eine Marke mit micros() seit dem Reset.
+ * Marken dürfen aus jedem Task gesetzt werden (setup(), Netzwerk- und Audio-Task); der Name muss
+ * ein String-Literal sein, gespeichert wird nur der Zeiger. Nach der Ausgabe werden weitere
+ * Marken ignoriert, es wird also nur der erste Start nach dem Reset vermessen.
+ */
+void boot_mark(const char* phase);
+
+// Setzt die letzte Marke; die Zeitleiste wird danach beim nächsten boot_timeline_poll() ausgegeben
+void boot_finish(const char* phase);
+
+// true, solange noch aufgezeichnet wird (z.B. um Messungen nur beim Start zu machen)
+bool boot_timeline_active();
+
+/**
+ * @brief Gibt die Zeitleiste einmal seriell aus, sobald sie abgeschlossen oder der Timeout
+ * erreicht ist. Regelmäßig aus loop() aufrufen; Serial wird nur hier benutzt.
+ */
+void boot_timeline_poll();
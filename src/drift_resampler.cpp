@@ -0,0 +1,85 @@
+#include "drift_resampler.h"
+
+void DriftResampler::reset() {
+    _phase = 0;
+    _need = 0;
+    for (uint8_t i = 0; i < 4; i++) _hist[i][0] = _hist[i][1] = 0;
+    setPpm(_ppm);
+}
+
+void DriftResampler::setPpm(int32_t ppm) {
+    if (ppm > A2DP_DRIFT_MAX_PPM) ppm = A2DP_DRIFT_MAX_PPM;
+    if (ppm < -A2DP_DRIFT_MAX_PPM) ppm = -A2DP_DRIFT_MAX_PPM;
+    _ppm = ppm;
+    // Schrittweite 1 + ppm/10^6 in Q32, aufgeteilt in ganzzahligen und Nachkomma-Anteil
+    int64_t step = ((int64_t)1 << 32) + ((int64_t)ppm << 32) / 1000000;
+    _stepInt = (uint32_t)(step >> 32);
+    _stepFrac = (uint32_t)step;
+}
+
+// Catmull-Rom zwischen x0 und x1; mu in Q15
+static inline int16_t cubic(int32_t xm1, int32_t x0, int32_t x1, int32_t x2, int32_t mu) {
+    // Doppelte Koeffizienten, damit keine halben Werte entstehen; die letzte Stufe teilt durch 2
+    int32_t c0 = -xm1 + 3 * x0 - 3 * x1 + x2;
+    int32_t c1 = 2 * xm1 - 5 * x0 + 4 * x1 - x2;
+    int32_t c2 = x1 - xm1;
+    int32_t t = (int32_t)(((int64_t)c0 * mu) >> 15) + c1;
+    t = (int32_t)(((int64_t)t * mu) >> 15) + c2;
+    int32_t y = x0 + (int32_t)(((int64_t)t * mu) >> 16);
+    if (y > 32767) y = 32767;
+    if (y < -32768) y = -32768;
+    return (int16_t)y;
+}
+
+uint16_t DriftResampler::process(const int16_t* in, uint16_t in_frames, uint16_t& consumed,
+                                 int16_t* out, uint16_t out_max) {
+    consumed = 0;
+    uint16_t produced = 0;
+    while (produced < out_max) {
+        // Stützstellen nachschieben, bis die Phase zwischen _hist[1] und _hist[2] liegt
+        while (_need > 0) {
+            if (consumed == in_frames) return produced;
+            _hist[0][0] = _hist[1][0]; _hist[0][1] = _hist[1][1];
+            _hist[1][0] = _hist[2][0]; _hist[1][1] = _hist[2][1];
+            _hist[2][0] = _hist[3][0]; _hist[2][1] = _hist[3][1];
+            _hist[3][0] = in[2 * consumed];
+            _hist[3][1] = in[2 * consumed + 1];
+            consumed++;
+            _need--;
+        }
+
+        int32_t mu = (int32_t)(_phase >> 17);
+        for (uint8_t ch = 0; ch < 2; ch++) {
+            out[2 * produced + ch] = cubic(_hist[0][ch], _hist[1][ch], _hist[2][ch], _hist[3][ch], mu);
+        }
+        produced++;
+
+        uint32_t phase = _phase + _stepFrac;
+        _need = _stepInt + (phase < _phase ? 1 : 0);
+        _phase = phase;
+    }
+    return produced;
+}
+
+int32_t DriftController::update(uint32_t fill_frames, uint32_t target_frames) {
+    if (target_frames == 0) return 0;
+    // Glättung mit Faktor 1/64 (Zeitkonstante rund 64 Ausgabeblöcke)
+    int32_t fill16 = (int32_t)fill_frames * 16;
+    if (_smoothed < 0) _smoothed = fill16;
+    _smoothed += (fill16 - _smoothed) / 64;
+
+    // Abweichung von der Mitte in ppm des Ziels: 10 % zu voll -> +100000
+    int64_t error = ((int64_t)_smoothed - (int64_t)target_frames * 16) * 1000000 / ((int64_t)target_frames * 16);
+
+    // I-Anteil: pro Block 1/4096 der Abweichung (Q16), auf den Stellbereich begrenzt
+    _integral += (error << 16) / 4096 / 1000;
+    const int64_t limit = (int64_t)A2DP_DRIFT_MAX_PPM << 16;
+    if (_integral > limit) _integral = limit;
+    if (_integral < -limit) _integral = -limit;
+
+    // P-Anteil: 10 % Abweichung -> 200 ppm
+    int64_t ppm = error / 500 + (_integral >> 16);
+    if (ppm > A2DP_DRIFT_MAX_PPM) ppm = A2DP_DRIFT_MAX_PPM;
+    if (ppm < -A2DP_DRIFT_MAX_PPM) ppm = -A2DP_DRIFT_MAX_PPM;
+    return (int32_t)ppm;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+
+// Ausgleich der Taktdrift zwischen Telefon (A2DP) und eigenem I2S-Takt. Ohne Arduino-Abhängigkeiten,
+// damit sich Resampler und Regler auf dem Host mit simulierter Drift durchspielen lassen.
+
+// Größte Korrektur in ppm; Quarze liegen typisch innerhalb ±100 ppm, ±1000 ppm sind 1,7 Cent
+#ifndef A2DP_DRIFT_MAX_PPM
+#define A2DP_DRIFT_MAX_PPM 1000
+#endif
+
+/**
+ * @brief Fraktionaler Resampler für Stereo-int16 mit kubischer Interpolation (Catmull-Rom), Festkomma.
+ * Die Phase läuft in Q32, damit auch Verhältnisse von wenigen ppm exakt umgesetzt werden.
+ * Verarbeitet einen Datenstrom in beliebig großen Stücken; drei Frames bleiben als Stützstellen
+ * zwischen den Aufrufen stehen.
+ */
+class DriftResampler {
+public:
+    void reset();
+    // > 0: Eingang schneller verbrauchen (Puffer läuft voll), < 0: langsamer
+    void setPpm(int32_t ppm);
+    int32_t ppm() const { return _ppm; }
+
+    /**
+     * @brief Erzeugt höchstens out_max Frames aus höchstens in_frames Frames.
+     * @param consumed Anzahl der verbrauchten Eingangs-Frames
+     * @return Anzahl der erzeugten Frames; weniger als out_max, wenn der Eingang aufgebraucht ist
+     */
+    uint16_t process(const int16_t* in, uint16_t in_frames, uint16_t& consumed,
+                     int16_t* out, uint16_t out_max);
+
+private:
+    int32_t _ppm = 0;
+    uint32_t _stepFrac = 0;    // Nachkommaanteil der Schrittweite (Q32)
+    uint32_t _stepInt = 1;     // ganzzahliger Anteil (0 bei negativer Korrektur, sonst 1)
+    uint32_t _phase = 0;       // Position zwischen _hist[1] und _hist[2] (Q32)
+    uint32_t _need = 0;        // so viele Eingangs-Frames müssen vor dem nächsten Ausgangs-Frame nachrücken
+    int16_t _hist[4][2] = {};  // x[-1], x[0], x[1], x[2] je Kanal
+};
+
+/**
+ * @brief PI-Regler: hält den Füllstand des Puffers mittig, indem er die Resampling-Korrektur nachführt.
+ * Der Füllstand wird geglättet, damit Paket-Bursts die Tonhöhe nicht schwanken lassen; der
+ * I-Anteil findet die tatsächliche Drift, der P-Anteil zieht den Füllstand zur Mitte zurück.
+ */
+class DriftController {
+public:
+    void reset() { _smoothed = -1; _integral = 0; }
+    // Einmal pro Ausgabeblock mit dem aktuellen Füllstand; liefert die Korrektur in ppm
+    int32_t update(uint32_t fill_frames, uint32_t target_frames);
+    int32_t integralPpm() const { return (int32_t)(_integral >> 16); }
+
+private:
+    int32_t _smoothed = -1;  // geglätteter Füllstand in Frames * 16
+    int64_t _integral = 0;   // ppm in Q16
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @brief Zyklenzähler für die DSP-Pfade.
+ * Nur aktiv, wenn mit -D DSP_PROFILE gebaut wird; sonst kosten die Makros nichts.
+ * Gibt alle 'report' Einheiten (Standard: DSP_PROFILE_REPORT_FRAMES Frames) die mittleren
+ * Zyklen pro Einheit seriell aus.
+ */
+#ifndef DSP_PROFILE_REPORT_FRAMES
+#define DSP_PROFILE_REPORT_FRAMES 441000 // ca. 10 s bei 44,1 kHz
+#endif
+
+struct DspProfile {
+    const char* name;
+    const char* unit;
+    uint32_t report;
+    uint64_t cycles = 0;
+    uint32_t units = 0;
+
+    explicit DspProfile(const char* n, const char* u = "Frame", uint32_t r = DSP_PROFILE_REPORT_FRAMES)
+        : name(n), unit(u), report(r) {}
+
+    void add(uint32_t c, uint32_t n) {
+        cycles += c;
+        units += n;
+        if (units >= report) {
+            Serial.printf("[DSP] %s: %.1f Zyklen/%s (%u)\n",
+                          name, (double)cycles / units, unit, units);
+            cycles = 0;
+            units = 0;
+        }
+    }
+};
+
+#ifdef DSP_PROFILE
+#define DSP_PROFILE_BEGIN() uint32_t _dsp_profile_start = ESP.getCycleCount()
+#define DSP_PROFILE_END(profile, n) (profile).add(ESP.getCycleCount() - _dsp_profile_start, (n))
+#else
+#define DSP_PROFILE_BEGIN()
+#define DSP_PROFILE_END(profile, n)
+#endif
@@ -10,8 +10,8 @@
 void init_encoder();
 
 /**
- * @brief Prüft den Encoder auf Änderungen und passt die Lautstärke an.
- * Muss regelmäßig in der loop()-Funktion aufgerufen werden.
+ * @brief Liefert die Rasten seit dem letzten Aufruf (Zählung im PCNT).
+ * Wird von der Timer-Abtastung in input.cpp aufgerufen.
  */
 int handle_encoder();
 
@@ -0,0 +1,182 @@
+#include "equalizer.h"
+#include "settings.h"
+
+
+// Grenzen, in denen der Q31-Kern (Koeffizienten bis ±8) sicher bleibt
+#define EQ_GAIN_DB_LIMIT 15.0f
+#define EQ_FREQ_MIN 20
+#define EQ_FREQ_MAX 20000
+
+// Voreinstellung: klassische 5-Band-Aufteilung, alle Bänder aus
+static const EQBand default_bands[] = {
+    { BIQUAD_LOWSHELF,  0,   100, 0.0f, BIQUAD_Q_BUTTERWORTH },
+    { BIQUAD_PEAKING,   0,   400, 0.0f, 1.0f },
+    { BIQUAD_PEAKING,   0,  1500, 0.0f, 1.0f },
+    { BIQUAD_PEAKING,   0,  5000, 0.0f, 1.0f },
+    { BIQUAD_HIGHSHELF, 0, 10000, 0.0f, BIQUAD_Q_BUTTERWORTH },
+};
+
+template <class Kernel>
+AudioEffectEQT<Kernel>::AudioEffectEQT(AudioOutput* output)
+    : AudioEffectBlock(output, "EQ"), _rateIndex(dsp_rate_index(DSP_DEFAULT_RATE)) {
+    for (uint8_t i = 0; i < EQ_MAX_BANDS; i++) {
+        _bands[i] = default_bands[i % (sizeof(default_bands) / sizeof(default_bands[0]))];
+    }
+    rebuild();
+}
+
+template <class Kernel>
+bool AudioEffectEQT<Kernel>::SetBand(uint8_t index, const EQBand& band) {
+    if (index >= EQ_MAX_BANDS) return false;
+    if (band.type > BIQUAD_HIGHPASS) return false;
+    if (band.freq < EQ_FREQ_MIN || band.freq > EQ_FREQ_MAX) return false;
+    if (!(band.q > 0.0f)) return false;
+    if (band.gain_db > EQ_GAIN_DB_LIMIT || band.gain_db < -EQ_GAIN_DB_LIMIT) return false;
+
+    _bands[index] = band;
+    rebuild();
+    return true;
+}
+
+template <class Kernel>
+void AudioEffectEQT<Kernel>::LoadSettings() {
+    EQBand stored[EQ_MAX_BANDS];
+    if (settings_eq_bands(stored)) {
+        for (uint8_t i = 0; i < EQ_MAX_BANDS; i++) {
+            if (!SetBand(i, stored[i])) {
+                Serial.printf("EQ-Band %d in den Einstellungen ungültig, nutze Voreinstellung.\n", i);
+            }
+        }
+    }
+}
+
+template <class Kernel>
+void AudioEffectEQT<Kernel>::SaveSettings() {
+    settings_set_eq_bands(_bands);
+}
+
+template <class Kernel>
+void AudioEffectEQT<Kernel>::rebuild() {
+    CascadeSet set;
+    for (uint8_t r = 0; r < DSP_RATE_COUNT; r++) {
+        Cascade& c = set.rate[r];
+        for (uint8_t i = 0; i < EQ_MAX_BANDS; i++) {
+            const EQBand& band = _bands[i];
+            if (!band.enabled) continue;
+            // Bänder oberhalb der halben Abtastrate gibt es bei dieser Rate nicht
+            if (band.freq >= dsp_rates[r] / 2) continue;
+
+            BiquadCoefficients k;
+            biquad_design(k, (BiquadType)band.type, band.freq, band.gain_db, band.q, dsp_rates[r]);
+            typename Kernel::Coeffs kc;
+            Kernel::load(kc, k);
+
+            uint8_t n = c.active++;
+            c.mask |= 1 << i;
+            c.b0[n] = kc.b0; c.b1[n] = kc.b1; c.b2[n] = kc.b2;
+            c.a1[n] = kc.a1; c.a2[n] = kc.a2;
+        }
+    }
+    _mailbox.publish(set);
+}
+
+template <class Kernel>
+void AudioEffectEQT<Kernel>::reset() {
+    for (uint8_t i = 0; i < EQ_MAX_BANDS; i++) {
+        _left[i] = typename Kernel::State();
+        _right[i] = typename Kernel::State();
+    }
+}
+
+template <class Kernel>
+void AudioEffectEQT<Kernel>::rateChanged(int hz) {
+    uint8_t index = dsp_rate_index(hz);
+    if (index != _rateIndex) {
+        _rateIndex = index;
+        retarget();
+    }
+}
+
+// Überblendet auf die Kaskade der aktuellen Rate bzw. übernimmt sie hart, wenn sich die Belegung ändert
+template <class Kernel>
+void AudioEffectEQT<Kernel>::retarget() {
+    const Cascade& t = _set.rate[_rateIndex];
+    if (t.mask != _coeffs.mask) {
+        // Band-Belegung hat sich verschoben, alte Zustände passen nicht mehr
+        _coeffs = t;
+        _rampSteps = 0;
+        reset();
+        return;
+    }
+    if (t.active == 0) return;
+
+    // Lineare Interpolation zwischen zwei stabilen Filtern bleibt stabil (siehe bass_boost.cpp)
+    _target = t;
+    for (uint8_t b = 0; b < t.active; b++) {
+        _delta.b0[b] = (t.b0[b] - _coeffs.b0[b]) / DSP_RAMP_STEPS;
+        _delta.b1[b] = (t.b1[b] - _coeffs.b1[b]) / DSP_RAMP_STEPS;
+        _delta.b2[b] = (t.b2[b] - _coeffs.b2[b]) / DSP_RAMP_STEPS;
+        _delta.a1[b] = (t.a1[b] - _coeffs.a1[b]) / DSP_RAMP_STEPS;
+        _delta.a2[b] = (t.a2[b] - _coeffs.a2[b]) / DSP_RAMP_STEPS;
+    }
+    _rampSteps = DSP_RAMP_STEPS;
+}
+
+template <class Kernel>
+void AudioEffectEQT<Kernel>::filter(int16_t* frames, uint16_t count) {
+    const Cascade& c = _coeffs;
+    const uint8_t n = c.active;
+    if (n == 0) return;
+
+    for (uint16_t i = 0; i < count; i++) {
+        // Zwischen den Bändern bleibt das Signal im internen Format des Kerns
+        typename Kernel::sample_t l = Kernel::fromPcm(frames[LEFTCHANNEL]);
+        typename Kernel::sample_t r = Kernel::fromPcm(frames[RIGHTCHANNEL]);
+        for (uint8_t b = 0; b < n; b++) {
+            l = Kernel::tick(c.b0[b], c.b1[b], c.b2[b], c.a1[b], c.a2[b], _left[b], l);
+            r = Kernel::tick(c.b0[b], c.b1[b], c.b2[b], c.a1[b], c.a2[b], _right[b], r);
+        }
+        frames[LEFTCHANNEL]  = Kernel::toPcm(l);
+        frames[RIGHTCHANNEL] = Kernel::toPcm(r);
+        frames += 2;
+    }
+}
+
+template <class Kernel>
+void AudioEffectEQT<Kernel>::process(int16_t* frames, uint16_t count) {
+    // Neue Kaskade aus dem UI-Thread nur an Blockgrenzen übernehmen
+    if (_mailbox.fetch(_set)) {
+        retarget();
+    }
+
+    if (_rampSteps == 0) {
+        filter(frames, count);
+        return;
+    }
+
+    // Während einer Überblendung in Teilblöcken rechnen und die Koeffizienten dazwischen nachführen
+    while (count > 0) {
+        uint16_t n = count;
+        if (_rampSteps > 0 && n > DSP_RAMP_STEP_FRAMES) n = DSP_RAMP_STEP_FRAMES;
+        filter(frames, n);
+        frames += 2 * n;
+        count -= n;
+
+        if (_rampSteps > 0) {
+            if (--_rampSteps == 0) {
+                _coeffs = _target;
+            } else {
+                for (uint8_t b = 0; b < _coeffs.active; b++) {
+                    _coeffs.b0[b] += _delta.b0[b];
+                    _coeffs.b1[b] += _delta.b1[b];
+                    _coeffs.b2[b] += _delta.b2[b];
+                    _coeffs.a1[b] += _delta.a1[b];
+                    _coeffs.a2[b] += _delta.a2[b];
+                }
+            }
+        }
+    }
+}
+
+template class AudioEffectEQT<BiquadFloat>;
+template class AudioEffectEQT<BiquadQ31>;
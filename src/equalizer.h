@@ -0,0 +1,90 @@
+#pragma once
+#include "audio_effect.h"
+#include "biquad.h"
+
+#ifndef EQ_MAX_BANDS
+#define EQ_MAX_BANDS 5
+#endif
+
+/**
+ * @brief Einstellungen eines EQ-Bands. Wird so als Blob in den Preferences abgelegt.
+ */
+struct EQBand {
+    uint8_t type;      // BiquadType
+    uint8_t enabled;
+    uint16_t freq;     // Eck- bzw. Mittenfrequenz in Hz
+    float gain_db;     // für Hochpass ohne Bedeutung
+    float q;
+};
+
+/**
+ * @brief Parametrischer EQ: Kaskade aus bis zu EQ_MAX_BANDS Biquads als Stufe der AudioOutput-Kette.
+ * @tparam Kernel Rechenkern aus biquad.h (BiquadFloat oder BiquadQ31).
+ *
+ * Ändern sich nur Gain, Frequenz oder Güte aktiver Bänder (oder die Abtastrate), blendet der
+ * Audio-Pfad wie beim Bass über DSP_RAMP_STEPS Schritte linear auf die neuen Koeffizienten über.
+ * Wird ein Band ein- oder ausgeschaltet, verschiebt sich die Belegung der Kaskade; dann werden die
+ * neuen Koeffizienten sofort übernommen und die Zustände zurückgesetzt. Das passiert nur über das
+ * Menü, nicht beim Drehen, und ein Überblenden hieße, beide Kaskaden parallel zu rechnen.
+ */
+template <class Kernel>
+class AudioEffectEQT : public AudioEffectBlock {
+public:
+    AudioEffectEQT(AudioOutput* output);
+    virtual ~AudioEffectEQT() {}
+
+    /**
+     * @brief Setzt ein Band und berechnet die Kaskade neu.
+     * Darf während der Wiedergabe aus dem UI-Thread gerufen werden; die neue Kaskade wird
+     * lock-frei übergeben und vom Audio-Pfad an der nächsten Blockgrenze übernommen.
+     * @return false bei ungültigem Index oder ungültigen Parametern.
+     */
+    bool SetBand(uint8_t index, const EQBand& band);
+    const EQBand& GetBand(uint8_t index) const { return _bands[index]; }
+
+    // Lädt/speichert alle Bänder über den Einstellungsspeicher (settings.h, Schlüssel "eq_bands")
+    void LoadSettings();
+    void SaveSettings();
+
+protected:
+    // Aktive Bänder liegen lückenlos vorne. Koeffizienten als Structure-of-Arrays,
+    // damit die Band-Schleife pro Sample linear durch den Speicher läuft.
+    struct Cascade {
+        uint8_t active = 0;
+        uint8_t mask = 0;  // Bit i: Band i ist aktiv
+        typename Kernel::coeff_t b0[EQ_MAX_BANDS], b1[EQ_MAX_BANDS], b2[EQ_MAX_BANDS];
+        typename Kernel::coeff_t a1[EQ_MAX_BANDS], a2[EQ_MAX_BANDS];
+    };
+
+    // Kaskade für alle Tabellen-Abtastraten, damit ein Ratenwechsel nur nachschlägt
+    struct CascadeSet {
+        Cascade rate[DSP_RATE_COUNT];
+    };
+
+    // --- UI-Seite ---
+    EQBand _bands[EQ_MAX_BANDS];
+    CoeffMailbox<CascadeSet> _mailbox;
+
+    // --- Audio-Seite ---
+    CascadeSet _set;
+    uint8_t _rateIndex;
+    Cascade _coeffs;  // aktuell benutzt
+    Cascade _target;  // Ziel der laufenden Überblendung
+    Cascade _delta;   // Änderung pro Überblend-Schritt
+    uint8_t _rampSteps = 0;
+    typename Kernel::State _left[EQ_MAX_BANDS], _right[EQ_MAX_BANDS];
+
+    void rebuild();
+    void retarget();
+    void filter(int16_t* frames, uint16_t count);
+    virtual void process(int16_t* frames, uint16_t count) override;
+    virtual void reset() override;
+    virtual void rateChanged(int hz) override;
+};
+
+// Standard ist der Festkomma-Kern; -D DSP_FLOAT wählt den Float-Kern
+#ifdef DSP_FLOAT
+typedef AudioEffectEQT<BiquadFloat> AudioEffectEQ;
+#else
+typedef AudioEffectEQT<BiquadQ31> AudioEffectEQ;
+#endif
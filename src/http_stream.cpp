@@ -0,0 +1,291 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "http_stream.h"
+#include "stream_format.h"
+
+// Kopiert höchstens len-1 Zeichen; false, wenn abgeschnitten werden musste
+static bool copy_str(char* dst, const char* src, size_t len) {
+    size_t n = strlen(src);
+    if (n >= len) {
+        if (len > 0) dst[0] = '\0';
+        return false;
+    }
+    memcpy(dst, src, n + 1);
+    return true;
+}
+
+// Führende Ziffern als Zahl ("128,128" -> 128); höchstens 9 Stellen, damit nichts überläuft
+static uint32_t parse_uint(const char* s) {
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < 9 && *s >= '0' && *s <= '9'; i++, s++) v = v * 10 + (uint32_t)(*s - '0');
+    return v;
+}
+
+static bool starts_with(const char* s, const char* prefix) {
+    return strncmp(s, prefix, strlen(prefix)) == 0;
+}
+
+bool HttpStream::splitUrl(const char* url, char* host, size_t host_len, uint16_t& port, const char*& path) {
+    if (!starts_with(url, "http://")) return false;
+    const char* auth = url + 7;
+    const char* slash = strchr(auth, '/');
+    size_t auth_len = slash ? (size_t)(slash - auth) : strlen(auth);
+    path = slash ? slash : "/";
+
+    const char* colon = (const char*)memchr(auth, ':', auth_len);
+    size_t name_len = colon ? (size_t)(colon - auth) : auth_len;
+    if (name_len == 0 || name_len >= host_len) return false;
+    memcpy(host, auth, name_len);
+    host[name_len] = '\0';
+
+    port = 80;
+    if (colon) {
+        const char* digits = colon + 1;
+        size_t n = auth_len - name_len - 1;
+        if (n == 0 || n > 5) return false;
+        uint32_t p = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (digits[i] < '0' || digits[i] > '9') return false;
+            p = p * 10 + (uint32_t)(digits[i] - '0');
+        }
+        if (p == 0 || p > 65535) return false;
+        port = (uint16_t)p;
+    }
+    return true;
+}
+
+bool HttpStream::resolveLocation(const char* current, const char* location, char* out, size_t len) {
+    if (starts_with(location, "http://")) return copy_str(out, location, len);
+    // Anderes Schema (https://, ...) kann der Stream nicht öffnen
+    if (strstr(location, "://")) return false;
+    if (!starts_with(current, "http://")) return false;
+
+    size_t base;
+    const char* path = strchr(current + 7, '/');
+    if (starts_with(location, "//")) {
+        base = 5;  // "http:" + "//host/..."
+    } else if (location[0] == '/') {
+        // Relativ zum Host: Schema und Host der aktuellen URL übernehmen
+        base = path ? (size_t)(path - current) : strlen(current);
+    } else {
+        // Relativ zum Verzeichnis der aktuellen URL
+        const char* query = path ? strchr(path, '?') : nullptr;
+        const char* dir_end = path;
+        for (const char* p = path; p && *p && p != query; p++) {
+            if (*p == '/') dir_end = p;
+        }
+        base = dir_end ? (size_t)(dir_end - current) + 1 : strlen(current);
+        if (!dir_end) {
+            // "http://host" ohne Pfad: "/" ergänzen
+            if (base + 1 + strlen(location) >= len) return false;
+            memcpy(out, current, base);
+            out[base] = '/';
+            memcpy(out + base + 1, location, strlen(location) + 1);
+            return true;
+        }
+    }
+    size_t rest = strlen(location);
+    if (base + rest >= len) return false;
+    memcpy(out, current, base);
+    memcpy(out + base, location, rest + 1);
+    return true;
+}
+
+// "ice-audio-info: ice-samplerate=44100;ice-bitrate=128;ice-channels=2"
+void HttpStream::parseAudioInfo(const char* value, StationInfo& info) {
+    const char* item = value;
+    while (*item) {
+        const char* end = strchr(item, ';');
+        if (!end) end = item + strlen(item);
+        const char* eq = (const char*)memchr(item, '=', (size_t)(end - item));
+        if (eq && eq > item) {
+            size_t name_len = (size_t)(eq - item);
+            uint32_t v = parse_uint(eq + 1);
+            if (name_len >= 10 && strncmp(eq - 10, "samplerate", 10) == 0 && info.sample_rate == 0) {
+                info.sample_rate = v;
+            }
+            if (name_len >= 7 && strncmp(eq - 7, "bitrate", 7) == 0 && info.bitrate_kbps == 0) {
+                info.bitrate_kbps = (uint16_t)v;
+            }
+        }
+        item = *end ? end + 1 : end;
+    }
+}
+
+bool HttpStream::open(const char* url, StationInfo& info) {
+    close();
+    // Zuerst kopieren: 'url' darf auf info.url zeigen
+    char current[STATION_URL_MAX];
+    char next[STATION_URL_MAX];
+    bool fits = copy_str(current, url, sizeof(current));
+    memset(&info, 0, sizeof(info));
+    if (!fits) return false;
+
+    for (uint8_t hop = 0; hop <= STATION_MAX_REDIRECTS; hop++) {
+        switch (request(current, info, next)) {
+        case HS_STREAM:
+            copy_str(info.url, current, sizeof(info.url));
+            return true;
+        case HS_REDIRECT:
+            memcpy(current, next, sizeof(current));
+            break;
+        default:
+            close();
+            return false;
+        }
+    }
+    return false;
+}
+
+HttpStream::Result HttpStream::request(const char* url, StationInfo& info, char* next) {
+    char host[64];
+    uint16_t port;
+    const char* path;
+    _net.close();
+    _open = false;
+    _bufPos = _bufLen = 0;
+    if (!splitUrl(url, host, sizeof(host), port, path)) return HS_FAIL;
+
+    uint32_t deadline = _net.millis() + HTTP_STREAM_HEADER_TIMEOUT_MS;
+    if (!_net.connect(host, port, HTTP_STREAM_HEADER_TIMEOUT_MS)) return HS_FAIL;
+    _requests++;
+
+    // HTTP/1.0 ohne "Icy-MetaData": der Server schickt den reinen Stream, ohne Chunked-Encoding
+    char line[HTTP_STREAM_LINE_MAX];
+    int n = port == 80
+        ? snprintf(line, sizeof(line), "GET %s HTTP/1.0\r\nHost: %s\r\n", path, host)
+        : snprintf(line, sizeof(line), "GET %s HTTP/1.0\r\nHost: %s:%u\r\n", path, host, port);
+    if (n < 0 || (size_t)n >= sizeof(line)) return HS_FAIL;
+    static const char tail[] = "User-Agent: ESP32-Radio\r\nAccept: */*\r\nConnection: close\r\n\r\n";
+    if (!_net.send(line, (size_t)n) || !_net.send(tail, sizeof(tail) - 1)) return HS_FAIL;
+
+    // Statuszeile: "HTTP/1.x 200 OK" oder bei Shoutcast 1 "ICY 200 OK"
+    if (!readLine(line, sizeof(line), deadline)) return HS_FAIL;
+    if (!starts_with(line, "HTTP/1.") && !starts_with(line, "ICY ")) return HS_FAIL;
+    const char* sp = strchr(line, ' ');
+    uint32_t code = sp ? parse_uint(sp + 1) : 0;
+
+    memset(&info, 0, sizeof(info));
+    bool location = false;
+    for (;;) {
+        if (!readLine(line, sizeof(line), deadline)) return HS_FAIL;
+        if (line[0] == '\0') break;
+        char* colon = strchr(line, ':');
+        if (!colon) continue;
+        *colon = '\0';
+        const char* value = colon + 1;
+        while (*value == ' ' || *value == '\t') value++;
+
+        if (strcasecmp(line, "Location") == 0) {
+            location = resolveLocation(url, value, next, STATION_URL_MAX);
+        } else if (strcasecmp(line, "Content-Type") == 0) {
+            snprintf(info.content_type, sizeof(info.content_type), "%s", value);
+        } else if (strcasecmp(line, "icy-br") == 0) {
+            info.bitrate_kbps = (uint16_t)parse_uint(value);
+        } else if (strcasecmp(line, "icy-sr") == 0) {
+            info.sample_rate = parse_uint(value);
+        } else if (strcasecmp(line, "ice-audio-info") == 0) {
+            parseAudioInfo(value, info);
+        }
+    }
+
+    if (code >= 300 && code < 400) {
+        _net.close();
+        return location ? HS_REDIRECT : HS_FAIL;
+    }
+    if (code != 200) {
+        _net.close();
+        return HS_FAIL;
+    }
+
+    // Playlist (M3U/PLS) statt Stream: dem ersten Eintrag folgen, zählt wie eine Weiterleitung
+    if (playlist_format(url, info.content_type) != PLAYLIST_NONE) {
+        bool ok = readPlaylist(next);
+        _net.close();
+        return ok ? HS_REDIRECT : HS_FAIL;
+    }
+
+    // Am Ziel: die Verbindung bleibt offen, read() liefert ab hier den Stream
+    _open = true;
+    return HS_STREAM;
+}
+
+bool HttpStream::readLine(char* line, size_t max, uint32_t deadline) {
+    size_t len = 0;
+    for (;;) {
+        if (_bufPos == _bufLen) {
+            int32_t got = _net.receive(_buf, sizeof(_buf));
+            if (got < 0) return false;
+            if (got == 0) {
+                if ((int32_t)(_net.millis() - deadline) >= 0) return false;
+                _net.idle();
+                continue;
+            }
+            _bufPos = 0;
+            _bufLen = (size_t)got;
+        }
+        char c = (char)_buf[_bufPos++];
+        if (c == '\n') break;
+        // Zu lange Zeilen abschneiden, der Rest wird überlesen
+        if (c != '\r' && len + 1 < max) line[len++] = c;
+    }
+    line[len] = '\0';
+    return true;
+}
+
+// Liest die Playlist-Antwort (begrenzt) und liefert die erste http://-URL daraus
+bool HttpStream::readPlaylist(char* next) {
+    struct Work {
+        char body[HTTP_STREAM_PLAYLIST_MAX];
+        PlaylistEntry entry;
+    };
+    // Nicht auf den Stack: der Netzwerk-Task hat nur wenige KB
+    Work* w = (Work*)malloc(sizeof(Work));
+    if (!w) return false;
+
+    // Was mit dem Header schon ankam, zuerst
+    size_t len = _bufLen - _bufPos;
+    if (len > sizeof(w->body)) len = sizeof(w->body);
+    memcpy(w->body, _buf + _bufPos, len);
+    _bufPos = _bufLen = 0;
+
+    uint32_t start = _net.millis();
+    while (len < sizeof(w->body) && _net.millis() - start < HTTP_STREAM_PLAYLIST_TIMEOUT_MS) {
+        int32_t got = _net.receive((uint8_t*)w->body + len, sizeof(w->body) - len);
+        if (got < 0) break;
+        if (got == 0) _net.idle();
+        len += (size_t)got;
+    }
+
+    bool found = false;
+    PlaylistReader reader(w->body, len);
+    while (!found && reader.next(w->entry)) {
+        found = starts_with(w->entry.url, "http://");
+    }
+    if (found) found = copy_str(next, w->entry.url, STATION_URL_MAX);
+    free(w);
+    return found;
+}
+
+int32_t HttpStream::read(uint8_t* dst, size_t len) {
+    if (!_open) return -1;
+    if (_bufPos < _bufLen) {
+        size_t n = _bufLen - _bufPos;
+        if (n > len) n = len;
+        memcpy(dst, _buf + _bufPos, n);
+        _bufPos += n;
+        return (int32_t)n;
+    }
+    int32_t got = _net.receive(dst, len);
+    if (got < 0) close();
+    return got;
+}
+
+void HttpStream::close() {
+    _net.close();
+    _open = false;
+    _bufPos = _bufLen = 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// HTTP/ICY-Abruf eines Radio-Streams: Weiterleitungen und Playlists bis zum eigentlichen Stream
+// verfolgen, dabei die Stream-Header lesen und aus derselben Antwort weiterlesen. Ohne
+// Arduino-Abhängigkeiten: Netz und Zeit kommen über StreamTransport, auf dem Host lässt sich
+// dafür ein Socket gegen einen lokalen Test-Server einsetzen.
+
+#define STATION_URL_MAX 256
+// Höchstens so viele Weiterleitungen (auch über Playlists) werden verfolgt
+#define STATION_MAX_REDIRECTS 5
+
+// Zeit für Verbindungsaufbau plus Statuszeile und Header einer Antwort
+#ifndef HTTP_STREAM_HEADER_TIMEOUT_MS
+#define HTTP_STREAM_HEADER_TIMEOUT_MS 5000
+#endif
+// Größte Playlist, die gelesen wird (Sender-Playlists haben meist nur wenige Zeilen)
+#define HTTP_STREAM_PLAYLIST_MAX 4096
+#define HTTP_STREAM_PLAYLIST_TIMEOUT_MS 2000
+// Längere Header-Zeilen werden abgeschnitten
+#define HTTP_STREAM_LINE_MAX 384
+// Puffer für Header; was nach dem Header schon mitkam, liefert read() zuerst
+#define HTTP_STREAM_BUFFER 512
+
+/**
+ * @brief Was beim letzten Verbindungsaufbau über einen Sender gelernt wurde.
+ * Liegt pro Sender im NVS (siehe station_cache.h).
+ */
+struct StationInfo {
+    char url[STATION_URL_MAX];   // Ziel nach allen Weiterleitungen
+    char content_type[32];       // z.B. "audio/mpeg"
+    uint16_t bitrate_kbps;       // 0 = unbekannt
+    uint32_t sample_rate;        // 0 = unbekannt
+};
+
+/**
+ * @brief Eine TCP-Verbindung samt Uhr. Auf dem ESP32 ein WiFiClient, auf dem Host ein Socket.
+ */
+class StreamTransport {
+public:
+    virtual ~StreamTransport() {}
+    // Blockiert höchstens timeout_ms
+    virtual bool connect(const char* host, uint16_t port, uint32_t timeout_ms) = 0;
+    virtual bool send(const char* data, size_t len) = 0;
+    // Nicht blockierend: gelesene Bytes, 0 = gerade nichts da, -1 = Verbindung geschlossen
+    virtual int32_t receive(uint8_t* dst, size_t len) = 0;
+    virtual void close() = 0;
+    virtual uint32_t millis() = 0;
+    // Kurz warten, bevor wieder gelesen wird (Task abgeben)
+    virtual void idle() = 0;
+};
+
+/**
+ * @brief Öffnet einen Radio-Stream über HTTP/1.0 und liest ihn aus derselben Verbindung.
+ *
+ * open() folgt 3xx-Weiterleitungen (absolut oder relativ) und M3U/PLS-Playlists (erster
+ * http://-Eintrag) bis zu STATION_MAX_REDIRECTS Schritte. Am Ziel werden Content-Type, icy-br,
+ * icy-sr bzw. ice-audio-info nach StationInfo übernommen und die Verbindung bleibt offen; read()
+ * liefert ab dem ersten Byte nach dem Header. Es gibt also keine zweite Anfrage nur für die Header.
+ * Angefragt wird ohne "Icy-MetaData", damit der Server keine Titel-Blöcke in die Daten mischt.
+ * Nur http:// (kein TLS).
+ */
+class HttpStream {
+public:
+    explicit HttpStream(StreamTransport& transport) : _net(transport) {}
+
+    bool open(const char* url, StationInfo& info);
+    // Nicht blockierend, wie StreamTransport::receive()
+    int32_t read(uint8_t* dst, size_t len);
+    void close();
+    bool isOpen() const { return _open; }
+
+    // Anfragen seit dem Anlegen (für Tests und die Diagnose)
+    uint32_t requests() const { return _requests; }
+
+    /**
+     * @brief Ziel einer Weiterleitung relativ zur aktuellen URL auflösen.
+     * @return false, wenn das Ziel kein http:// ist oder nicht in 'len' passt.
+     */
+    static bool resolveLocation(const char* current, const char* location, char* out, size_t len);
+    // "http://host[:port]/pfad" zerlegen; path zeigt in 'url' (leer = "/")
+    static bool splitUrl(const char* url, char* host, size_t host_len, uint16_t& port, const char*& path);
+    // "ice-samplerate=44100;ice-bitrate=128;ice-channels=2"
+    static void parseAudioInfo(const char* value, StationInfo& info);
+
+private:
+    StreamTransport& _net;
+    bool _open = false;
+    uint32_t _requests = 0;
+    uint8_t _buf[HTTP_STREAM_BUFFER];
+    size_t _bufPos = 0;
+    size_t _bufLen = 0;
+
+    enum Result : uint8_t { HS_FAIL, HS_REDIRECT, HS_STREAM };
+
+    Result request(const char* url, StationInfo& info, char* next);
+    bool readLine(char* line, size_t max, uint32_t deadline);
+    bool readPlaylist(char* next);
+};
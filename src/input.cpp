@@ -0,0 +1,56 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#include "input.h"
+#include "encoder.h"
+
+static QueueHandle_t input_queue = nullptr;
+static esp_timer_handle_t input_timer = nullptr;
+static ButtonClassifier buttons;
+static EncoderAccel accel;
+// Rasten, die wegen voller Queue noch nicht abgegeben werden konnten
+static int32_t pending_detents = 0;
+
+// Läuft im esp_timer-Task, nicht in einer ISR: analogRead() ist hier erlaubt
+static void input_sample(void* arg) {
+    (void)arg;
+    uint32_t now = millis();
+
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < INPUT_OVERSAMPLE; i++) {
+        sum += analogRead(BUTTON_ADC_PIN);
+    }
+    InputEvent ev;
+    if (buttons.feed(sum / INPUT_OVERSAMPLE, now, ev)) {
+        xQueueSend(input_queue, &ev, 0);
+    }
+
+    pending_detents += accel.apply(handle_encoder(), now);
+    if (pending_detents != 0) {
+        ev.type = INPUT_ENCODER;
+        ev.button = 0;
+        ev.delta = constrain(pending_detents, INT16_MIN, INT16_MAX);
+        ev.ms = now;
+        if (xQueueSend(input_queue, &ev, 0) == pdPASS) pending_detents -= ev.delta;
+    }
+}
+
+void init_input() {
+    init_encoder();
+
+    input_queue = xQueueCreate(INPUT_QUEUE_LENGTH, sizeof(InputEvent));
+    esp_timer_create_args_t args = {};
+    args.callback = input_sample;
+    args.name = "input";
+    esp_timer_create(&args, &input_timer);
+    esp_timer_start_periodic(input_timer, INPUT_SAMPLE_MS * 1000);
+    Serial.println("Eingabe initialisiert.");
+}
+
+bool input_wait(InputEvent& ev, uint32_t timeout_ms) {
+    if (!input_queue) {
+        vTaskDelay(pdMS_TO_TICKS(timeout_ms));
+        return false;
+    }
+    return xQueueReceive(input_queue, &ev, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+#include "input_classifier.h"
+
+// Abtastintervall der Tasten-Leiter und des Drehgebers
+#ifndef INPUT_SAMPLE_MS
+#define INPUT_SAMPLE_MS 5
+#endif
+// ADC-Werte pro Abtastung, gemittelt gegen Rauschen
+#define INPUT_OVERSAMPLE 4
+#define INPUT_QUEUE_LENGTH 16
+
+/**
+ * @brief Startet die Eingabe: Drehgeber (Zählung im PCNT) und ein Timer, der alle INPUT_SAMPLE_MS
+ * die Widerstandsleiter abtastet. Die Ereignisse landen in einer Queue, loop() muss nicht pollen.
+ * Ersetzt init_encoder(); einmal in setup() aufrufen.
+ */
+void init_input();
+
+/**
+ * @brief Wartet bis zu timeout_ms auf das nächste Eingabe-Ereignis.
+ * @return false, wenn in der Zeit nichts kam
+ */
+bool input_wait(InputEvent& ev, uint32_t timeout_ms);
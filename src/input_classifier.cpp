@@ -0,0 +1,79 @@
+#include "input_classifier.h"
+
+// Grenzen der Bereiche: Taste 1 .. 3, dann 0 (keine Taste) bis zum Ende des 12-Bit-Bereichs
+static const uint16_t band_low[4]  = { INPUT_ADC_BUTTON3, 0, INPUT_ADC_BUTTON1, INPUT_ADC_BUTTON2 };
+static const uint16_t band_high[4] = { 4096, INPUT_ADC_BUTTON1, INPUT_ADC_BUTTON2, INPUT_ADC_BUTTON3 };
+
+uint8_t ButtonClassifier::classify(uint16_t raw, uint8_t current) {
+    uint8_t nominal;
+    if (raw < INPUT_ADC_BUTTON1) {
+        nominal = 1;
+    } else if (raw < INPUT_ADC_BUTTON2) {
+        nominal = 2;
+    } else if (raw < INPUT_ADC_BUTTON3) {
+        nominal = 3;
+    } else {
+        nominal = 0;
+    }
+    if (nominal == current || current > 3) return nominal;
+
+    // Knapp außerhalb des bisherigen Bereichs: noch als Rauschen werten
+    int32_t low = (int32_t)band_low[current] - INPUT_ADC_HYSTERESIS;
+    int32_t high = (int32_t)band_high[current] + INPUT_ADC_HYSTERESIS;
+    if ((int32_t)raw >= low && (int32_t)raw < high) return current;
+    return nominal;
+}
+
+bool ButtonClassifier::feed(uint16_t raw, uint32_t now_ms, InputEvent& ev) {
+    uint8_t reading = classify(raw, _candidate);
+    if (reading != _candidate) {
+        _candidate = reading;
+        _candidateSince = now_ms;
+    }
+
+    ev.delta = 0;
+    ev.ms = now_ms;
+    if (_candidate != _stable && now_ms - _candidateSince >= INPUT_DEBOUNCE_MS) {
+        if (_stable != 0) {
+            ev.type = INPUT_RELEASE;
+            ev.button = _stable;
+            _stable = 0;
+            return true;
+        }
+        _stable = _candidate;
+        _pressedAt = now_ms;
+        _longSent = false;
+        ev.type = INPUT_PRESS;
+        ev.button = _stable;
+        return true;
+    }
+
+    if (_stable != 0 && !_longSent && now_ms - _pressedAt >= INPUT_LONG_PRESS_MS) {
+        _longSent = true;
+        ev.type = INPUT_LONG_PRESS;
+        ev.button = _stable;
+        return true;
+    }
+    return false;
+}
+
+int16_t EncoderAccel::apply(int32_t detents, uint32_t now_ms) {
+    if (detents == 0) return 0;
+    uint32_t elapsed = now_ms - _last;
+    _last = now_ms;
+    if (elapsed == 0) elapsed = 1;
+
+    // Drehgeschwindigkeit in Rasten pro Sekunde seit der letzten Änderung
+    uint32_t count = detents < 0 ? -detents : detents;
+    uint32_t rate = count * 1000 / elapsed;
+    uint32_t factor = 1;
+    if (rate > INPUT_ACCEL_START) {
+        factor = rate / INPUT_ACCEL_START;
+        if (factor > INPUT_ACCEL_MAX) factor = INPUT_ACCEL_MAX;
+    }
+
+    int32_t out = detents * (int32_t)factor;
+    if (out > INT16_MAX) out = INT16_MAX;
+    if (out < INT16_MIN) out = INT16_MIN;
+    return (int16_t)out;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <stdint.h>
+
+// Entprellung und Klassifizierung der Eingaben ohne Arduino-Abhängigkeiten: ADC-Werte und Zeit
+// kommen von außen, damit sich die Logik auf dem Host mit aufgezeichneten ADC-Verläufen prüfen lässt.
+
+// Widerstandsleiter (1k, 10k, 100k) am 12-Bit-ADC: obere Grenzen der Tasten 1..3, darüber keine Taste
+#define INPUT_ADC_BUTTON1 100
+#define INPUT_ADC_BUTTON2 600
+#define INPUT_ADC_BUTTON3 1000
+// So weit darf der Wert über eine Grenze hinaus schwanken, ohne die Taste zu wechseln
+#ifndef INPUT_ADC_HYSTERESIS
+#define INPUT_ADC_HYSTERESIS 40
+#endif
+#ifndef INPUT_DEBOUNCE_MS
+#define INPUT_DEBOUNCE_MS 50
+#endif
+#ifndef INPUT_LONG_PRESS_MS
+#define INPUT_LONG_PRESS_MS 800
+#endif
+// Beschleunigung: ab so vielen Rasten pro Sekunde wird jede Raste vervielfacht, höchstens um INPUT_ACCEL_MAX
+#ifndef INPUT_ACCEL_START
+#define INPUT_ACCEL_START 20
+#endif
+#ifndef INPUT_ACCEL_MAX
+#define INPUT_ACCEL_MAX 4
+#endif
+
+enum InputEventType : uint8_t {
+    INPUT_PRESS = 0,
+    INPUT_RELEASE,
+    INPUT_LONG_PRESS,  // einmal pro Druck, nach INPUT_LONG_PRESS_MS
+    INPUT_ENCODER      // delta enthält die (beschleunigten) Rasten
+};
+
+struct InputEvent {
+    InputEventType type;
+    uint8_t button;    // 1..3 bei Tasten-Ereignissen
+    int16_t delta;     // bei INPUT_ENCODER
+    uint32_t ms;       // Zeitpunkt des Ereignisses
+};
+
+/**
+ * @brief Macht aus den ADC-Werten der Widerstandsleiter Tasten-Ereignisse.
+ * Eine Taste gilt erst als gedrückt bzw. losgelassen, wenn der Wert INPUT_DEBOUNCE_MS lang im
+ * selben Bereich liegt. Wechselt der Wert direkt von einer Taste zur anderen, kommt zuerst das
+ * Loslassen der alten, mit dem nächsten Wert das Drücken der neuen.
+ */
+class ButtonClassifier {
+public:
+    // Ein (überabgetasteter) ADC-Wert; true, wenn dabei ein Ereignis entsteht
+    bool feed(uint16_t raw, uint32_t now_ms, InputEvent& ev);
+    // Entprellt gedrückte Taste (0 = keine)
+    uint8_t pressed() const { return _stable; }
+
+    // Taste zum ADC-Wert; an den Grenzen bleibt es mit INPUT_ADC_HYSTERESIS bei 'current'
+    static uint8_t classify(uint16_t raw, uint8_t current);
+
+private:
+    uint8_t _stable = 0;
+    uint8_t _candidate = 0;
+    uint32_t _candidateSince = 0;
+    uint32_t _pressedAt = 0;
+    bool _longSent = false;
+};
+
+/**
+ * @brief Beschleunigung des Drehgebers: schnelles Drehen ändert die Lautstärke in größeren Schritten.
+ */
+class EncoderAccel {
+public:
+    int16_t apply(int32_t detents, uint32_t now_ms);
+
+private:
+    uint32_t _last = 0;
+};
@@ -0,0 +1,62 @@
+#include "jitter_buffer.h"
+#include <math.h>
+
+void JitterBuffer::begin(uint32_t bytes_per_second, uint32_t capacity_bytes) {
+    setByteRate(bytes_per_second);
+    uint32_t capacity_ms = (uint32_t)((uint64_t)capacity_bytes * 1000 / _byteRate);
+    _maxMs = capacity_ms * 4 / 5;
+    if (_maxMs > JITTER_MAX_MS) _maxMs = JITTER_MAX_MS;
+
+    _lastArrival = 0;
+    _lastDecay = 0;
+    _meanGap = 0;
+    _jitter = 0;
+    _peakGap = 0;
+    _targetMs.store(JITTER_PREFILL_MS < _maxMs ? JITTER_PREFILL_MS : _maxMs, std::memory_order_relaxed);
+    _jitterMs.store(0, std::memory_order_relaxed);
+    _state = JB_BUFFERING;
+    _underruns = 0;
+}
+
+void JitterBuffer::onArrival(uint32_t now_ms, uint32_t bytes) {
+    if (bytes == 0) return;
+    if (_lastArrival == 0) {
+        _lastArrival = now_ms;
+        _lastDecay = now_ms;
+        return;
+    }
+
+    float gap = (float)(now_ms - _lastArrival);
+    _lastArrival = now_ms;
+
+    // Glättung mit 1/16 wie beim RTP-Jitter
+    _meanGap += (gap - _meanGap) / 16.0f;
+    _jitter += (fabsf(gap - _meanGap) - _jitter) / 16.0f;
+
+    // Spitzenwert hält lange Aussetzer fest und klingt mit ca. 45 s Halbwertszeit ab
+    if (gap > _peakGap) _peakGap = gap;
+    while (now_ms - _lastDecay >= 1000) {
+        _peakGap -= _peakGap / 64.0f;
+        _lastDecay += 1000;
+    }
+
+    uint32_t target = (uint32_t)(4.0f * _jitter + 2.0f * _peakGap);
+    if (target < JITTER_PREFILL_MS) target = JITTER_PREFILL_MS;
+    if (target > _maxMs) target = _maxMs;
+    _targetMs.store(target, std::memory_order_relaxed);
+    _jitterMs.store((uint32_t)_jitter, std::memory_order_relaxed);
+}
+
+bool JitterBuffer::update(uint32_t fill_bytes, bool source_ended) {
+    if (_state == JB_BUFFERING) {
+        // Ist die Quelle zu Ende, den Rest noch ausspielen, statt auf Daten zu warten, die nicht kommen
+        if (fillMs(fill_bytes) >= targetMs() || (source_ended && fill_bytes > 0)) {
+            _state = JB_PLAYING;
+        }
+    } else if (fill_bytes < JITTER_UNDERRUN_BYTES && !source_ended) {
+        _state = JB_BUFFERING;
+        _underruns++;
+    }
+    // Leer und zu Ende: den Decoder laufen lassen, damit er das Ende bemerkt
+    return _state == JB_PLAYING || (source_ended && fill_bytes == 0);
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+// Jitter-Puffer-Logik für den Stream-Ring. Ohne Arduino-Abhängigkeiten (Zeit kommt von außen),
+// damit sie sich auf dem Host mit einer simulierten, ruckelnden Quelle durchspielen lässt.
+
+// Mindest-Vorpuffer vor dem Start bzw. nach einem Aussetzer
+#ifndef JITTER_PREFILL_MS
+#define JITTER_PREFILL_MS 2000
+#endif
+// Obergrenze für die Zieltiefe (zusätzlich begrenzt auf 80 % des Rings)
+#ifndef JITTER_MAX_MS
+#define JITTER_MAX_MS 10000
+#endif
+// Weniger als das im Ring gilt im laufenden Betrieb als Aussetzer (ca. ein Decoder-Lesevorgang)
+#define JITTER_UNDERRUN_BYTES 2048
+
+/**
+ * @brief Entscheidet, wann der Decoder laufen darf, und passt die Puffertiefe an das Netz an.
+ *
+ * Schreiberseite (Netzwerk-Task): onArrival() misst die Abstände zwischen eintreffenden Daten.
+ * Daraus werden ein geglätteter Jitter (mittlere Abweichung vom mittleren Abstand, wie RFC 3550)
+ * und ein langsam abklingender Spitzenwert der Lücken gebildet. Die Zieltiefe ist
+ * 4 x Jitter + 2 x Spitzenlücke, mindestens JITTER_PREFILL_MS.
+ *
+ * Leserseite (Audio-Task): update() mit dem Füllstand liefert, ob dekodiert werden darf.
+ * Gestartet wird erst, wenn die Zieltiefe erreicht ist; läuft der Puffer leer, wird pausiert und
+ * neu gepuffert, statt den Stream abzubauen.
+ */
+class JitterBuffer {
+public:
+    enum State : uint8_t {
+        JB_BUFFERING = 0,
+        JB_PLAYING
+    };
+
+    void begin(uint32_t bytes_per_second, uint32_t capacity_bytes);
+    // Tatsächliche Stream-Bitrate, sobald bekannt (Standard: STREAM_BITRATE_KBPS)
+    void setByteRate(uint32_t bytes_per_second) { _byteRate = bytes_per_second ? bytes_per_second : 1; }
+
+    // Daten liegen schon vor (Preroll): sofort spielen, erst ein Aussetzer puffert wieder
+    void skipPrefill() { _state = JB_PLAYING; }
+
+    // --- Schreiber ---
+    void onArrival(uint32_t now_ms, uint32_t bytes);
+    // Der Schreiber hat absichtlich pausiert (Ring voll): die nächste Lücke nicht als Jitter werten
+    void onThrottled() { _lastArrival = 0; }
+
+    // --- Leser ---
+    // true, wenn der Decoder weiterlaufen darf
+    bool update(uint32_t fill_bytes, bool source_ended);
+
+    State state() const { return _state; }
+    uint32_t targetMs() const { return _targetMs.load(std::memory_order_relaxed); }
+    uint32_t jitterMs() const { return _jitterMs.load(std::memory_order_relaxed); }
+    uint32_t underruns() const { return _underruns; }
+    uint32_t fillMs(uint32_t fill_bytes) const { return (uint32_t)((uint64_t)fill_bytes * 1000 / _byteRate); }
+
+private:
+    uint32_t _byteRate = 16000;
+    uint32_t _maxMs = JITTER_MAX_MS;
+
+    // Schreiberseite; Gleitkomma reicht hier, gerechnet wird nur beim Eintreffen von Daten
+    uint32_t _lastArrival = 0;
+    uint32_t _lastDecay = 0;
+    float _meanGap = 0;
+    float _jitter = 0;
+    float _peakGap = 0;
+
+    // Vom Schreiber gesetzt, vom Leser gelesen
+    std::atomic<uint32_t> _targetMs{JITTER_PREFILL_MS};
+    std::atomic<uint32_t> _jitterMs{0};
+
+    // Leserseite
+    State _state = JB_BUFFERING;
+    uint32_t _underruns = 0;
+};
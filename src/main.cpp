@@ -1,51 +1,47 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <WiFiManager.h>
-#include <Preferences.h>
 
-#include "AudioFileSourceICYStream.h"
-#include "AudioFileSourceBuffer.h"
-#include "AudioGeneratorMP3.h"
 #include "AudioOutputI2S.h"
 
 #include "BluetoothA2DPSink.h"
 #include "BluetoothA2DPOutput.h"
 
-#include "buttons.h"
-#include "encoder.h"
+#include "input.h"
 #include "amplifier.h"
+#include "radio.h"
+#include "timeshift.h"
+#include "bass_boost.h"
+#include "equalizer.h"
+#include "a2dp_dsp.h"
+#include "a2dp_output.h"
+#include "mode_controller.h"
+#include "boot_timeline.h"
+#include "wifi_fast.h"
+#include "settings.h"
+#include "telemetry.h"
+#include "power.h"
+#include "station_db.h"
 
 // --- Globale Objekte ---
-Preferences preferences;
 volatile bool switchToBluetoothRequested = false;
 
-// Radio-spezifische Objekte
-AudioFileSourceICYStream *file_stream = nullptr;
-AudioFileSourceBuffer *buffer = nullptr;
-AudioGeneratorMP3 *mp3_player = nullptr;
+// Radio-spezifische Objekte (Stream und Decoder gehören dem Audio-Task, siehe radio.cpp)
 AudioOutputI2S *i2s_output_radio = nullptr;
+AudioEffectBassBoost *bass_boost = nullptr;
+AudioEffectEQ *equalizer = nullptr;
 
 // Bluetooth-spezifische Objekte
 BluetoothA2DPSink a2dp_sink;
 BluetoothA2DPOutputLegacy *i2s_output_bluetooth = nullptr; 
+A2DPDspVolumeControl a2dp_dsp;
 
 WiFiManager wm;
 
 String current_radio_url = "";
-bool radio_is_playing = false;
 
-const char* radio_urls[] = {
-    "http://st01.dlf.de/dlf/01/128/mp3/stream.mp3", 
-    "http://st03.dlf.de/dlf/03/128/mp3/stream.mp3",   
-    "http://www.radioeins.de/livemp3"
-};
-
-enum AudioMode {
-    MODE_RADIO,
-    MODE_BLUETOOTH,
-    MODE_IDLE
-};
-AudioMode active_mode; 
+AudioMode active_mode;
+ModeController *mode_controller = nullptr;
 
 // --- Funktions-Deklarationen ---
 void handleModeChange(AudioMode new_mode, String url);
@@ -60,10 +56,8 @@ void connection_state_callback(esp_a2d_connection_state_t state, void *object) {
             sprintf(mac_str, "%02x:%02x:%02x:%02x:%02x:%02x",
                     (*bd_addr)[0], (*bd_addr)[1], (*bd_addr)[2],
                     (*bd_addr)[3], (*bd_addr)[4], (*bd_addr)[5]);
-            // Speichere mac_str in den Preferences
-            preferences.begin("audio_config", false);
-            preferences.putString("last_bt_addr", mac_str);
-            preferences.end();
+            // Läuft im Bluetooth-Task: nur im RAM merken, loop() schreibt es weg
+            settings_set_bt_addr(mac_str);
             Serial.printf("Adresse %s für Reconnect gespeichert.\n", mac_str);
         }
 
@@ -78,112 +72,222 @@ void connection_state_callback(esp_a2d_connection_state_t state, void *object) {
     }
 }
 
-void stopRadioStream() {
-    // Stoppt nur, wenn auch wirklich etwas läuft
-    if (!radio_is_playing && !(mp3_player && mp3_player->isRunning())) {
-        return;
+#ifdef AMP_DSP_OFFLOAD
+uint32_t amp_dsp_rate = 0; // Abtastrate, für die die Verstärker-Biquads geladen sind
+
+// Überträgt Bass-Filter und EQ in den DSP des TAS5805M. Scheitert das, bleibt die Software-Filterung aktiv.
+void offloadDspToAmplifier() {
+    uint32_t rate = bass_boost->GetRate() ? bass_boost->GetRate() : DSP_DEFAULT_RATE;
+
+    BiquadCoefficients biquads[1 + EQ_MAX_BANDS];
+    biquad_design(biquads[0], BIQUAD_LOWSHELF, bass_boost->GetCutoff(), bass_boost->GetGain(),
+                  BIQUAD_Q_BUTTERWORTH, rate);
+    for (uint8_t i = 0; i < EQ_MAX_BANDS; i++) {
+        const EQBand& band = equalizer->GetBand(i);
+        if (band.enabled && band.freq < rate / 2) {
+            biquad_design(biquads[1 + i], (BiquadType)band.type, band.freq, band.gain_db, band.q, rate);
+        } else {
+            biquads[1 + i] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f }; // Durchreichen
+        }
     }
-    Serial.println("Stoppe Radio-Stream und räume Audio-Objekte auf...");
-    if (mp3_player) {
-        mp3_player->stop();
-        delete mp3_player; 
-        mp3_player = nullptr;
+
+    bool ok = amplifier_load_biquads(biquads, 1 + EQ_MAX_BANDS);
+    bass_boost->SetBypass(ok);
+    equalizer->SetBypass(ok);
+    amp_dsp_rate = ok ? rate : 0;
+    Serial.printf("DSP-Filterung %s (%u Hz).\n", ok ? "im Verstärker" : "in Software", rate);
+}
+#endif
+
+// A2DP-Lautstärke (0..127) als Ausgabe der Lautstärke-Engine, linear über VOLUME_DB_MIN..MAX
+class A2dpVolumeSink : public VolumeSink {
+public:
+    int32_t code(float db, bool mute) const override {
+        if (mute) return 0;
+        return lroundf(127.0f * (db - (float)VOLUME_DB_MIN) / (float)(VOLUME_DB_MAX - VOLUME_DB_MIN));
     }
-    if (buffer) {
-        delete buffer;
-        buffer = nullptr;
+    bool write(int32_t code) override {
+        a2dp_sink.set_volume(code);
+        return true;
     }
-    if (file_stream) {
-        delete file_stream;
-        file_stream = nullptr;
+
+    static uint16_t level(int volume) {
+        return VolumeEngine::fromDb((float)VOLUME_DB_MIN + volume * (float)(VOLUME_DB_MAX - VOLUME_DB_MIN) / 127.0f);
     }
-    radio_is_playing = false;
-    Serial.println("Radio-Stream gestoppt.");
+};
+A2dpVolumeSink a2dp_volume;
+
+// Lautstärke am Telefon geändert: die Engine übernimmt den Pegel, damit der Encoder dort weiterregelt
+void a2dp_volume_callback(int volume) {
+    volume_sync(A2dpVolumeSink::level(volume));
 }
 
+// Der A2DP-Stack meldet die ausgehandelte Abtastrate (meist 44,1 oder 48 kHz)
+void a2dp_sample_rate_callback(uint16_t rate) {
+    a2dp_dsp.setSampleRate(rate);
+}
 
-void startRadioStream() {
-    // Stellt sicher, dass alles sauber ist, bevor wir starten
-    stopRadioStream();
+// --- Teilsysteme für warme Moduswechsel ---
 
-    if (WiFi.status() != WL_CONNECTED) {
-        Serial.println("Kein WLAN, kann Radio nicht starten.");
-        return;
-    }
-    
-    // Gespeicherte URL laden
-    preferences.begin("audio_config", true);
-    String radio_url = preferences.getString("radio_url", radio_urls[0]); // Default auf erste URL
-    preferences.end();
-    Serial.printf("Versuche, Radio von URL zu starten: %s\n", radio_url.c_str());
-
-    // Radio-Stream aufbauen
-    file_stream = new AudioFileSourceICYStream(radio_url.c_str());
-    buffer = new AudioFileSourceBuffer(file_stream, 16384);
-    mp3_player = new AudioGeneratorMP3();
-
-    if (mp3_player->begin(buffer, i2s_output_radio)) {
-        radio_is_playing = true;
-        Serial.println("Radio-Stream erfolgreich gestartet.");
-    } else {
-        Serial.println("Fehler beim Starten des MP3-Streams. Räume wieder auf.");
-        stopRadioStream();
+bool amplifier_ready = false;
+
+// Der Verstärker wird erst initialisiert, wenn der I2S-Bus konfiguriert ist (und nur einmal)
+void ensureAmplifier() {
+    if (!amplifier_ready) {
+        init_amplifier();
+        amplifier_ready = true;
     }
 }
 
+// Effekt-Kette Decoder -> Bass-Filter -> EQ -> I2S. Im Bluetooth-Modus rechnen dieselben Effekte
+// in-place auf den A2DP-Paketen, der EQ hat dann keine nächste Stufe.
+void initEffects() {
+    equalizer = new AudioEffectEQ(nullptr);
+    equalizer->LoadSettings();
+    bass_boost = new AudioEffectBassBoost(equalizer);
+    a2dp_dsp.addEffect(bass_boost);
+    a2dp_dsp.addEffect(equalizer);
+    a2dp_sink.set_volume_control(&a2dp_dsp);
+    a2dp_sink.set_sample_rate_callback(a2dp_sample_rate_callback);
+    a2dp_sink.set_avrc_rn_volumechange(a2dp_volume_callback);
+    a2dp_sink.set_on_connection_state_changed(connection_state_callback);
+}
 
+void createBluetoothOutput() {
+    if (i2s_output_bluetooth) return;
+    // Mit PSRAM gepuffert und driftkompensiert, sonst direkt auf I2S
+    i2s_output_bluetooth = new A2DPBufferedOutput();
+    i2s_pin_config_t pinCfg = {
+        .bck_io_num   = PIN_I2S_SCK,
+        .ws_io_num    = PIN_I2S_FS,
+        .data_out_num = PIN_I2S_SD,
+        .data_in_num  = I2S_PIN_NO_CHANGE
+    };
+    i2s_output_bluetooth->set_pin_config(pinCfg);
+    i2s_output_bluetooth->set_i2s_port((i2s_port_t)0);
+    a2dp_sink.set_output(*i2s_output_bluetooth);
+}
 
-void handleModeChange(AudioMode new_mode, String url) {
-    if (new_mode == MODE_IDLE) {
-        Serial.println("Wechsle in den IDLE-Modus: Kein WLAN, nur BT im Lauschmodus.");
-
-        preferences.begin("audio_config", false);
-        preferences.putUInt("audio_mode", new_mode);
-        preferences.end();
+class BoardSubsystems : public ModeSubsystems {
+public:
+    bool wifiUp() override {
+        // Mit den von WiFiManager gespeicherten Zugangsdaten verbinden, ohne Portal;
+        // zuerst direkt zum gemerkten Access Point, sonst mit Scan
+        if (!wifi_fast_connect()) {
+            WiFi.mode(WIFI_STA);
+            WiFi.begin();
+            uint32_t start = millis();
+            while (WiFi.status() != WL_CONNECTED && millis() - start < WIFI_CONNECT_TIMEOUT_MS) {
+                delay(50);
+            }
+        }
+        wifi_fast_store();
+        if (WiFi.status() == WL_CONNECTED) station_db_prepare();
+        // Ohne Verbindung trotzdem weiter: der Audio-Task startet den Stream, sobald WLAN da ist
+        return true;
+    }
 
-        // Deaktiviere WLAN
+    bool wifiDown() override {
         WiFi.disconnect(true);
         WiFi.mode(WIFI_OFF);
+        return true;
+    }
 
-        // Stoppe evtl. Radio
-        stopRadioStream();
+    bool radioUp(const char* url) override {
+        // Radio-spezifisches I2S-Objekt erstellen; es belegt I2S-Port 0
+        i2s_output_radio = new AudioOutputI2S(0, AudioOutputI2S::EXTERNAL_I2S, 20);
+        i2s_output_radio->SetPinout(PIN_I2S_SCK, PIN_I2S_FS, PIN_I2S_SD);
+        equalizer->SetNext(i2s_output_radio);
+        bass_boost->begin();
+        boot_mark("I2S gestartet");
+
+        ensureAmplifier();
+        volume_use_amplifier();
+        boot_mark("Verstärker bereit");
 
-        // Starte Bluetooth im Lauschmodus
+        radio_init(bass_boost);
+        radio_play(url);
+        return true;
+    }
+
+    bool radioDown() override {
+        // Ohne Bestätigung arbeitet der Audio-Task evtl. noch auf der Ausgabe: nichts freigeben,
+        // der ModeController wechselt dann über den Neustart
+        if (!radio_stop()) return false;
+        // Löschen gibt den I2S-Treiber frei, damit die A2DP-Ausgabe den Port übernehmen kann
+        equalizer->SetNext(nullptr);
+        delete i2s_output_radio;
+        i2s_output_radio = nullptr;
+        return true;
+    }
+
+    bool bluetoothUp() override {
+        createBluetoothOutput();
+        a2dp_sink.set_output_active(true);
+        if (!i2s_output_bluetooth->begin()) return false;
+        ensureAmplifier();
+        // Die Lautstärke regelt das Telefon (bzw. der Encoder über A2DP), der Verstärker steht fest auf 90 %
+        volume_use_sink(&a2dp_volume, A2dpVolumeSink::level(a2dp_sink.get_volume()), 90);
+        return true;
+    }
+
+    bool bluetoothDown() override {
+        // Der A2DP-Stack bleibt im Lauschmodus, nur die Ausgabe gibt I2S frei
         a2dp_sink.set_output_active(false);
-        a2dp_sink.start(BT_DEVICE_NAME);
+        i2s_output_bluetooth->end();
+        return true;
+    }
 
-        active_mode = MODE_IDLE;
-        return;
+    uint32_t freeHeap() override { return ESP.getFreeHeap(); }
+    uint32_t micros() override { return ::micros(); }
+
+    void restart(AudioMode target, const char* url) override {
+        // Zielmodus und URL stehen im Einstellungsspeicher (siehe handleModeChange) und müssen
+        // vor dem Neustart im NVS landen
+        settings_flush();
+        Serial.printf("Warmer Wechsel nach %s nicht möglich (freier Heap: %u), starte neu...\n",
+                      ModeController::name(target), ESP.getFreeHeap());
+        ESP.restart();
     }
+};
+BoardSubsystems board;
 
+void handleModeChange(AudioMode new_mode, String url) {
     if (active_mode == MODE_RADIO && new_mode == MODE_RADIO) {
         Serial.println("=> Weicher Senderwechsel wird durchgeführt (kein Neustart)...");
+        // Erst den Audio-Task beauftragen, dann den (langsamen) Flash-Zugriff erledigen
+        radio_play(url.c_str());
         if (url == current_radio_url) {
             Serial.println("Gleicher Sender wird neu gestartet...");
-            startRadioStream();
         } else {
             current_radio_url = url;
-            preferences.begin("audio_config", false);
-            preferences.putString("radio_url", url);
-            preferences.end();
-            startRadioStream(); 
+            settings_set_radio_url(url.c_str());
         }
         return;
     }
+    if (new_mode == active_mode) return;
 
-    // --- Standard-Logik für einen kompletten Moduswechsel mit Neustart ---
-    // (Wird für Radio->BT oder BT->Radio verwendet)
-    Serial.printf("Kompletter Moduswechsel wird vorbereitet: %d\n", new_mode);
+    if (new_mode == MODE_RADIO && url == "") url = current_radio_url;
+    Serial.printf("Moduswechsel: %s -> %s\n", ModeController::name(active_mode), ModeController::name(new_mode));
 
-    preferences.begin("audio_config", false);
-    preferences.putUInt("audio_mode", new_mode);
+    // Zielmodus merken: gilt beim nächsten Einschalten und für den Neustart-Rückfallweg
+    settings_set_mode(new_mode);
     if (new_mode == MODE_RADIO && url != "") {
-        preferences.putString("radio_url", url);
+        settings_set_radio_url(url.c_str());
+        current_radio_url = url;
         Serial.printf("Radio-URL gespeichert: %s\n", url.c_str());
     }
-    preferences.end();
-    
-    ESP.restart();
+
+    // Nur die betroffenen Teilsysteme ab- und aufbauen; bei Speichermangel oder Fehler Neustart
+    if (mode_controller->switchTo(new_mode, url.c_str())) {
+        active_mode = new_mode;
+        const ModeTiming& t = mode_controller->lastTiming();
+        for (uint8_t i = 0; i < t.steps; i++) {
+            Serial.printf("[MODE]   %s: %u ms\n", t.name[i], t.us[i] / 1000);
+        }
+        Serial.printf("[MODE] %s -> %s ohne Neustart in %u ms\n",
+                      ModeController::name(t.from), ModeController::name(t.to), t.total_us / 1000);
+    }
 }
 
 
@@ -191,49 +295,48 @@ void handleModeChange(AudioMode new_mode, String url) {
 
 void setup() {
     Serial.begin(115200);
+    boot_mark("setup()");
     if (psramFound()) Serial.println("PSRAM gefunden.");
 
  
-    preferences.begin("audio_config", true);
-    active_mode = (AudioMode)preferences.getUInt("audio_mode", MODE_RADIO); 
-    preferences.end();
+    // Alle Einstellungen in einem Durchgang lesen; danach arbeiten die Zugriffe im RAM
+    settings_load();
+    active_mode = (AudioMode)settings_mode();
+    boot_mark("NVS gelesen");
+    station_db_load();
     
     Serial.printf("\n--- Starte im Modus: %d ---\n\n", active_mode);
     
+    initEffects();
+
     if (active_mode == MODE_BLUETOOTH) {
         Serial.println("Bluetooth-Modus wird initialisiert...");
 
         // Erstellen der Standard I2S-Output-Instanz
-        i2s_output_bluetooth = new BluetoothA2DPOutputLegacy();
-        i2s_pin_config_t pinCfg = {
-            .bck_io_num   = PIN_I2S_SCK,
-            .ws_io_num    = PIN_I2S_FS,
-            .data_out_num = PIN_I2S_SD,
-            .data_in_num  = I2S_PIN_NO_CHANGE
-        };
-        i2s_output_bluetooth->set_pin_config(pinCfg);
-        i2s_output_bluetooth->set_i2s_port((i2s_port_t)0);
+        createBluetoothOutput();
 
         // Verstärker initialisieren, nachdem der I2S-Bus konfiguriert wurde.
-        init_amplifier();
-        init_encoder();
+        ensureAmplifier();
+        init_input();
+
+#ifdef AMP_DSP_OFFLOAD
+        offloadDspToAmplifier();
+#endif
 
-        a2dp_sink.set_output(*i2s_output_bluetooth);
         a2dp_sink.start(BT_DEVICE_NAME); 
+        boot_mark("A2DP gestartet");
         Serial.println("Bluetooth-Modus initialisiert. Bereit zum Verbinden.");
 
         // 1) Kurzes Delay, damit der A2DP-Stack vollständig hochfährt
         delay(500);
 
         // override the save volume for Bluetooth controll. The volume control happens 
-        // on the cell phone. set 80% on our board amp
+        // on the cell phone. set 90% on our board amp, the encoder controls the A2DP volume
         //
-        set_amplifier_temp_volume(90);
+        volume_use_sink(&a2dp_volume, A2dpVolumeSink::level(a2dp_sink.get_volume()), 90);
 
-        // 2) gespeicherte MAC-Adresse aus Preferences holen
-        preferences.begin("audio_config", true);
-        String lastMac = preferences.getString("last_bt_addr", "");
-        preferences.end();
+        // 2) gespeicherte MAC-Adresse aus den Einstellungen holen
+        String lastMac = settings_bt_addr();
 
         if (lastMac.length() == 17) {
             // 3) In esp_bd_addr_t umwandeln
@@ -259,116 +362,175 @@ void setup() {
         } else {
             Serial.println("Keine gültige gespeicherte MAC-Adresse; warte auf Telefon-Verbindung.");
         }
+        // Ohne Radio gibt es kein erstes Sample, das den Start abschließt
+        boot_finish("Bluetooth bereit");
     } 
     else if (active_mode == MODE_RADIO) {
         Serial.println("Radio-Modus wird initialisiert...");
 
-        // Radio-spezifisches I2S-Objekt erstellen und starten
-        i2s_output_radio = new AudioOutputI2S(0, AudioOutputI2S::EXTERNAL_I2S, 20);
-        i2s_output_radio->SetPinout(PIN_I2S_SCK, PIN_I2S_FS, PIN_I2S_SD);
-
-        i2s_output_radio->begin();
+        current_radio_url = settings_radio_url();
+        if (current_radio_url == "") current_radio_url = station_db_url(0);
 
-        preferences.begin("audio_config", true);
-        current_radio_url = preferences.getString("radio_url", radio_urls[0]);
-        preferences.end();
-
-        init_amplifier();
-        init_encoder();
+        init_input();
 
-        // WLAN verbinden
-        wm.setConnectTimeout(WIFI_CONNECT_TIMEOUT_MS / 1000);
-        wm.setConfigPortalTimeout(180);
-        if (!wm.autoConnect(AP_SSID, AP_PASSWORD)) {
-            Serial.println("WLAN-Verbindung fehlgeschlagen...");
+        // WLAN verbinden: erst direkt zum gemerkten Access Point, sonst über WiFiManager (Scan, ggf. Portal)
+        if (wifi_fast_connect()) {
+            Serial.println("WLAN über gemerkten Access Point verbunden.");
+        } else {
+            wm.setConnectTimeout(WIFI_CONNECT_TIMEOUT_MS / 1000);
+            wm.setConfigPortalTimeout(180);
+            if (!wm.autoConnect(AP_SSID, AP_PASSWORD)) {
+                Serial.println("WLAN-Verbindung fehlgeschlagen...");
+            }
         }
         
-        // Stream-Start wird an die Hilfsfunktion übergeben
+        // Stream-Start übernimmt der Audio-Task; ohne WLAN versucht er es weiter, bis es da ist
         if (WiFi.status() == WL_CONNECTED) {
+            boot_mark("WLAN verbunden");
             Serial.print("Verbunden mit WLAN: "); Serial.println(WiFi.SSID());
-            startRadioStream();
+            wifi_fast_store();
+            station_db_prepare();
         } else {
-            Serial.println("Keine WLAN-Verbindung, Radio wird nicht gestartet.");
+            Serial.println("Keine WLAN-Verbindung, Radio startet, sobald sie besteht.");
         }
+        // I2S, Verstärker und Audio-Task wie beim warmen Wechsel ins Radio
+        board.radioUp(current_radio_url.c_str());
+
+#ifdef AMP_DSP_OFFLOAD
+        offloadDspToAmplifier();
+#endif
 
         // Starte den zusätzlichen "Lausch-Modus" für Bluetooth ---
         Serial.println("Starte zusätzlichen Bluetooth-Stack im 'Lausch-Modus'...");
 
-        // Callback registrieren, um auf Verbindungen zu reagieren
-        a2dp_sink.set_on_connection_state_changed(connection_state_callback);
+        // Auf Verbindungen reagiert connection_state_callback (siehe initEffects)
         a2dp_sink.set_output_active(false);
         a2dp_sink.start(BT_DEVICE_NAME);
     }
     else if (active_mode == MODE_IDLE) {
         Serial.println("Starte im IDLE-Modus (nur passives Bluetooth).");
-        init_encoder();
+        init_input();
 
         a2dp_sink.set_output_active(false);
-        a2dp_sink.set_on_connection_state_changed(connection_state_callback);
         a2dp_sink.start(BT_DEVICE_NAME);
+        boot_finish("Bluetooth lauscht");
     }
+
+    mode_controller = new ModeController(board, active_mode);
 }
 
-int last_button_state = 0;
+// So lange wartet loop() höchstens auf Eingaben, bevor die periodischen Aufgaben laufen
+#define LOOP_IDLE_MS 50
 
-void loop() {
+// Tasten-Ereignis für die Taste des Senders, der gerade läuft, und der Zeitversatz ist verfügbar
+static bool timeshiftButton(const InputEvent& ev) {
+    if (ev.type == INPUT_ENCODER || active_mode != MODE_RADIO || !radio_timeshift_available()) return false;
+    if (ev.button < 2 || ev.button > 3) return false;
+    const char* url = station_db_favorite(ev.button);
+    return url && current_radio_url == url;
+}
 
+void handleInput(const InputEvent& ev) {
+    if (ev.type == INPUT_ENCODER) {
+        if (active_mode == MODE_RADIO || active_mode == MODE_BLUETOOTH) {
+            // Radio: lokaler Verstärker, Bluetooth: A2DP-Lautstärke (siehe volume_use_*)
+            volume_step(ev.delta);
+        }
+    }
+    else if (timeshiftButton(ev)) {
+        // Taste des laufenden Senders mit Zeitversatz: kurz = Pause/Weiter, lang = zurückspulen
+        static bool skipped = false;
+        if (ev.type == INPUT_LONG_PRESS) {
+            radio_seek(-(int32_t)TIMESHIFT_SKIP_SECONDS * 1000);
+            skipped = true;
+        } else if (ev.type == INPUT_RELEASE) {
+            if (!skipped) {
+                if (radio_is_paused()) radio_resume();
+                else radio_pause();
+            }
+            skipped = false;
+        }
+    }
+    else if (ev.type == INPUT_PRESS) {
+        if (ev.button == 1) {
+            handleModeChange(MODE_IDLE, ""); 
+        }
+        else if (ev.button >= 2 && ev.button <= 3) {
+            // Lieblingssender der Taste aus der Senderliste
+            const char* url = station_db_favorite(ev.button);
+            if (url) handleModeChange(MODE_RADIO, url);
+        }
+    }
+    // Loslassen und langer Druck der übrigen Tasten sind keiner Funktion zugeordnet
+}
+
+void loop() {
+    // Blockiert, bis eine Eingabe kommt (Timer-Abtastung in input.cpp), statt im 10-ms-Takt zu pollen
+    InputEvent ev;
+    bool has_input = input_wait(ev, LOOP_IDLE_MS);
+    uint32_t loop_us = micros();
+
+    // Zeitleiste des Starts einmal ausgeben, sobald das erste Sample gespielt ist
+    boot_timeline_poll();
+    telemetry_poll();
+    power_poll(active_mode);
+
+    // Längster loop()-Durchlauf ohne das Warten: zeigt, wie lange die UI blockiert ist
+    static uint32_t max_loop_us = 0;
+
+    // Geänderte Einstellungen gesammelt schreiben, wenn eine Weile Ruhe ist
+    if (settings_poll()) {
+        Serial.printf("[NVS] Einstellungen geschrieben in %u us (gesamt %u Schreibzugriffe), "
+                      "längster loop()-Durchlauf seit dem letzten Schreiben: %u us\n",
+                      micros() - loop_us, settings_flash_writes(), max_loop_us);
+        max_loop_us = 0;
+    }
     if (switchToBluetoothRequested) {
         switchToBluetoothRequested = false;
         handleModeChange(MODE_BLUETOOTH, "");
     }
 
-    // Aktionen für den aktuellen Modus ausführen
+#ifdef AMP_DSP_OFFLOAD
+    // Decoder bzw. A2DP-Stack hat eine andere Abtastrate gemeldet: Verstärker-Biquads dafür neu laden
+    if (bass_boost && bass_boost->IsBypassed() && bass_boost->GetRate() &&
+        (uint32_t)bass_boost->GetRate() != amp_dsp_rate) {
+        offloadDspToAmplifier();
+    }
+#endif
+
+    // Stream, Decoder und I2S laufen im Audio-Task; hier nur Aussetzer melden
     if (active_mode == MODE_RADIO) {
-        if (mp3_player && mp3_player->isRunning()) {
-            // Fall 1: Alles läuft normal.
-            if (!mp3_player->loop()) {
-                Serial.println("Radio-Stream beendet oder unterbrochen.");
-                stopRadioStream();
-                // restart des streams erfolgt in dem zweite durchlaufen der loop()
-            }
-        } 
-        else {
-            // Fall 2: Der Player sollte laufen, tut es aber nicht -> Reconnect versuchen.
-            if (WiFi.status() == WL_CONNECTED) {
-                Serial.println("Radio spielt nicht, versuche Neustart des Streams...");
-                delay(200);
-                startRadioStream();
-            } else {
-                Serial.println("Warte auf WLAN-Verbindung...");
-                delay(200);
-            }
+        static uint32_t reported_underruns = 0;
+        uint32_t underruns = radio_underruns();
+        if (underruns != reported_underruns) {
+            Serial.printf("Audio-Aussetzer: %u\n", underruns);
+            reported_underruns = underruns;
         }
-    } 
-
+    }
 
-    int increment = handle_encoder();
-    if (increment != 0) { // Nur reagieren, wenn der Regler gedreht wurde
-        if (active_mode == MODE_RADIO) {
-            // Im Radio-Modus: Steuere den lokalen Verstärker
-            inc_amplifier(increment);
-        } 
-        else if (active_mode == MODE_BLUETOOTH) {
-            int current = a2dp_sink.get_volume();
-            int newVolume = constrain(current + increment, 0, 127);
-            a2dp_sink.set_volume(newVolume);
-            Serial.printf("Aktuelle Lautstärke: %d\n", a2dp_sink.get_volume());
-        }
+#ifdef UI_STRESS_MS
+    // Belastungstest: blockiert die UI-Schleife, die Wiedergabe darf davon nichts merken
+    uint32_t stress_start = millis();
+    while (millis() - stress_start < UI_STRESS_MS) {}
+#endif
+
+    static uint32_t last_input = millis();
+    if (has_input) {
+        handleInput(ev);
+        power_input_handled();
+        last_input = millis();
     }
 
+    uint32_t pass_us = micros() - loop_us;
+    if (pass_us > max_loop_us) max_loop_us = pass_us;
 
-    // Auf eine *neue* Tastendruck-Aktion reagieren
-    int button    = handle_button();
-    if (button != last_button_state && button > 0) {
-        if (button == 1) {
-            handleModeChange(MODE_IDLE, ""); 
-        }
-        else if (button >= 2 && button <= 3) {
-            int url_index = button - 1;
-            handleModeChange(MODE_RADIO, radio_urls[url_index]);
-        }
+#ifdef POWER_IDLE_LIGHT_SLEEP
+    // Nach dem Messen: die Schlafzeit zählt nicht als blockierte UI
+    if (active_mode == MODE_IDLE && millis() - last_input >= POWER_IDLE_SLEEP_MS) {
+        // Ausstehende Einstellungen vorher schreiben; wecken kann nur eine Eingabe
+        settings_flush();
+        power_idle_sleep();
+        last_input = millis();
     }
-    last_button_state = button;
-
-    delay(10);
+#endif
 }
@@ -0,0 +1,62 @@
+#include "mode_controller.h"
+
+const char* ModeController::name(AudioMode mode) {
+    switch (mode) {
+        case MODE_RADIO:     return "Radio";
+        case MODE_BLUETOOTH: return "Bluetooth";
+        case MODE_IDLE:      return "IDLE";
+    }
+    return "?";
+}
+
+template <class F>
+bool ModeController::step(const char* name, F fn) {
+    uint32_t start = _sub.micros();
+    bool ok = fn();
+    if (_timing.steps < MODE_MAX_STEPS) {
+        _timing.name[_timing.steps] = name;
+        _timing.us[_timing.steps] = _sub.micros() - start;
+        _timing.steps++;
+    }
+    return ok;
+}
+
+bool ModeController::switchTo(AudioMode target, const char* url) {
+    if (target == _mode) return true;
+
+    if (_sub.freeHeap() < MODE_WARM_MIN_HEAP) {
+        _sub.restart(target, url);
+        return false;
+    }
+
+    _timing = {};
+    _timing.from = _mode;
+    _timing.to = target;
+    uint32_t start = _sub.micros();
+    bool ok = true;
+
+    // Abbauen, was der Zielmodus nicht braucht
+    if (_mode == MODE_RADIO) {
+        ok = ok && step("Radio ab", [&] { return _sub.radioDown(); });
+        ok = ok && step("WLAN aus", [&] { return _sub.wifiDown(); });
+    } else if (_mode == MODE_BLUETOOTH) {
+        ok = ok && step("BT-Ausgabe ab", [&] { return _sub.bluetoothDown(); });
+    }
+
+    // Aufbauen, was fehlt
+    if (target == MODE_RADIO) {
+        ok = ok && step("WLAN an", [&] { return _sub.wifiUp(); });
+        ok = ok && step("Radio an", [&] { return _sub.radioUp(url); });
+    } else if (target == MODE_BLUETOOTH) {
+        ok = ok && step("BT-Ausgabe an", [&] { return _sub.bluetoothUp(); });
+    }
+
+    _timing.total_us = _sub.micros() - start;
+    if (!ok) {
+        // Halb umgebauter Zustand: sauber über den Neustart in den Zielmodus
+        _sub.restart(target, url);
+        return false;
+    }
+    _mode = target;
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <stdint.h>
+
+// Betriebsarten; der Wert wird als "audio_mode" im NVS gespeichert
+enum AudioMode {
+    MODE_RADIO,
+    MODE_BLUETOOTH,
+    MODE_IDLE
+};
+
+// Unter dieser Heap-Grenze wird nicht warm umgeschaltet, sondern neu gestartet
+#ifndef MODE_WARM_MIN_HEAP
+#define MODE_WARM_MIN_HEAP 60000
+#endif
+
+#define MODE_MAX_STEPS 4
+
+/**
+ * @brief Die Teilsysteme, die ein Moduswechsel ab- und aufbaut.
+ * main.cpp implementiert sie mit WLAN, I2S und dem A2DP-Stack; für Host-Tests lassen sie sich
+ * durch Attrappen ersetzen. Rückgabe false = Schritt fehlgeschlagen, es folgt der Neustart.
+ */
+class ModeSubsystems {
+public:
+    virtual ~ModeSubsystems() {}
+
+    virtual bool wifiUp() = 0;
+    virtual bool wifiDown() = 0;
+    // I2S-Treiber für den Radio-Pfad anlegen und den Sender starten
+    virtual bool radioUp(const char* url) = 0;
+    // Stream stoppen und den I2S-Treiber freigeben
+    virtual bool radioDown() = 0;
+    // I2S-Port an die A2DP-Ausgabe übergeben und die Ausgabe aktivieren
+    virtual bool bluetoothUp() = 0;
+    // A2DP-Ausgabe abschalten (der Stack bleibt im Lauschmodus) und I2S freigeben
+    virtual bool bluetoothDown() = 0;
+
+    virtual uint32_t freeHeap() = 0;
+    virtual uint32_t micros() = 0;
+    // Rückfallweg: Zielmodus speichern und neu starten (kehrt auf dem Gerät nicht zurück)
+    virtual void restart(AudioMode target, const char* url) = 0;
+};
+
+/**
+ * @brief Dauer der einzelnen Schritte des letzten Moduswechsels.
+ */
+struct ModeTiming {
+    AudioMode from;
+    AudioMode to;
+    uint8_t steps;
+    const char* name[MODE_MAX_STEPS];
+    uint32_t us[MODE_MAX_STEPS];
+    uint32_t total_us;
+};
+
+/**
+ * @brief Zustandsmaschine für Radio/Bluetooth/IDLE ohne ESP.restart().
+ * Baut beim Wechsel nur ab, was der Zielmodus nicht braucht, und nur auf, was fehlt:
+ *   Radio -> BT:   Radio ab (I2S frei), WLAN aus, A2DP-Ausgabe an
+ *   BT -> Radio:   A2DP-Ausgabe aus, WLAN an, Radio an
+ *   Radio -> IDLE: Radio ab, WLAN aus
+ *   IDLE <-> BT:   nur die A2DP-Ausgabe
+ * Ist zu wenig Heap frei oder schlägt ein Schritt fehl, bleibt der Neustart als Rückfallweg.
+ */
+class ModeController {
+public:
+    ModeController(ModeSubsystems& subsystems, AudioMode initial) : _sub(subsystems), _mode(initial) {}
+
+    // true = warm umgeschaltet; false = Neustart wurde angestoßen
+    bool switchTo(AudioMode target, const char* url = "");
+
+    AudioMode mode() const { return _mode; }
+    const ModeTiming& lastTiming() const { return _timing; }
+
+    static const char* name(AudioMode mode);
+
+private:
+    ModeSubsystems& _sub;
+    AudioMode _mode;
+    ModeTiming _timing = {};
+
+    template <class F>
+    bool step(const char* name, F fn);
+};
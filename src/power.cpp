@@ -0,0 +1,83 @@
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <driver/rtc_io.h>
+#include <atomic>
+
+#include "power.h"
+
+namespace {
+std::atomic<uint32_t> work_cycles{0};
+uint32_t window_start = 0;
+uint32_t woke_at = 0;    // millis() beim Aufwachen, 0 = nicht geschlafen
+#ifdef POWER_GOVERNOR
+PowerGovernor governor;  // nur aus loop()
+#endif
+#ifdef POWER_IDLE_LIGHT_SLEEP
+bool sleep_rejected = false;
+#endif
+}
+
+void power_work(uint32_t cycles) {
+    work_cycles.fetch_add(cycles, std::memory_order_relaxed);
+}
+
+void power_poll(AudioMode mode) {
+    uint32_t now = millis();
+    if (window_start == 0) window_start = now;
+    if (now - window_start < POWER_WINDOW_MS) return;
+    uint32_t cycles = work_cycles.exchange(0, std::memory_order_relaxed);
+    uint32_t window_us = (now - window_start) * 1000;
+    window_start = now;
+
+#ifdef POWER_GOVERNOR
+    uint16_t floor_mhz = mode == MODE_BLUETOOTH ? POWER_BT_MIN_MHZ : PowerGovernor::MHZ[0];
+    uint16_t before = governor.mhz();
+    uint16_t mhz = governor.update(cycles, window_us, floor_mhz);
+    if (mhz != getCpuFrequencyMhz()) {
+        // Der APB-Takt (80 MHz) und damit I2S, UART und Timer bleiben auf allen drei Stufen gleich
+        setCpuFrequencyMhz(mhz);
+        Serial.printf("[POWER] CPU %u -> %u MHz (Audio-Last %u MHz)\n", before, mhz, governor.neededMhz());
+    }
+#else
+    (void)mode;
+    (void)cycles;
+    (void)window_us;
+#endif
+}
+
+bool power_idle_sleep() {
+#ifdef POWER_IDLE_LIGHT_SLEEP
+    if (sleep_rejected) return false;
+
+    // Tastenleiter: eine gedrückte Taste zieht den ADC-Pin auf Low. Encoder: Pegelwechsel an Spur A.
+    // Beide Pins sind RTC-GPIOs und wecken damit auch aus dem Light Sleep.
+    esp_sleep_enable_ext1_wakeup(1ULL << BUTTON_ADC_PIN, ESP_EXT1_WAKEUP_ALL_LOW);
+    esp_sleep_enable_ext0_wakeup((gpio_num_t)ENC_PIN_A, !digitalRead(ENC_PIN_A));
+    Serial.println("[POWER] Light Sleep bis Taste oder Encoder.");
+    Serial.flush();
+
+    uint32_t start = millis();
+    esp_err_t err = esp_light_sleep_start();
+    // ext0 hat den Encoder-Pin in die RTC-Domäne geholt; der Pulszähler braucht ihn digital
+    rtc_gpio_deinit((gpio_num_t)ENC_PIN_A);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+
+    if (err != ESP_OK) {
+        Serial.printf("[POWER] Light Sleep abgelehnt (%d), bleibt aus.\n", err);
+        sleep_rejected = true;
+        return false;
+    }
+    woke_at = millis();
+    Serial.printf("[POWER] Aufgewacht nach %u ms (Grund %d).\n", woke_at - start, (int)esp_sleep_get_wakeup_cause());
+    return true;
+#else
+    return false;
+#endif
+}
+
+void power_input_handled() {
+    if (woke_at == 0) return;
+    // Aufwachen bis verarbeitete Eingabe: enthält Entprellung (INPUT_DEBOUNCE_MS) und Abtastung
+    Serial.printf("[POWER] Aufwachen -> Eingabe verarbeitet: %u ms\n", millis() - woke_at);
+    woke_at = 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+#include "mode_controller.h"
+#include "power_governor.h"
+
+// Fensterlänge, über die die Audio-Last gemittelt wird
+#ifndef POWER_WINDOW_MS
+#define POWER_WINDOW_MS 500
+#endif
+// Mindestfrequenz im Bluetooth-Modus: SBC-Dekodierung und Controller laufen im Stack und
+// werden nicht gemessen
+#ifndef POWER_BT_MIN_MHZ
+#define POWER_BT_MIN_MHZ 160
+#endif
+// IDLE: nach so langer Ruhe an den Eingaben in den Light Sleep (nur mit POWER_IDLE_LIGHT_SLEEP)
+#ifndef POWER_IDLE_SLEEP_MS
+#define POWER_IDLE_SLEEP_MS 10000
+#endif
+
+// Audio-Task bzw. Bluetooth-Task: so viele CPU-Zyklen hat die Audio-Verarbeitung gerade gebraucht
+void power_work(uint32_t cycles);
+
+/**
+ * @brief Aus loop(): führt einmal pro POWER_WINDOW_MS die CPU-Frequenz nach (nur mit POWER_GOVERNOR).
+ * Die Stufe wählt PowerGovernor aus den über power_work() gemeldeten Zyklen.
+ */
+void power_poll(AudioMode mode);
+
+/**
+ * @brief IDLE: legt den Chip in den Light Sleep, bis eine Taste gedrückt oder der Encoder gedreht
+ * wird (nur mit POWER_IDLE_LIGHT_SLEEP, sonst sofort false).
+ * Während des Schlafs nimmt der Bluetooth-Stack keine Verbindungen an.
+ * @return true, wenn geschlafen wurde
+ */
+bool power_idle_sleep();
+
+// Aus loop(), sobald eine Eingabe verarbeitet ist: meldet einmal pro Aufwachen die Latenz
+void power_input_handled();
@@ -0,0 +1,38 @@
+#include "power_governor.h"
+
+const uint16_t PowerGovernor::MHZ[PowerGovernor::LEVELS] = { 80, 160, 240 };
+
+uint16_t PowerGovernor::update(uint32_t busy_cycles, uint32_t window_us, uint16_t floor_mhz) {
+    if (window_us == 0) return mhz();
+    _needed = (uint32_t)(((uint64_t)busy_cycles + window_us - 1) / window_us);
+
+    // Niedrigste Stufe, auf der die Arbeit unter der Ziellast bleibt, nicht unter der Mindestfrequenz
+    uint8_t want = LEVELS - 1;
+    for (uint8_t i = 0; i < LEVELS; i++) {
+        if (MHZ[i] >= floor_mhz && (uint64_t)_needed * 100 <= (uint64_t)MHZ[i] * POWER_TARGET_LOAD_PERCENT) {
+            want = i;
+            break;
+        }
+    }
+
+    uint8_t level = _level;
+    if (want > _level) {
+        level = want;
+        _calm = 0;
+    } else if (want < _level) {
+        if (++_calm >= POWER_DOWN_WINDOWS) {
+            level = _level - 1;
+            _calm = 0;
+        }
+    } else {
+        _calm = 0;
+    }
+    // Mindestfrequenz gilt auch ohne Last sofort (Moduswechsel)
+    while (MHZ[level] < floor_mhz && level < LEVELS - 1) level++;
+
+    if (level != _level) {
+        _level = level;
+        _switches++;
+    }
+    return mhz();
+}
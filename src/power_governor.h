@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+
+// Wahl der CPU-Frequenz aus der gemessenen Last. Ohne Arduino-Abhängigkeiten: Zyklen und
+// Fensterlänge kommen von außen, damit sich die Regel auf dem Host mit Lastverläufen prüfen lässt.
+
+// So viel der CPU darf die gemessene Audio-Arbeit höchstens belegen; der Rest bleibt für
+// ungemessene Arbeit (Netzwerk, Bluetooth-Stack, I2S) und Lastspitzen
+#ifndef POWER_TARGET_LOAD_PERCENT
+#define POWER_TARGET_LOAD_PERCENT 50
+#endif
+// Herunter erst, wenn die niedrigere Stufe so viele Fenster in Folge gereicht hätte
+#ifndef POWER_DOWN_WINDOWS
+#define POWER_DOWN_WINDOWS 6
+#endif
+
+/**
+ * @brief Stuft die CPU zwischen 80, 160 und 240 MHz.
+ *
+ * update() bekommt die im letzten Fenster gemessenen Audio-Zyklen. Zyklen pro Mikrosekunde
+ * ergeben die benötigten MHz; eine Stufe reicht, wenn diese höchstens
+ * POWER_TARGET_LOAD_PERCENT von ihr belegen. Hinauf geht es sofort auf die passende Stufe,
+ * hinab nur eine Stufe nach POWER_DOWN_WINDOWS ruhigen Fenstern, damit kurze Lastpausen
+ * (Puffern, Senderwechsel) nicht hin und her schalten.
+ */
+class PowerGovernor {
+public:
+    static const uint8_t LEVELS = 3;
+    static const uint16_t MHZ[LEVELS];
+
+    /**
+     * @param busy_cycles Gemessene Zyklen im Fenster
+     * @param window_us Länge des Fensters
+     * @param floor_mhz Mindestfrequenz des Modus (z.B. wegen ungemessener Arbeit)
+     * @return gewünschte Frequenz in MHz
+     */
+    uint16_t update(uint32_t busy_cycles, uint32_t window_us, uint16_t floor_mhz);
+
+    uint16_t mhz() const { return MHZ[_level]; }
+    // Benötigte MHz im letzten Fenster (bei 100 % Auslastung)
+    uint32_t neededMhz() const { return _needed; }
+    uint32_t switches() const { return _switches; }
+
+private:
+    uint8_t _level = LEVELS - 1;  // Start auf voller Frequenz
+    uint8_t _calm = 0;            // Fenster in Folge, in denen die nächstniedrigere Stufe gereicht hätte
+    uint32_t _needed = 0;
+    uint32_t _switches = 0;
+};
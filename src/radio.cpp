@@ -0,0 +1,476 @@
+#include <Arduino.h>
+#include <WiFi.h>
+
+#include "AudioGeneratorMP3.h"
+#include "AudioGeneratorAAC.h"
+
+#include "radio.h"
+#include "stream_ring.h"
+#include "reconnect.h"
+#include "station_cache.h"
+#include "stream_format.h"
+#include "boot_timeline.h"
+#include "telemetry.h"
+#include "timeshift.h"
+#include "power.h"
+
+// WLAN/BT-Stack laufen auf Kern 0, loop() auf Kern 1 mit Priorität 1
+#ifndef AUDIO_TASK_CORE
+#define AUDIO_TASK_CORE 1
+#endif
+#ifndef AUDIO_TASK_PRIORITY
+#define AUDIO_TASK_PRIORITY 5
+#endif
+#define AUDIO_TASK_STACK 10240
+
+#define RADIO_URL_MAX 256
+// Die I2S-DMA-Puffer (20 x 128 Frames) überbrücken knapp 58 ms bei 44,1 kHz
+#define RADIO_UNDERRUN_MS 50
+// So oft wird der Füllstand des Stream-Puffers ausgegeben
+#define RADIO_STATS_INTERVAL_MS 10000
+
+// Preroll-Cache: hält pro Sender die jüngsten Sekunden Stream-Daten im PSRAM, damit ein
+// Senderwechsel sofort Ton liefert, während die Live-Verbindung noch aufgebaut wird (0 = aus)
+#ifndef STATION_PREROLL_SECONDS
+#define STATION_PREROLL_SECONDS 0
+#endif
+#define STATION_PREROLL_SLOTS 3
+// Älteres Preroll wird verworfen, der Sender startet dann mit normalem Vorpuffer
+#define STATION_PREROLL_MAX_AGE_MS (5UL * 60 * 1000)
+
+enum RadioCommandType : uint8_t {
+    RADIO_CMD_PLAY,
+    RADIO_CMD_STOP,
+    RADIO_CMD_PAUSE,
+    RADIO_CMD_RESUME,
+    RADIO_CMD_SEEK
+};
+
+struct RadioCommand {
+    RadioCommandType type;
+    uint32_t requested;  // millis() beim Auslösen, für die Latenzmessung
+    int32_t seek_ms;     // RADIO_CMD_SEEK: relativ zur aktuellen Position, negativ = zurück
+    char url[RADIO_URL_MAX];
+};
+
+static QueueHandle_t command_queue = nullptr;
+static SemaphoreHandle_t stop_done = nullptr;
+static AudioOutput *audio_output = nullptr;
+
+// --- Nur vom Audio-Task benutzt ---
+// Einmal in radio_init() angelegt und für jeden Sender wiederverwendet (kein new/delete pro Wechsel)
+static AudioFileSourceStation *file_stream = nullptr;
+static AudioFileSourceRing *buffer = nullptr;
+static AudioGeneratorMP3 *mp3_player = nullptr;
+// AAC-Decoder erst beim ersten AAC-Sender anlegen (Helix braucht einige 10 KB), danach behalten
+static AudioGeneratorAAC *aac_player = nullptr;
+// Der Decoder des laufenden Senders (mp3_player oder aac_player)
+static AudioGenerator *player = nullptr;
+static bool codec_guessed = false;  // Decoder ohne Sender-Cache gewählt, nach dem Verbinden prüfen
+static char current_url[RADIO_URL_MAX] = "";
+static uint32_t play_requested = 0;
+static bool want_playing = false;
+// Backoff für den kompletten Neuaufbau (Decoder-Fehler); Abbrüche der Verbindung fängt der Ring selbst ab
+static ReconnectPolicy restart;
+static uint32_t last_service = 0;
+static uint32_t last_stats = 0;
+static bool buffering = false;
+
+// --- Von beiden Seiten gelesen ---
+static volatile bool playing = false;
+static volatile uint32_t underruns = 0;
+static volatile bool paused = false;
+
+#if TIMESHIFT_SECONDS > 0
+// Zeitversatz: Verlauf im PSRAM, gehört dem Audio-Task (Schreiben über buffer->pump(), Lesen im Decoder)
+static TimeshiftHistory timeshift;
+
+static void timeshiftInit() {
+    uint32_t bytes = (uint32_t)TIMESHIFT_SECONDS * STREAM_BITRATE_KBPS * 1000 / 8;
+    uint32_t frames = (uint32_t)TIMESHIFT_SECONDS * TIMESHIFT_FRAMES_PER_SECOND;
+    uint8_t* mem = psramFound() ? (uint8_t*)ps_malloc(bytes) : nullptr;
+    TimeshiftFrame* index = mem ? (TimeshiftFrame*)ps_malloc(frames * sizeof(TimeshiftFrame)) : nullptr;
+    if (!index) {
+        free(mem);
+        Serial.println("Zeitversatz: nicht genug PSRAM, bleibt aus.");
+        return;
+    }
+    timeshift.init(mem, bytes, index, frames);
+    buffer->setHistory(&timeshift);
+    Serial.printf("Zeitversatz: %u s Verlauf, %u KB im PSRAM\n", TIMESHIFT_SECONDS,
+                  (unsigned)((bytes + frames * sizeof(TimeshiftFrame)) / 1024));
+}
+#endif
+
+
+#if STATION_PREROLL_SECONDS > 0
+struct PrerollSlot {
+    char url[RADIO_URL_MAX];
+    uint8_t* data;
+    uint32_t len;
+    uint32_t stamp;
+};
+static PrerollSlot preroll[STATION_PREROLL_SLOTS];
+static const uint32_t PREROLL_BYTES = (uint32_t)STATION_PREROLL_SECONDS * STREAM_BITRATE_KBPS * 1000 / 8;
+
+static PrerollSlot* prerollFind(const char* url) {
+    for (uint8_t i = 0; i < STATION_PREROLL_SLOTS; i++) {
+        if (preroll[i].len > 0 && strcmp(preroll[i].url, url) == 0) return &preroll[i];
+    }
+    return nullptr;
+}
+
+// Nach dem Stoppen: die jüngsten Daten des Senders sichern (ältester Slot wird ersetzt)
+static void prerollSave() {
+    PrerollSlot* slot = prerollFind(current_url);
+    if (!slot) {
+        slot = &preroll[0];
+        for (uint8_t i = 1; i < STATION_PREROLL_SLOTS; i++) {
+            if (preroll[i].stamp < slot->stamp) slot = &preroll[i];
+        }
+    }
+    if (!slot->data) {
+        slot->data = (uint8_t*)ps_malloc(PREROLL_BYTES);
+        if (!slot->data) return;
+    }
+    slot->len = buffer->takeTail(slot->data, PREROLL_BYTES);
+    slot->stamp = millis();
+    strlcpy(slot->url, current_url, sizeof(slot->url));
+}
+#endif
+
+static AudioGenerator* selectPlayer(StreamCodec codec) {
+    if (codec == CODEC_AAC) {
+        if (!aac_player) aac_player = new AudioGeneratorAAC();
+        Serial.println("Decoder: AAC");
+        return aac_player;
+    }
+    Serial.println("Decoder: MP3");
+    return mp3_player;
+}
+
+// Nach dem Vorpuffern eines neuen Senders oder beim ersten Decoderfehler: hat der Netzwerk-Task
+// einen anderen Codec gemeldet als den geratenen? Prüft nur einmal je Start.
+static bool codecMismatch() {
+    if (!codec_guessed) return false;
+    codec_guessed = false;
+    StationInfo info;
+    if (!station_cache_load(current_url, info)) return false;
+    StreamCodec codec = stream_codec(info.content_type, info.url);
+    return (codec == CODEC_AAC) != (player == aac_player);
+}
+
+static void stopStream() {
+    // Stoppt nur, wenn auch wirklich etwas läuft
+    if (!playing && !(player && player->isRunning())) {
+        return;
+    }
+    Serial.println("Stoppe Radio-Stream...");
+    // Der Decoder schließt dabei den Ring; Objekte und Speicher bleiben für den nächsten Sender
+    player->stop();
+    buffer->stop();
+#if STATION_PREROLL_SECONDS > 0
+    prerollSave();
+#endif
+    playing = false;
+    paused = false;
+    buffering = false;
+    last_service = 0;
+    Serial.println("Radio-Stream gestoppt.");
+}
+
+static void startStream() {
+    // Stellt sicher, dass alles sauber ist, bevor wir starten
+    stopStream();
+
+    if (WiFi.status() != WL_CONNECTED) {
+        Serial.println("Warte auf WLAN-Verbindung...");
+        return;
+    }
+    Serial.printf("Versuche, Radio von URL zu starten: %s\n", current_url);
+
+    // Der Netzwerk-Task verbindet und füllt den Ring, der Decoder startet sofort und wartet auf Daten
+    const uint8_t* pre = nullptr;
+    uint32_t pre_len = 0;
+#if STATION_PREROLL_SECONDS > 0
+    PrerollSlot* slot = prerollFind(current_url);
+    if (slot && millis() - slot->stamp < STATION_PREROLL_MAX_AGE_MS) {
+        pre = slot->data;
+        pre_len = slot->len;
+        Serial.printf("Spiele %u Bytes Preroll, bis der Sender verbunden ist.\n", pre_len);
+    }
+#endif
+
+    // Aus dem letzten Verbindungsaufbau Bekanntes vorab einstellen: Ausgaberate, Puffertiefe, Decoder
+    StationInfo info;
+    uint16_t bitrate = 0;
+    StreamCodec codec;
+    if (station_cache_load(current_url, info)) {
+        Serial.printf("Sender-Cache: %s, %s, %u kbps, %u Hz\n",
+                      info.url, info.content_type, info.bitrate_kbps, info.sample_rate);
+        if (info.sample_rate) audio_output->SetRate(info.sample_rate);
+        bitrate = info.bitrate_kbps;
+        codec = stream_codec(info.content_type, info.url);
+        codec_guessed = false;
+    } else {
+        // Noch nie verbunden: nach der Endung raten und nach dem Vorpuffern mit dem dann
+        // gemerkten Content-Type vergleichen (siehe codecMismatch)
+        codec = stream_codec("", current_url);
+        codec_guessed = true;
+    }
+    player = selectPlayer(codec);
+    buffer->start(current_url, pre, pre_len, bitrate);
+
+    if (player->begin(buffer, audio_output)) {
+        playing = true;
+        Serial.println("Radio-Stream erfolgreich gestartet.");
+    } else {
+        Serial.println("Fehler beim Starten des MP3-Streams. Räume wieder auf.");
+        buffer->stop();
+    }
+}
+
+static void handleCommand(const RadioCommand& cmd) {
+    switch (cmd.type) {
+        case RADIO_CMD_PLAY:
+            stopStream();
+            strlcpy(current_url, cmd.url, sizeof(current_url));
+            play_requested = cmd.requested;
+            want_playing = true;
+            restart.trigger(millis());
+            break;
+        case RADIO_CMD_STOP:
+            want_playing = false;
+            stopStream();
+            xSemaphoreGive(stop_done);
+            break;
+#if TIMESHIFT_SECONDS > 0
+        case RADIO_CMD_PAUSE:
+            if (!playing || paused) break;
+            paused = true;
+            Serial.printf("Pause (Zeitversatz %u s).\n", timeshift.delayMs() / 1000);
+            break;
+        case RADIO_CMD_RESUME:
+            if (!paused) break;
+            paused = false;
+            last_service = 0;
+            Serial.printf("Weiter, %u s hinter live.\n", timeshift.delayMs() / 1000);
+            break;
+        case RADIO_CMD_SEEK: {
+            if (!playing) break;
+            // Nur der Cursor springt (Binärsuche im Frame-Index); der Decoder findet am
+            // Frame-Anfang sofort wieder Sync
+            buffer->pump();
+            uint32_t start_us = micros();
+            uint32_t delay_ms = timeshift.seek(cmd.seek_ms);
+            Serial.printf("Zeitversatz: %u s hinter live (Sprung in %u us).\n",
+                          delay_ms / 1000, micros() - start_us);
+            break;
+        }
+#else
+        default:
+            break;
+#endif
+    }
+}
+
+static void audio_task(void *arg) {
+    RadioCommand cmd;
+    for (;;) {
+        // Ohne laufenden Stream blockierend auf Befehle warten, sonst nur nachsehen
+        TickType_t wait = 0;
+        bool running = player && player->isRunning();
+        if (!want_playing) {
+            wait = portMAX_DELAY;
+        } else if (!running) {
+            if (restart.state() == ReconnectPolicy::RC_CONNECTED) restart.onDisconnect(millis());
+            wait = pdMS_TO_TICKS(restart.remainingMs(millis()));
+        }
+        while (xQueueReceive(command_queue, &cmd, wait) == pdTRUE) {
+            handleCommand(cmd);
+            wait = 0;
+        }
+
+        if (player && player->isRunning()) {
+            uint32_t now = millis();
+            if (now - last_stats >= RADIO_STATS_INTERVAL_MS) {
+                const JitterBuffer& jb = buffer->jitter();
+                Serial.printf("Stream-Puffer: %u%% (min. %u%%), Ziel %u ms, Jitter %u ms, leergelaufen %u\n",
+                              buffer->getFillPercent(), buffer->takeLowWatermark(),
+                              jb.targetMs(), jb.jitterMs(), jb.underruns());
+#if TIMESHIFT_SECONDS > 0
+                if (timeshift.ready()) {
+                    Serial.printf("Zeitversatz: %u s hinter live, Verlauf %u s, überschrieben %u Bytes\n",
+                                  timeshift.delayMs() / 1000, timeshift.lengthMs() / 1000, timeshift.lost());
+                }
+#endif
+                last_stats = now;
+            }
+
+            if (paused) {
+                // Decoder steht (I2S spielt Stille), der Stream läuft weiter in den Verlauf
+                buffer->pump();
+                last_service = 0;
+                vTaskDelay(pdMS_TO_TICKS(20));
+                continue;
+            }
+
+            if (!buffer->readyToPlay()) {
+                // Start oder Puffer leergelaufen: Decoder pausiert (I2S spielt Stille), bis die
+                // Zieltiefe wieder erreicht ist. Stream und Decoder bleiben dabei bestehen.
+                if (!buffering) {
+                    Serial.printf("Puffere Stream (Ziel %u ms)...\n", buffer->jitter().targetMs());
+                    buffering = true;
+                }
+                last_service = 0;
+                vTaskDelay(pdMS_TO_TICKS(20));
+                continue;
+            }
+            if (buffering) {
+                buffering = false;
+                if (codecMismatch()) {
+                    Serial.println("Stream hat einen anderen Codec als geraten, starte mit passendem Decoder neu.");
+                    stopStream();
+                    restart.trigger(millis());
+                    continue;
+                }
+                Serial.printf("Wiedergabe läuft, %u ms gepuffert.\n",
+                              buffer->jitter().fillMs(buffer->getFillLevel()));
+            }
+
+            // Lücken in der Versorgung zählen, die die DMA-Puffer nicht mehr überbrücken
+            if (last_service != 0 && now - last_service > RADIO_UNDERRUN_MS) {
+                underruns++;
+                telemetry_underrun();
+            }
+            last_service = now;
+
+            telemetry_stream(buffer->getFillPercent(),
+                             buffer->reconnect().reconnects() + restart.reconnects());
+            uint32_t decode_start = ESP.getCycleCount();
+            bool decoding = player->loop();
+            uint32_t decode_cycles = ESP.getCycleCount() - decode_start;
+            telemetry_decode(decode_cycles);
+            power_work(decode_cycles);
+            if (!decoding) {
+                // Ein falsch geratener Decoder scheitert oft schon an den ersten Frames, auch wenn
+                // gar nicht gepuffert wurde (Preroll): dann ohne Backoff mit dem passenden neu starten
+                if (codecMismatch()) {
+                    Serial.println("Decoder passt nicht zum Codec des Streams, starte mit passendem Decoder neu.");
+                    stopStream();
+                    restart.trigger(millis());
+                    continue;
+                }
+                Serial.println("Radio-Stream beendet oder unterbrochen.");
+                stopStream();
+                restart.onDisconnect(millis());
+            } else if (play_requested != 0) {
+                Serial.printf("Latenz Senderwahl -> erstes Sample: %u ms\n", millis() - play_requested);
+                boot_finish("Erstes Sample");
+                play_requested = 0;
+            }
+            // Ausgabe ist voll: CPU für niedrigere Prioritäten freigeben
+            vTaskDelay(1);
+        } else if (want_playing && restart.due(millis())) {
+            // Der Player sollte laufen, tut es aber nicht -> Neustart, ohne den Task zu blockieren
+            startStream();
+            if (playing) {
+                restart.onSuccess();
+            } else {
+                restart.onFailure(millis());
+                Serial.printf("Nächster Versuch in %u ms.\n", restart.backoffMs());
+            }
+        }
+    }
+}
+
+void radio_init(AudioOutput* output) {
+    audio_output = output;
+    // Bei warmen Moduswechseln mehrfach aufgerufen: Task und Objekte gibt es dann schon
+    if (command_queue) return;
+    restart.seed(esp_random());
+
+    // Stream-Quelle, Ring (PSRAM) und Decoder (vorab reservierter Speicher im internen RAM)
+    // leben so lange wie die Firmware; so zerstückelt ein Senderwechsel den Heap nicht
+    file_stream = new AudioFileSourceStation();
+    buffer = new AudioFileSourceRing(file_stream);
+    void* mp3_space = malloc(AudioGeneratorMP3::preAllocSize());
+    mp3_player = mp3_space ? new AudioGeneratorMP3(mp3_space, AudioGeneratorMP3::preAllocSize())
+                           : new AudioGeneratorMP3();
+#if TIMESHIFT_SECONDS > 0
+    timeshiftInit();
+#endif
+    command_queue = xQueueCreate(4, sizeof(RadioCommand));
+    stop_done = xSemaphoreCreateBinary();
+    xTaskCreatePinnedToCore(audio_task, "audio", AUDIO_TASK_STACK, nullptr,
+                            AUDIO_TASK_PRIORITY, nullptr, AUDIO_TASK_CORE);
+}
+
+void radio_play(const char* url) {
+    RadioCommand cmd;
+    cmd.type = RADIO_CMD_PLAY;
+    cmd.requested = millis();
+    cmd.seek_ms = 0;
+    strlcpy(cmd.url, url, sizeof(cmd.url));
+    xQueueSend(command_queue, &cmd, portMAX_DELAY);
+}
+
+bool radio_stop() {
+    if (!command_queue) return true;
+    RadioCommand cmd;
+    cmd.type = RADIO_CMD_STOP;
+    cmd.requested = millis();
+    cmd.seek_ms = 0;
+    cmd.url[0] = '\0';
+    xSemaphoreTake(stop_done, 0);
+    xQueueSend(command_queue, &cmd, portMAX_DELAY);
+    if (xSemaphoreTake(stop_done, pdMS_TO_TICKS(2000)) != pdTRUE) {
+        // Audio-Task hängt noch im Abbau (z.B. Netzwerk-Task in einem Verbindungsaufbau)
+        Serial.println("Radio-Stopp: Audio-Task hat nach 2 s nicht bestätigt.");
+        return false;
+    }
+    return true;
+}
+
+bool radio_is_playing() {
+    return playing;
+}
+
+uint32_t radio_underruns() {
+    return underruns;
+}
+
+// Aus loop(): bei voller Queue geht der Tastendruck verloren, statt die UI zu blockieren
+static void sendTimeshiftCommand(RadioCommandType type, int32_t seek_ms) {
+    if (!radio_timeshift_available()) return;
+    RadioCommand cmd;
+    cmd.type = type;
+    cmd.requested = millis();
+    cmd.seek_ms = seek_ms;
+    cmd.url[0] = '\0';
+    xQueueSend(command_queue, &cmd, 0);
+}
+
+bool radio_timeshift_available() {
+#if TIMESHIFT_SECONDS > 0
+    return command_queue && timeshift.ready();
+#else
+    return false;
+#endif
+}
+
+void radio_pause() {
+    sendTimeshiftCommand(RADIO_CMD_PAUSE, 0);
+}
+
+void radio_resume() {
+    sendTimeshiftCommand(RADIO_CMD_RESUME, 0);
+}
+
+bool radio_is_paused() {
+    return paused;
+}
+
+void radio_seek(int32_t delta_ms) {
+    sendTimeshiftCommand(RADIO_CMD_SEEK, delta_ms);
+}
@@ -0,0 +1,48 @@
+#ifndef RADIO_H
+#define RADIO_H
+
+#include <Arduino.h>
+#include "AudioOutput.h"
+
+/**
+ * @brief Startet den Audio-Task (Stream holen, MP3 dekodieren, an die Ausgabe geben).
+ * Der Task läuft mit höherer Priorität als loop() auf einem festen Kern, damit langsame
+ * UI-Aktionen (Flash-Schreibzugriffe, I2C, Wartezeiten) die Wiedergabe nicht aushungern.
+ * @param output Erste Stufe der Ausgabekette (z.B. Bass-Filter -> EQ -> I2S)
+ * Darf erneut aufgerufen werden; Task und Stream-Objekte werden nur beim ersten Mal angelegt.
+ */
+void radio_init(AudioOutput* output);
+
+/**
+ * @brief Spielt die URL ab. Kehrt sofort zurück, der Audio-Task übernimmt Auf- und Abbau.
+ */
+void radio_play(const char* url);
+
+/**
+ * @brief Stoppt den Stream und wartet, bis der Audio-Task alles freigegeben hat.
+ * @return false, wenn der Audio-Task nicht innerhalb von 2 s bestätigt hat. Er kann dann noch
+ * auf die Ausgabe zugreifen; sie darf nicht freigegeben werden.
+ */
+bool radio_stop();
+
+bool radio_is_playing();
+
+/**
+ * @brief Anzahl der Aussetzer, in denen die Ausgabe länger als die I2S-DMA-Puffer reichen
+ * nicht versorgt wurde.
+ */
+uint32_t radio_underruns();
+
+/**
+ * @brief Zeitversatz (nur mit TIMESHIFT_SECONDS > 0 und genug PSRAM): der Stream läuft in einen
+ * Verlauf im PSRAM, aus dem der Decoder zeitversetzt liest. Pausieren hält nur den Decoder an,
+ * die Verbindung bleibt bestehen. Ohne Verlauf tun die Funktionen nichts.
+ */
+bool radio_timeshift_available();
+void radio_pause();
+void radio_resume();
+bool radio_is_paused();
+// Relativ zur aktuellen Position springen (negativ = zurück); begrenzt auf Verlauf und live
+void radio_seek(int32_t delta_ms);
+
+#endif // RADIO_H
@@ -0,0 +1,66 @@
+#include "reconnect.h"
+
+void ReconnectPolicy::onDisconnect(uint32_t now_ms) {
+    if (_state != RC_CONNECTED) return;
+    _failures = 0;
+    _recovering = true;
+    schedule(now_ms);
+}
+
+void ReconnectPolicy::trigger(uint32_t now_ms) {
+    _failures = 0;
+    _recovering = false;
+    _backoff = 0;
+    _nextAttempt = now_ms;
+    _state = RC_WAITING;
+}
+
+bool ReconnectPolicy::due(uint32_t now_ms) {
+    if (_state != RC_WAITING) return false;
+    if ((int32_t)(now_ms - _nextAttempt) < 0) return false;
+    _state = RC_CONNECTING;
+    return true;
+}
+
+uint32_t ReconnectPolicy::remainingMs(uint32_t now_ms) const {
+    if (_state != RC_WAITING) return 0;
+    int32_t remaining = (int32_t)(_nextAttempt - now_ms);
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+void ReconnectPolicy::onSuccess() {
+    // Die erste Verbindung nach trigger() ist keine Wiederverbindung, erst die nach einem Verlust
+    // oder Fehlversuch
+    if (_state != RC_CONNECTED && _recovering) _reconnects++;
+    _recovering = false;
+    _state = RC_CONNECTED;
+    _failures = 0;
+    _backoff = 0;
+}
+
+void ReconnectPolicy::onFailure(uint32_t now_ms) {
+    if (_failures < 0xFFFF) _failures++;
+    _recovering = true;
+    schedule(now_ms);
+}
+
+void ReconnectPolicy::schedule(uint32_t now_ms) {
+    // Basis * 2^Fehlversuche, gedeckelt; ab 2^16 ändert sich ohnehin nichts mehr
+    uint32_t d = RECONNECT_BASE_MS;
+    for (uint16_t i = 0; i < _failures && d < RECONNECT_MAX_MS; i++) d <<= 1;
+    if (d > RECONNECT_MAX_MS) d = RECONNECT_MAX_MS;
+
+    _backoff = d / 2 + random() % (d / 2 + 1);
+    _nextAttempt = now_ms + _backoff;
+    _state = RC_WAITING;
+}
+
+uint32_t ReconnectPolicy::random() {
+    // xorshift32 reicht für die Streuung und ist auf dem Host reproduzierbar
+    uint32_t x = _rand;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    _rand = x;
+    return x;
+}
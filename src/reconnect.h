@@ -0,0 +1,65 @@
+#pragma once
+#include <stdint.h>
+
+// Wiederverbindungs-Logik für den Radio-Stream. Ohne Arduino-Abhängigkeiten (Zeit und Zufall
+// kommen von außen), damit sie sich auf dem Host gegen einen lokalen Test-Server prüfen lässt.
+
+#ifndef RECONNECT_BASE_MS
+#define RECONNECT_BASE_MS 500
+#endif
+#ifndef RECONNECT_MAX_MS
+#define RECONNECT_MAX_MS 30000
+#endif
+
+/**
+ * @brief Nicht-blockierende Zustandsmaschine für Verbindungsversuche mit exponentiellem Backoff.
+ *
+ * Nach einem Verbindungsverlust wird die Wartezeit pro Fehlversuch verdoppelt (RECONNECT_BASE_MS
+ * bis RECONNECT_MAX_MS) und zufällig auf die Hälfte bis das Ganze gestreut ("equal jitter"), damit
+ * viele Geräte nach einem Server-Ausfall nicht im Gleichtakt anklopfen.
+ * Der Aufrufer fragt mit due() ab, ob ein Versuch fällig ist, und meldet das Ergebnis zurück.
+ */
+class ReconnectPolicy {
+public:
+    enum State : uint8_t {
+        RC_CONNECTED = 0,
+        RC_WAITING,    // Backoff läuft
+        RC_CONNECTING  // Versuch läuft, Ergebnis steht aus
+    };
+
+    explicit ReconnectPolicy(uint32_t seed = 1) : _rand(seed ? seed : 1) {}
+
+    void seed(uint32_t seed) { _rand = seed ? seed : 1; }
+
+    // Verbindung verloren: erster Versuch nach der Basis-Wartezeit
+    void onDisconnect(uint32_t now_ms);
+    // Sofort (ohne Backoff) verbinden, z.B. beim Senderwechsel
+    void trigger(uint32_t now_ms);
+    // true, wenn jetzt verbunden werden soll (wechselt nach RC_CONNECTING)
+    bool due(uint32_t now_ms);
+    void onSuccess();
+    void onFailure(uint32_t now_ms);
+
+    State state() const { return _state; }
+    // Fehlversuche seit der letzten erfolgreichen Verbindung
+    uint16_t failures() const { return _failures; }
+    // Wiederverbindungen insgesamt (für die Statistik): erfolgreiche Verbindungen nach einem
+    // Verlust oder Fehlversuch, nicht der erste Aufbau nach trigger()
+    uint32_t reconnects() const { return _reconnects; }
+    // Wartezeit des aktuell laufenden Backoffs
+    uint32_t backoffMs() const { return _backoff; }
+    // Zeit bis zum nächsten fälligen Versuch (0 = jetzt)
+    uint32_t remainingMs(uint32_t now_ms) const;
+
+private:
+    State _state = RC_CONNECTED;
+    uint16_t _failures = 0;
+    uint32_t _reconnects = 0;
+    bool _recovering = false;  // seit trigger() ging eine Verbindung verloren oder ein Versuch schief
+    uint32_t _backoff = 0;
+    uint32_t _nextAttempt = 0;
+    uint32_t _rand;
+
+    void schedule(uint32_t now_ms);
+    uint32_t random();
+};
@@ -0,0 +1,165 @@
+#include <Arduino.h>
+#include <Preferences.h>
+
+#include "settings.h"
+#include <tas5805m.hpp>
+
+static Preferences preferences;
+
+// Bits für die Dirty-Markierung
+enum {
+    SET_MODE      = 1 << 0,
+    SET_VOLUME    = 1 << 1,
+    SET_RADIO_URL = 1 << 2,
+    SET_BT_ADDR   = 1 << 3,
+    SET_EQ        = 1 << 4,
+};
+
+namespace {
+struct Settings {
+    uint32_t mode;
+    int volume;
+    char radio_url[SETTINGS_URL_MAX];
+    char bt_addr[18];
+    EQBand eq[EQ_MAX_BANDS];
+    bool eq_valid;
+};
+
+Settings current;
+uint8_t dirty = 0;
+uint32_t last_change = 0;
+uint32_t flash_writes = 0;
+SemaphoreHandle_t lock = nullptr;
+// Hält nur, wer gerade schreibt: zwei Schreiber dürfen sich nicht überholen (alter Stand zuletzt)
+SemaphoreHandle_t flush_lock = nullptr;
+
+struct Guard {
+    Guard() { xSemaphoreTake(lock, portMAX_DELAY); }
+    ~Guard() { xSemaphoreGive(lock); }
+};
+
+void markDirty(uint8_t bit) {
+    dirty |= bit;
+    last_change = millis();
+}
+}
+
+void settings_load() {
+    if (!lock) lock = xSemaphoreCreateMutex();
+    if (!flush_lock) flush_lock = xSemaphoreCreateMutex();
+    Guard g;
+
+    // Ein einziger Durchgang durch den Namensraum statt begin/end pro Wert
+    preferences.begin("audio_config", true);
+    current.mode = preferences.getUInt("audio_mode", 0);
+    current.volume = preferences.getUInt("audio_volume", TAS5805M_VOLUME_DEFAULT);
+    strlcpy(current.radio_url, preferences.getString("radio_url", "").c_str(), sizeof(current.radio_url));
+    strlcpy(current.bt_addr, preferences.getString("last_bt_addr", "").c_str(), sizeof(current.bt_addr));
+    current.eq_valid = preferences.getBytesLength("eq_bands") == sizeof(current.eq) &&
+                       preferences.getBytes("eq_bands", current.eq, sizeof(current.eq)) == sizeof(current.eq);
+    preferences.end();
+    dirty = 0;
+}
+
+// Schreibt den Stand, der beim Aufruf galt. Unter 'lock' wird nur kopiert; der Flash-Zugriff
+// (einige ms) läuft danach, damit Getter und Setter aus anderen Tasks nicht darauf warten.
+// Was sich währenddessen ändert, ist wieder dirty und geht mit dem nächsten Schreiben raus.
+static bool flushSnapshot(bool only_if_idle) {
+    xSemaphoreTake(flush_lock, portMAX_DELAY);
+    Settings copy;
+    uint8_t bits;
+    {
+        Guard g;
+        if (only_if_idle && millis() - last_change < SETTINGS_FLUSH_DELAY_MS) bits = 0;
+        else bits = dirty;
+        if (bits) copy = current;
+        dirty &= ~bits;
+    }
+    if (bits) {
+        preferences.begin("audio_config", false);
+        if (bits & SET_MODE)      preferences.putUInt("audio_mode", copy.mode);
+        if (bits & SET_VOLUME)    preferences.putUInt("audio_volume", copy.volume);
+        if (bits & SET_RADIO_URL) preferences.putString("radio_url", copy.radio_url);
+        if (bits & SET_BT_ADDR)   preferences.putString("last_bt_addr", copy.bt_addr);
+        if (bits & SET_EQ)        preferences.putBytes("eq_bands", copy.eq, sizeof(copy.eq));
+        preferences.end();
+        flash_writes += __builtin_popcount(bits);
+    }
+    xSemaphoreGive(flush_lock);
+    return bits != 0;
+}
+
+bool settings_poll() {
+    return flushSnapshot(true);
+}
+
+void settings_flush() {
+    flushSnapshot(false);
+}
+
+uint32_t settings_flash_writes() {
+    return flash_writes;
+}
+
+uint32_t settings_mode() {
+    Guard g;
+    return current.mode;
+}
+
+void settings_set_mode(uint32_t mode) {
+    Guard g;
+    if (current.mode == mode) return;
+    current.mode = mode;
+    markDirty(SET_MODE);
+}
+
+int settings_volume() {
+    Guard g;
+    return current.volume;
+}
+
+void settings_set_volume(int volume) {
+    Guard g;
+    if (current.volume == volume) return;
+    current.volume = volume;
+    markDirty(SET_VOLUME);
+}
+
+String settings_radio_url() {
+    Guard g;
+    return String(current.radio_url);
+}
+
+void settings_set_radio_url(const char* url) {
+    Guard g;
+    if (strncmp(current.radio_url, url, sizeof(current.radio_url)) == 0) return;
+    strlcpy(current.radio_url, url, sizeof(current.radio_url));
+    markDirty(SET_RADIO_URL);
+}
+
+String settings_bt_addr() {
+    Guard g;
+    return String(current.bt_addr);
+}
+
+void settings_set_bt_addr(const char* addr) {
+    Guard g;
+    if (strncmp(current.bt_addr, addr, sizeof(current.bt_addr)) == 0) return;
+    strlcpy(current.bt_addr, addr, sizeof(current.bt_addr));
+    markDirty(SET_BT_ADDR);
+}
+
+bool settings_eq_bands(EQBand* bands) {
+    Guard g;
+    if (!current.eq_valid) return false;
+    memcpy(bands, current.eq, sizeof(current.eq));
+    return true;
+}
+
+void settings_set_eq_bands(const EQBand* bands) {
+    Guard g;
+    if (current.eq_valid && memcmp(current.eq, bands, sizeof(current.eq)) == 0) return;
+    memcpy(current.eq, bands, sizeof(current.eq));
+    current.eq_valid = true;
+    markDirty(SET_EQ);
+}
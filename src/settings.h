@@ -0,0 +1,51 @@
+#pragma once
+#include <Arduino.h>
+#include "equalizer.h"
+
+// Erst wenn sich so lange nichts mehr geändert hat, wird ins NVS geschrieben
+#ifndef SETTINGS_FLUSH_DELAY_MS
+#define SETTINGS_FLUSH_DELAY_MS 2000
+#endif
+
+#define SETTINGS_URL_MAX 256
+
+/**
+ * @brief Zentraler Einstellungsspeicher für den Namensraum "audio_config".
+ * Beim Start werden alle Schlüssel in einem Durchgang gelesen, danach arbeiten die Zugriffe nur
+ * im RAM. Geänderte Werte werden als "dirty" markiert und erst von settings_poll() gesammelt
+ * geschrieben, wenn SETTINGS_FLUSH_DELAY_MS lang keine Änderung mehr kam. Ein schnell gedrehter
+ * Encoder kostet so einen Flash-Schreibzugriff statt einem pro Raste.
+ * Die Zugriffe sind über einen Mutex abgesichert und dürfen aus jedem Task kommen.
+ */
+void settings_load();
+
+// Schreibt geänderte Werte, sobald seit der letzten Änderung SETTINGS_FLUSH_DELAY_MS vergangen sind.
+// Regelmäßig aus loop() aufrufen. true, wenn geschrieben wurde.
+bool settings_poll();
+
+// Schreibt geänderte Werte sofort, z.B. vor ESP.restart()
+void settings_flush();
+
+// Anzahl der NVS-Schreibzugriffe (geschriebene Schlüssel) seit dem Start
+uint32_t settings_flash_writes();
+
+// --- Typisierte Zugriffe; Setter markieren nur bei echter Änderung ---
+
+uint32_t settings_mode();
+void settings_set_mode(uint32_t mode);
+
+// Lautstärke in Schritten des TAS5805M
+int settings_volume();
+void settings_set_volume(int volume);
+
+// Zuletzt gespielter Sender; leer, wenn noch keiner gespeichert ist
+String settings_radio_url();
+void settings_set_radio_url(const char* url);
+
+// MAC-Adresse des zuletzt verbundenen Bluetooth-Geräts ("ab:cd:ef:12:34:56") oder leer
+String settings_bt_addr();
+void settings_set_bt_addr(const char* addr);
+
+// false, wenn keine EQ-Bänder gespeichert sind
+bool settings_eq_bands(EQBand* bands);
+void settings_set_eq_bands(const EQBand* bands);
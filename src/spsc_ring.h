@@ -0,0 +1,113 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+
+// Ringpuffer für genau einen Schreiber und einen Leser (z.B. Netzwerk-Task -> Decoder-Task).
+// Bewusst ohne Arduino-Abhängigkeiten, damit er sich auch auf dem Host übersetzen und prüfen lässt.
+
+/**
+ * @brief Lock-freier SPSC-Bytering über fremdem Speicher (z.B. PSRAM).
+ *
+ * Ein Byte bleibt immer frei, damit "voll" und "leer" unterscheidbar sind, ohne einen
+ * gemeinsamen Zähler zu brauchen. Der Schreiber ändert nur _head, der Leser nur _tail;
+ * Release/Acquire sorgt dafür, dass die Daten sichtbar sind, bevor der Index es ist.
+ *
+ * Für Zero-Copy liefern writeSpan()/readSpan() den zusammenhängenden Bereich bis zum
+ * Pufferende; produce()/consume() geben ihn danach frei. So schreibt der Netzwerk-Task
+ * direkt in den Ring und der Decoder liest direkt aus ihm in seinen Eingangspuffer.
+ */
+class SpscRing {
+public:
+    void init(uint8_t* mem, size_t size) {
+        _buf = mem;
+        _size = size;
+        _head.store(0, std::memory_order_relaxed);
+        _tail.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return _size ? _size - 1 : 0; }
+
+    // Belegte Bytes. Vom Leser gesehen eine untere, vom Schreiber eine obere Schranke.
+    size_t fill() const {
+        size_t h = _head.load(std::memory_order_acquire);
+        size_t t = _tail.load(std::memory_order_acquire);
+        return (h >= t) ? h - t : _size - t + h;
+    }
+
+    size_t space() const { return capacity() - fill(); }
+
+    // --- Schreiber ---
+
+    // Zusammenhängender freier Bereich ab dem Schreibindex
+    size_t writeSpan(uint8_t** ptr) const {
+        size_t h = _head.load(std::memory_order_relaxed);
+        size_t t = _tail.load(std::memory_order_acquire);
+        size_t n = (t > h) ? t - h - 1 : _size - h - (t == 0 ? 1 : 0);
+        *ptr = _buf + h;
+        return n;
+    }
+
+    void produce(size_t n) {
+        size_t h = _head.load(std::memory_order_relaxed) + n;
+        if (h >= _size) h -= _size;
+        _head.store(h, std::memory_order_release);
+    }
+
+    size_t write(const uint8_t* src, size_t len) {
+        size_t done = 0;
+        while (done < len) {
+            uint8_t* p;
+            size_t n = writeSpan(&p);
+            if (n == 0) break;
+            if (n > len - done) n = len - done;
+            memcpy(p, src + done, n);
+            produce(n);
+            done += n;
+        }
+        return done;
+    }
+
+    // --- Leser ---
+
+    // Zusammenhängender belegter Bereich ab dem Leseindex
+    size_t readSpan(const uint8_t** ptr) const {
+        size_t t = _tail.load(std::memory_order_relaxed);
+        size_t h = _head.load(std::memory_order_acquire);
+        size_t n = (h >= t) ? h - t : _size - t;
+        *ptr = _buf + t;
+        return n;
+    }
+
+    void consume(size_t n) {
+        size_t t = _tail.load(std::memory_order_relaxed) + n;
+        if (t >= _size) t -= _size;
+        _tail.store(t, std::memory_order_release);
+    }
+
+    size_t read(uint8_t* dst, size_t len) {
+        size_t done = 0;
+        while (done < len) {
+            const uint8_t* p;
+            size_t n = readSpan(&p);
+            if (n == 0) break;
+            if (n > len - done) n = len - done;
+            memcpy(dst + done, p, n);
+            consume(n);
+            done += n;
+        }
+        return done;
+    }
+
+    // Verwirft alles, was bisher geschrieben wurde (Leserseite)
+    void clear() {
+        _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    uint8_t* _buf = nullptr;
+    size_t _size = 0;
+    std::atomic<size_t> _head{0}; // nur vom Schreiber geändert
+    std::atomic<size_t> _tail{0}; // nur vom Leser geändert
+};
@@ -0,0 +1,61 @@
+#include <Arduino.h>
+#include <Preferences.h>
+
+#include "station_cache.h"
+
+// Eigene Instanz statt der des Einstellungsspeichers: wird aus dem Netzwerk-Task benutzt,
+// während der UI-Thread gerade Einstellungen schreiben kann
+static Preferences cache_prefs;
+
+// Netzwerk-Task und Vorab-Auflösung der Senderliste greifen gleichzeitig zu
+static SemaphoreHandle_t cache_lock() {
+    static SemaphoreHandle_t lock = xSemaphoreCreateMutex();
+    return lock;
+}
+
+struct CacheGuard {
+    CacheGuard() { xSemaphoreTake(cache_lock(), portMAX_DELAY); }
+    ~CacheGuard() { xSemaphoreGive(cache_lock()); }
+};
+
+// NVS-Schlüssel sind auf 15 Zeichen begrenzt, daher "s" + FNV-1a-Hash der URL
+static void cache_key(const char* url, char* key) {
+    uint32_t h = 2166136261u;
+    while (*url) {
+        h ^= (uint8_t)*url++;
+        h *= 16777619u;
+    }
+    snprintf(key, 10, "s%08x", (unsigned)h);
+}
+
+static bool load_locked(const char* url, StationInfo& info) {
+    char key[10];
+    cache_key(url, key);
+    cache_prefs.begin("station_cache", true);
+    bool found = cache_prefs.getBytesLength(key) == sizeof(StationInfo) &&
+                 cache_prefs.getBytes(key, &info, sizeof(StationInfo)) == sizeof(StationInfo);
+    cache_prefs.end();
+    // Abschluss erzwingen, falls der Eintrag beschädigt ist
+    info.url[STATION_URL_MAX - 1] = '\0';
+    info.content_type[sizeof(info.content_type) - 1] = '\0';
+    return found && info.url[0] != '\0';
+}
+
+bool station_cache_load(const char* url, StationInfo& info) {
+    CacheGuard g;
+    return load_locked(url, info);
+}
+
+void station_cache_store(const char* url, const StationInfo& info) {
+    CacheGuard g;
+    char key[10];
+    cache_key(url, key);
+    // Nur bei Änderungen schreiben, um den Flash zu schonen
+    StationInfo old;
+    if (load_locked(url, old) && memcmp(&old, &info, sizeof(StationInfo)) == 0) {
+        return;
+    }
+    cache_prefs.begin("station_cache", false);
+    cache_prefs.putBytes(key, &info, sizeof(StationInfo));
+    cache_prefs.end();
+}
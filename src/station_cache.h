@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+#include "http_stream.h"
+
+// StationInfo (siehe http_stream.h) liegt pro Sender im NVS (Namensraum "station_cache"),
+// Schlüssel ist ein Hash der Preset-URL. Die Cache-Funktionen sind threadsicher.
+
+// Gespeicherte Daten für die Preset-URL laden; false, wenn es keinen Eintrag gibt
+bool station_cache_load(const char* url, StationInfo& info);
+// Schreibt nur, wenn sich etwas geändert hat
+void station_cache_store(const char* url, const StationInfo& info);
+
+/**
+ * @brief Öffnet den Sender über open(ziel, info) wie AudioFileSourceStation::open(): zuerst das
+ * gemerkte Ziel direkt, ohne die Weiterleitungskette. Ist es veraltet (Fehlerstatus, Verbindung
+ * geschlossen), wird einmal über die Preset-URL neu aufgelöst. Die Header kommen in beiden Fällen
+ * aus der Antwort, aus der danach gelesen wird; der Cache-Eintrag wird damit aktualisiert.
+ * @param fallbacks wird um 1 erhöht, wenn das gemerkte Ziel scheiterte (optional)
+ * @return false, wenn auch die Preset-URL nicht geöffnet werden konnte
+ */
+template <class Open>
+bool station_open(const char* url, StationInfo& info, Open open, uint32_t* fallbacks = nullptr) {
+    bool cached = station_cache_load(url, info);
+    if (cached && open(info.url, info)) {
+        station_cache_store(url, info);
+        return true;
+    }
+    if (cached) {
+        Serial.printf("Gemerktes Ziel nicht erreichbar, folge wieder %s\n", url);
+        if (fallbacks) (*fallbacks)++;
+    }
+
+    // Voller Weg: Weiterleitungen folgen und das Ziel für den nächsten Start merken
+    if (open(url, info)) {
+        station_cache_store(url, info);
+        return true;
+    }
+    return false;
+}
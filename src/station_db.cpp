@@ -0,0 +1,206 @@
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#include "station_db.h"
+#include "station_cache.h"
+#include "station_source.h"
+#include "stream_format.h"
+
+#define STATION_DB_MAGIC 0x42445453  // "STDB"
+#define STATION_DB_VERSION 1
+
+// Vorab-Auflösung: niedrige Priorität neben dem Netzwerk-Task auf Kern 0
+#define STATION_PREPARE_CORE 0
+#define STATION_PREPARE_PRIORITY 1
+#define STATION_PREPARE_STACK 6144
+
+// Eingebaute Senderliste, falls im LittleFS keine liegt
+static const char DEFAULT_STATIONS[] =
+    "#EXTM3U\n"
+    "#EXTINF:-1,Deutschlandfunk\n"
+    "http://st01.dlf.de/dlf/01/128/mp3/stream.mp3\n"
+    "#EXTINF:-1 button=\"2\",Deutschlandfunk Nova\n"
+    "http://st03.dlf.de/dlf/03/128/mp3/stream.mp3\n"
+    "#EXTINF:-1 button=\"3\",radioeins\n"
+    "http://www.radioeins.de/livemp3\n";
+
+// Aufbau der Datei: Kopf, 'count' Einträge, Stringtabelle (nullterminiert)
+struct StationDbHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t source_hash;  // FNV-1a der Quelle, zum Erkennen von Änderungen
+    uint32_t strings;      // Größe der Stringtabelle
+};
+
+struct StationDbEntry {
+    uint16_t name;  // Offsets in die Stringtabelle
+    uint16_t url;
+    uint8_t button;
+    uint8_t reserved;
+};
+
+namespace {
+// Ganze Datei im RAM; nach dem Laden nur noch gelesen
+uint8_t* db = nullptr;
+const StationDbHeader* header = nullptr;
+const StationDbEntry* entries = nullptr;
+const char* strings = nullptr;
+bool prepare_started = false;
+
+uint32_t fnv1a(const char* data, size_t len) {
+    uint32_t h = 2166136261u;
+    while (len--) {
+        h ^= (uint8_t)*data++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+bool attach(uint8_t* mem, size_t size, uint32_t source_hash) {
+    const StationDbHeader* h = (const StationDbHeader*)mem;
+    if (size < sizeof(*h) || h->magic != STATION_DB_MAGIC || h->version != STATION_DB_VERSION ||
+        h->source_hash != source_hash ||
+        size != sizeof(*h) + h->count * sizeof(StationDbEntry) + h->strings) {
+        return false;
+    }
+    db = mem;
+    header = h;
+    entries = (const StationDbEntry*)(mem + sizeof(*h));
+    strings = (const char*)(entries + h->count);
+    return true;
+}
+
+// Baut den Index aus dem M3U-Text; Stringtabelle mit Namen und URLs
+uint8_t* build(const char* text, size_t len, uint32_t source_hash, size_t& size) {
+    PlaylistReader reader(text, len);
+    PlaylistEntry e;
+    uint16_t count = 0;
+    size_t strings_len = 0;
+    while (count < STATION_DB_MAX && reader.next(e)) {
+        count++;
+        strings_len += strlen(e.title) + 1 + strlen(e.url) + 1;
+    }
+    size = sizeof(StationDbHeader) + count * sizeof(StationDbEntry) + strings_len;
+    uint8_t* mem = (uint8_t*)malloc(size);
+    if (!mem) return nullptr;
+
+    StationDbHeader* h = (StationDbHeader*)mem;
+    h->magic = STATION_DB_MAGIC;
+    h->version = STATION_DB_VERSION;
+    h->count = count;
+    h->source_hash = source_hash;
+    h->strings = strings_len;
+    StationDbEntry* out = (StationDbEntry*)(mem + sizeof(*h));
+    char* str = (char*)(out + count);
+    size_t pos = 0;
+
+    PlaylistReader again(text, len);
+    for (uint16_t i = 0; i < count && again.next(e); i++) {
+        out[i].name = pos;
+        pos += strlcpy(str + pos, e.title, strings_len - pos) + 1;
+        out[i].url = pos;
+        pos += strlcpy(str + pos, e.url, strings_len - pos) + 1;
+        out[i].button = e.button;
+        out[i].reserved = 0;
+    }
+    return mem;
+}
+
+String read_file(const char* path) {
+    File f = LittleFS.open(path, "r");
+    if (!f) return String();
+    String text = f.readString();
+    f.close();
+    return text;
+}
+}
+
+void station_db_load() {
+    if (db) return;
+    uint32_t start = millis();
+
+    bool fs = LittleFS.begin(false);
+    String source = fs ? read_file(STATION_DB_SOURCE) : String();
+    const char* text = source.length() ? source.c_str() : DEFAULT_STATIONS;
+    size_t len = source.length() ? source.length() : strlen(DEFAULT_STATIONS);
+    uint32_t hash = fnv1a(text, len);
+
+    // Schneller Weg: Index passt zur Quelle
+    if (fs) {
+        File f = LittleFS.open(STATION_DB_FILE, "r");
+        if (f) {
+            size_t size = f.size();
+            uint8_t* mem = (uint8_t*)malloc(size);
+            if (mem && f.read(mem, size) == size && attach(mem, size, hash)) {
+                f.close();
+                Serial.printf("Senderliste: %u Sender aus %s (%u ms)\n", header->count, STATION_DB_FILE, millis() - start);
+                return;
+            }
+            free(mem);
+            f.close();
+        }
+    }
+
+    size_t size;
+    uint8_t* mem = build(text, len, hash, size);
+    if (!mem || !attach(mem, size, hash)) {
+        free(mem);
+        Serial.println("Senderliste konnte nicht angelegt werden!");
+        return;
+    }
+    if (fs) {
+        File f = LittleFS.open(STATION_DB_FILE, "w");
+        if (f) {
+            f.write(mem, size);
+            f.close();
+        }
+    }
+    Serial.printf("Senderliste: %u Sender aus %s neu indiziert (%u Bytes, %u ms)\n", header->count,
+                  source.length() ? STATION_DB_SOURCE : "eingebauter Liste", size, millis() - start);
+}
+
+uint8_t station_db_count() {
+    return header ? header->count : 0;
+}
+
+const char* station_db_name(uint8_t index) {
+    return index < station_db_count() ? strings + entries[index].name : "";
+}
+
+const char* station_db_url(uint8_t index) {
+    return index < station_db_count() ? strings + entries[index].url : "";
+}
+
+const char* station_db_favorite(uint8_t button) {
+    for (uint8_t i = 0; i < station_db_count(); i++) {
+        if (entries[i].button == button) return station_db_url(i);
+    }
+    // Ohne Zuordnung wie die alte feste Liste: Taste N spielt den N-ten Sender
+    uint8_t index = button - 1;
+    return button >= 1 && index < station_db_count() ? station_db_url(index) : nullptr;
+}
+
+static void prepare_task(void* arg) {
+    uint8_t resolved = 0;
+    StationInfo info;
+    for (uint8_t i = 0; i < station_db_count(); i++) {
+        const char* url = station_db_url(i);
+        if (station_cache_load(url, info)) continue;
+        if (station_resolve(url, info)) {
+            station_cache_store(url, info);
+            Serial.printf("Sender vorbereitet: %s -> %s (%s, %s)\n", station_db_name(i), info.url,
+                          info.content_type, stream_codec(info.content_type, info.url) == CODEC_AAC ? "AAC" : "MP3");
+            resolved++;
+        }
+    }
+    Serial.printf("Senderliste vorbereitet, %u neu aufgelöst.\n", resolved);
+    vTaskDelete(nullptr);
+}
+
+void station_db_prepare() {
+    if (prepare_started || station_db_count() == 0) return;
+    prepare_started = true;
+    xTaskCreatePinnedToCore(prepare_task, "stations", STATION_PREPARE_STACK, nullptr,
+                            STATION_PREPARE_PRIORITY, nullptr, STATION_PREPARE_CORE);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <Arduino.h>
+
+// Quelle der Senderliste im LittleFS (aus data/ per "pio run -t uploadfs"); fehlt sie, gilt die eingebaute Liste
+#define STATION_DB_SOURCE "/stations.m3u"
+// Daraus erzeugter Binärindex, wird nur neu gebaut, wenn sich die Quelle ändert
+#define STATION_DB_FILE "/stations.db"
+#ifndef STATION_DB_MAX
+#define STATION_DB_MAX 64
+#endif
+
+/**
+ * @brief Senderliste: LittleFS-Datei im M3U-Format mit Namen (#EXTINF) und Tasten-Zuordnung
+ * (Attribut button="2"), daneben ein kompakter Binärindex (Kopf, Einträge mit Offsets,
+ * Stringtabelle), der beim Start in einem Stück gelesen wird. Die Einträge dürfen selbst
+ * M3U/PLS-Playlists sein; station_db_prepare() löst sie vorab auf (siehe station_resolve()).
+ * Nach station_db_load() unveränderlich und damit aus allen Tasks lesbar.
+ */
+void station_db_load();
+
+uint8_t station_db_count();
+const char* station_db_name(uint8_t index);
+const char* station_db_url(uint8_t index);
+
+/**
+ * @brief URL für eine Taste der Leiter (2..3): der Sender mit button="N", sonst wie bisher der
+ * N-te Eintrag (Taste 2 -> zweiter Sender). nullptr, wenn es keinen gibt.
+ */
+const char* station_db_favorite(uint8_t button);
+
+/**
+ * @brief Startet einmal pro Boot einen Hintergrund-Task, der alle noch nicht im Sender-Cache
+ * bekannten Sender auflöst (Playlists, Weiterleitungen, Content-Type). Danach stehen Ziel-URL
+ * und Decoder schon vor dem ersten Abspielen fest. Nur mit WLAN aufrufen.
+ */
+void station_db_prepare();
@@ -0,0 +1,75 @@
+#include "station_source.h"
+
+// Wie lange read() höchstens wartet, bis 'len' Bytes da sind
+#define STATION_READ_TIMEOUT_MS 1000
+
+bool WiFiStreamTransport::connect(const char* host, uint16_t port, uint32_t timeout_ms) {
+    _client.stop();
+    return _client.connect(host, port, (int32_t)timeout_ms) == 1;
+}
+
+bool WiFiStreamTransport::send(const char* data, size_t len) {
+    return _client.write((const uint8_t*)data, len) == len;
+}
+
+int32_t WiFiStreamTransport::receive(uint8_t* dst, size_t len) {
+    int avail = _client.available();
+    if (avail <= 0) return _client.connected() ? 0 : -1;
+    if ((size_t)avail < len) len = (size_t)avail;
+    int got = _client.read(dst, len);
+    return got > 0 ? got : 0;
+}
+
+bool AudioFileSourceStation::open(const char* url) {
+    StationInfo info;
+    return open(url, info);
+}
+
+bool AudioFileSourceStation::open(const char* url, StationInfo& info) {
+    _pos = 0;
+    return _http.open(url, info);
+}
+
+uint32_t AudioFileSourceStation::read(void* data, uint32_t len) {
+    uint8_t* dst = (uint8_t*)data;
+    uint32_t done = 0;
+    uint32_t start = millis();
+    while (done < len && _http.isOpen() && millis() - start < STATION_READ_TIMEOUT_MS) {
+        int32_t got = _http.read(dst + done, len - done);
+        if (got > 0) done += got;
+        else delay(5);
+    }
+    _pos += done;
+    return done;
+}
+
+uint32_t AudioFileSourceStation::readNonBlock(void* data, uint32_t len) {
+    int32_t got = _http.read((uint8_t*)data, len);
+    if (got <= 0) return 0;
+    _pos += got;
+    return got;
+}
+
+bool AudioFileSourceStation::seek(int32_t pos, int dir) {
+    (void)pos;
+    (void)dir;
+    return false;
+}
+
+bool AudioFileSourceStation::close() {
+    _http.close();
+    return true;
+}
+
+bool AudioFileSourceStation::isOpen() {
+    return _http.isOpen();
+}
+
+bool station_resolve(const char* url, StationInfo& info) {
+    WiFiStreamTransport net;
+    HttpStream http(net);
+    bool ok = http.open(url, info);
+    http.close();
+    if (ok && strcmp(url, info.url) != 0) Serial.printf("Sender %s -> %s\n", url, info.url);
+    return ok;
+}
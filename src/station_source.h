@@ -0,0 +1,56 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+#include "AudioFileSource.h"
+#include "http_stream.h"
+
+/**
+ * @brief StreamTransport über einen WiFiClient.
+ */
+class WiFiStreamTransport : public StreamTransport {
+public:
+    bool connect(const char* host, uint16_t port, uint32_t timeout_ms) override;
+    bool send(const char* data, size_t len) override;
+    int32_t receive(uint8_t* dst, size_t len) override;
+    void close() override { _client.stop(); }
+    uint32_t millis() override { return ::millis(); }
+    void idle() override { delay(5); }
+
+private:
+    WiFiClient _client;
+};
+
+/**
+ * @brief Stream-Quelle eines Senders, ersetzt AudioFileSourceICYStream.
+ * open(url, info) folgt Weiterleitungen und Playlists (siehe HttpStream) und liefert die Header des
+ * Ziels; gelesen wird danach aus derselben Verbindung. Der Sender-Cache bekommt seine Daten also
+ * ohne eigene Anfrage.
+ */
+class AudioFileSourceStation : public AudioFileSource {
+public:
+    AudioFileSourceStation() : _http(_net) {}
+
+    virtual bool open(const char* url) override;
+    bool open(const char* url, StationInfo& info);
+
+    virtual uint32_t read(void* data, uint32_t len) override;
+    virtual uint32_t readNonBlock(void* data, uint32_t len) override;
+    virtual bool seek(int32_t pos, int dir) override;
+    virtual bool close() override;
+    virtual bool isOpen() override;
+    virtual uint32_t getSize() override { return 0; }
+    virtual uint32_t getPos() override { return _pos; }
+
+private:
+    WiFiStreamTransport _net;
+    HttpStream _http;
+    uint32_t _pos = 0;
+};
+
+/**
+ * @brief Folgt Weiterleitungen und M3U/PLS-Playlists der URL bis zum Stream, liest dessen Header
+ * und schließt die Verbindung wieder (siehe HttpStream). Für Sender, die nicht gerade spielen;
+ * beim Abspielen liefert AudioFileSourceStation::open() dieselben Daten aus der Stream-Antwort.
+ * Blockiert für die Dauer der Anfragen, nur aus Netzwerk-Tasks aufrufen. Bei Fehlern false.
+ */
+bool station_resolve(const char* url, StationInfo& info);
@@ -0,0 +1,58 @@
+#include "stream_fault.h"
+
+// Vorrat des Token-Buckets: mindestens so viele ms, sonst die längste Jitter-Pause
+#define FAULT_BUCKET_MIN_MS 100
+
+void StreamFaultInjector::begin(uint32_t now_ms) {
+    _lastRefill = now_ms;
+    _tokens = 0;
+    _stallUntil = now_ms;
+    _jitterUntil = now_ms;
+    _nextStall = now_ms + _config.stall_every_s * 1000;
+    _nextDisconnect = now_ms + _config.disconnect_every_s * 1000;
+}
+
+uint32_t StreamFaultInjector::allow(uint32_t now_ms, uint32_t want, bool& disconnect) {
+    disconnect = false;
+    if (_config.disconnect_every_s > 0 && (int32_t)(now_ms - _nextDisconnect) >= 0) {
+        disconnect = true;
+        return 0;
+    }
+    if (_config.stall_every_s > 0 && (int32_t)(now_ms - _nextStall) >= 0) {
+        _stallUntil = now_ms + _config.stall_ms;
+        _nextStall += _config.stall_every_s * 1000;
+    }
+    if ((int32_t)(now_ms - _stallUntil) < 0) {
+        _lastRefill = now_ms;  // während eines Stalls sammelt sich keine Bandbreite an
+        return 0;
+    }
+
+    if (_config.bandwidth_kbps > 0) {
+        // Bytes pro ms bei der eingestellten Bandbreite: kbit/s / 8
+        uint32_t per_ms = _config.bandwidth_kbps / 8;
+        uint32_t bucket_ms = _config.jitter_ms > FAULT_BUCKET_MIN_MS ? _config.jitter_ms : FAULT_BUCKET_MIN_MS;
+        _tokens += (now_ms - _lastRefill) * per_ms;
+        _lastRefill = now_ms;
+        if (_tokens > per_ms * bucket_ms) _tokens = per_ms * bucket_ms;
+    }
+    if ((int32_t)(now_ms - _jitterUntil) < 0) return 0;
+    if (_config.bandwidth_kbps == 0) return want;
+    return want < _tokens ? want : _tokens;
+}
+
+void StreamFaultInjector::consumed(uint32_t now_ms, uint32_t bytes) {
+    _tokens = bytes < _tokens ? _tokens - bytes : 0;
+    if (_config.jitter_ms > 0) {
+        _jitterUntil = now_ms + random() % (_config.jitter_ms + 1);
+    }
+}
+
+uint32_t StreamFaultInjector::random() {
+    // xorshift32 wie in ReconnectPolicy
+    uint32_t x = _rand;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    _rand = x;
+    return x;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <stdint.h>
+
+// Simuliertes schlechtes Netz für den Stream-Reader (nur mit -D STREAM_FAULT_INJECTION aktiv).
+// Ohne Arduino-Abhängigkeiten: Zeit und Zufall kommen von außen, Läufe sind mit gleichem Seed
+// reproduzierbar. Alle Werte 0 = diese Störung aus.
+
+// Bandbreite der Verbindung in kbit/s
+#ifndef STREAM_FAULT_BANDWIDTH_KBPS
+#define STREAM_FAULT_BANDWIDTH_KBPS 0
+#endif
+// Nach jedem gelesenen Häppchen zufällige Pause von 0 bis zu so vielen ms
+#ifndef STREAM_FAULT_JITTER_MS
+#define STREAM_FAULT_JITTER_MS 0
+#endif
+// Alle STREAM_FAULT_STALL_EVERY_S Sekunden kommen STREAM_FAULT_STALL_MS lang keine Daten
+// (ab STREAM_STALL_TIMEOUT_MS gilt die Verbindung als tot)
+#ifndef STREAM_FAULT_STALL_EVERY_S
+#define STREAM_FAULT_STALL_EVERY_S 0
+#endif
+#ifndef STREAM_FAULT_STALL_MS
+#define STREAM_FAULT_STALL_MS 3000
+#endif
+// Alle so vielen Sekunden wird die Verbindung gekappt
+#ifndef STREAM_FAULT_DISCONNECT_EVERY_S
+#define STREAM_FAULT_DISCONNECT_EVERY_S 0
+#endif
+
+// Eingestellte Störungen; die Vorgaben kommen aus den Build-Flags. Host-Tests und der
+// Test-Server (test/mocks/icy_server.h) setzen sie je Lauf.
+struct StreamFaultConfig {
+    uint32_t bandwidth_kbps = STREAM_FAULT_BANDWIDTH_KBPS;
+    uint32_t jitter_ms = STREAM_FAULT_JITTER_MS;
+    uint32_t stall_every_s = STREAM_FAULT_STALL_EVERY_S;
+    uint32_t stall_ms = STREAM_FAULT_STALL_MS;
+    uint32_t disconnect_every_s = STREAM_FAULT_DISCONNECT_EVERY_S;
+};
+
+/**
+ * @brief Entscheidet vor jedem Lesen aus der Quelle, wie viele Bytes gerade "ankommen".
+ * Die Bandbreite wird über einen Token-Bucket begrenzt. Jitter verzögert nur, die Bandbreite
+ * sammelt sich währenddessen an; ein Stall dagegen liefert wirklich nichts.
+ */
+class StreamFaultInjector {
+public:
+    explicit StreamFaultInjector(uint32_t seed = 1, const StreamFaultConfig& config = StreamFaultConfig())
+        : _config(config), _rand(seed ? seed : 1) {}
+
+    const StreamFaultConfig& config() const { return _config; }
+
+    // Verbindung (neu) aufgebaut: Zeitpläne für Stalls und Abbrüche beginnen von vorn
+    void begin(uint32_t now_ms);
+    // Höchstens so viele Bytes jetzt lesen (0 = warten); disconnect = Verbindung jetzt kappen
+    uint32_t allow(uint32_t now_ms, uint32_t want, bool& disconnect);
+    // Tatsächlich gelesene Bytes verbuchen
+    void consumed(uint32_t now_ms, uint32_t bytes);
+
+private:
+    StreamFaultConfig _config;
+    uint32_t _rand;
+    uint32_t _lastRefill = 0;
+    uint32_t _tokens = 0;
+    uint32_t _stallUntil = 0;
+    uint32_t _jitterUntil = 0;
+    uint32_t _nextStall = 0;
+    uint32_t _nextDisconnect = 0;
+
+    uint32_t random();
+};
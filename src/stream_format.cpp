@@ -0,0 +1,193 @@
+#include <string.h>
+#include <ctype.h>
+#include "stream_format.h"
+
+// Groß-/Kleinschreibung ignorierender Präfixvergleich
+static bool starts_with(const char* s, size_t len, const char* prefix) {
+    size_t n = strlen(prefix);
+    if (len < n) return false;
+    for (size_t i = 0; i < n; i++) {
+        if (tolower((unsigned char)s[i]) != prefix[i]) return false;
+    }
+    return true;
+}
+
+// Content-Type ohne Parameter ("audio/aacp; charset=..." -> "audio/aacp") mit einer Liste vergleichen
+static bool type_is(const char* content_type, const char* const* types) {
+    if (!content_type) return false;
+    while (*content_type == ' ') content_type++;
+    size_t len = strcspn(content_type, "; ");
+    for (; *types; types++) {
+        if (len == strlen(*types) && starts_with(content_type, len, *types)) return true;
+    }
+    return false;
+}
+
+// Endung des URL-Pfads (ohne Query und Fragment) vergleichen
+static bool url_ends_with(const char* url, const char* ext) {
+    if (!url) return false;
+    size_t len = strcspn(url, "?#");
+    size_t n = strlen(ext);
+    return len >= n && starts_with(url + len - n, n, ext);
+}
+
+static const char* const MP3_TYPES[] = { "audio/mpeg", "audio/mp3", "audio/mpeg3", "audio/x-mpeg", nullptr };
+static const char* const AAC_TYPES[] = { "audio/aac", "audio/aacp", "audio/x-aac", "audio/x-aacp", "audio/adts", nullptr };
+static const char* const M3U_TYPES[] = { "audio/x-mpegurl", "audio/mpegurl", "application/x-mpegurl",
+                                         "application/vnd.apple.mpegurl", nullptr };
+static const char* const PLS_TYPES[] = { "audio/x-scpls", "audio/scpls", "application/pls+xml", nullptr };
+
+StreamCodec stream_codec(const char* content_type, const char* url) {
+    if (type_is(content_type, AAC_TYPES)) return CODEC_AAC;
+    if (type_is(content_type, MP3_TYPES)) return CODEC_MP3;
+    if (url_ends_with(url, ".aac") || url_ends_with(url, ".aacp")) return CODEC_AAC;
+    return CODEC_MP3;
+}
+
+PlaylistFormat playlist_format(const char* url, const char* content_type) {
+    if (type_is(content_type, M3U_TYPES)) return PLAYLIST_M3U;
+    if (type_is(content_type, PLS_TYPES)) return PLAYLIST_PLS;
+    if (type_is(content_type, MP3_TYPES) || type_is(content_type, AAC_TYPES)) return PLAYLIST_NONE;
+    if (url_ends_with(url, ".m3u") || url_ends_with(url, ".m3u8")) return PLAYLIST_M3U;
+    if (url_ends_with(url, ".pls")) return PLAYLIST_PLS;
+    return PLAYLIST_NONE;
+}
+
+PlaylistReader::PlaylistReader(const char* text, size_t len) : _text(text), _len(len) {
+    // UTF-8-BOM überspringen
+    if (_len >= 3 && memcmp(_text, "\xEF\xBB\xBF", 3) == 0) _pos = 3;
+
+    size_t start, n;
+    size_t first = _pos;
+    _format = PLAYLIST_M3U;
+    while (line(start, n)) {
+        if (n == 0) continue;
+        if (starts_with(_text + start, n, "[playlist]")) _format = PLAYLIST_PLS;
+        break;
+    }
+    // HLS verweist auf Segmente, nicht auf einen durchgehenden Stream
+    for (size_t i = first; _format == PLAYLIST_M3U && i + 7 <= _len; i++) {
+        if (memcmp(_text + i, "#EXT-X-", 7) == 0) _format = PLAYLIST_NONE;
+    }
+    _pos = first;
+}
+
+bool PlaylistReader::line(size_t& start, size_t& len) {
+    if (_pos >= _len) return false;
+    size_t end = _pos;
+    while (end < _len && _text[end] != '\n' && _text[end] != '\r') end++;
+    start = _pos;
+    len = end - _pos;
+    _pos = end;
+    while (_pos < _len && (_text[_pos] == '\n' || _text[_pos] == '\r')) _pos++;
+    while (len > 0 && isspace((unsigned char)_text[start])) { start++; len--; }
+    while (len > 0 && isspace((unsigned char)_text[start + len - 1])) len--;
+    return true;
+}
+
+static void copy_field(char* dst, size_t max, const char* src, size_t len) {
+    if (len >= max) len = max - 1;
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+// Dezimalzahl am Anfang von s, höchstens len Zeichen weit (der Puffer endet nicht mit '\0');
+// zu große Werte bleiben bei UINT32_MAX stehen. Liefert die Anzahl der Ziffern, 0 = keine Zahl.
+static size_t parse_number(const char* s, size_t len, uint32_t& value) {
+    size_t n = 0;
+    value = 0;
+    while (n < len && s[n] >= '0' && s[n] <= '9') {
+        uint32_t digit = (uint32_t)(s[n] - '0');
+        value = value > (UINT32_MAX - digit) / 10 ? UINT32_MAX : value * 10 + digit;
+        n++;
+    }
+    return n;
+}
+
+static bool is_url(const char* s, size_t len) {
+    for (size_t i = 0; i + 3 <= len; i++) {
+        if (memcmp(s + i, "://", 3) == 0) return i > 0;
+    }
+    return false;
+}
+
+bool PlaylistReader::next(PlaylistEntry& entry) {
+    if (_format == PLAYLIST_PLS) return nextPls(entry);
+    if (_format == PLAYLIST_M3U) return nextM3u(entry);
+    return false;
+}
+
+bool PlaylistReader::nextM3u(PlaylistEntry& entry) {
+    entry.title[0] = '\0';
+    entry.button = 0;
+    size_t start, len;
+    while (line(start, len)) {
+        const char* s = _text + start;
+        if (starts_with(s, len, "#extinf:")) {
+            // #EXTINF:-1 button="2",Titel -- der Titel folgt auf das erste Komma außerhalb von Anführungszeichen
+            bool quoted = false;
+            size_t comma = len;
+            for (size_t i = 8; i < len; i++) {
+                if (s[i] == '"') quoted = !quoted;
+                else if (s[i] == ',' && !quoted) { comma = i; break; }
+            }
+            if (comma < len) copy_field(entry.title, sizeof(entry.title), s + comma + 1, len - comma - 1);
+            for (size_t i = 8; i + 8 < comma; i++) {
+                if (starts_with(s + i, comma - i, "button=\"")) {
+                    uint32_t button;
+                    if (parse_number(s + i + 8, comma - i - 8, button) && button <= UINT8_MAX) {
+                        entry.button = (uint8_t)button;
+                    }
+                    break;
+                }
+            }
+            continue;
+        }
+        if (len == 0 || s[0] == '#') continue;
+        if (is_url(s, len) && len < sizeof(entry.url)) {
+            copy_field(entry.url, sizeof(entry.url), s, len);
+            return true;
+        }
+        // Ungültige Zeile: die Angaben aus #EXTINF gehören zu ihr und verfallen
+        entry.title[0] = '\0';
+        entry.button = 0;
+    }
+    return false;
+}
+
+bool PlaylistReader::nextPls(PlaylistEntry& entry) {
+    size_t start, len;
+    while (line(start, len)) {
+        const char* s = _text + start;
+        if (!starts_with(s, len, "file")) continue;
+        uint32_t index;
+        size_t digits = parse_number(s + 4, len - 4, index);
+        size_t key = 4 + digits;
+        if (digits == 0 || key >= len || s[key] != '=') continue;
+        const char* url = s + key + 1;
+        size_t url_len = len - key - 1;
+        if (!is_url(url, url_len) || url_len >= sizeof(entry.url)) continue;
+        copy_field(entry.url, sizeof(entry.url), url, url_len);
+        entry.button = 0;
+        entry.title[0] = '\0';
+
+        // Der passende TitleN darf irgendwo in der Datei stehen
+        size_t saved = _pos;
+        _pos = 0;
+        size_t ts, tl;
+        while (line(ts, tl)) {
+            const char* t = _text + ts;
+            if (!starts_with(t, tl, "title")) continue;
+            uint32_t ti;
+            size_t tdigits = parse_number(t + 5, tl - 5, ti);
+            size_t tk = 5 + tdigits;
+            if (tdigits > 0 && ti == index && tk < tl && t[tk] == '=') {
+                copy_field(entry.title, sizeof(entry.title), t + tk + 1, tl - tk - 1);
+                break;
+            }
+        }
+        _pos = saved;
+        return true;
+    }
+    return false;
+}
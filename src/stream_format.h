@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Erkennung von Codec und Playlist-Format sowie das Lesen von M3U/PLS. Ohne Arduino-Abhängigkeiten,
+// damit sich Parser und Auswahl auf dem Host mit Beispiel-Playlists prüfen lassen.
+
+#define PLAYLIST_URL_MAX 256
+#define PLAYLIST_TITLE_MAX 48
+
+enum StreamCodec : uint8_t {
+    CODEC_MP3,
+    CODEC_AAC  // ADTS, auch HE-AAC (SBR)
+};
+
+enum PlaylistFormat : uint8_t {
+    PLAYLIST_NONE,  // kein Playlist-Verweis, sondern der Stream selbst
+    PLAYLIST_M3U,
+    PLAYLIST_PLS
+};
+
+/**
+ * @brief Decoder für einen Stream: zuerst nach Content-Type (z.B. aus dem Sender-Cache),
+ * ohne Content-Type nach der Endung der URL; im Zweifel MP3.
+ */
+StreamCodec stream_codec(const char* content_type, const char* url);
+
+/**
+ * @brief Ist die Antwort eine Playlist statt eines Streams? Ein Audio-Content-Type hat Vorrang
+ * vor der Endung (manche Sender liefern unter ".m3u" direkt den Stream).
+ */
+PlaylistFormat playlist_format(const char* url, const char* content_type);
+
+struct PlaylistEntry {
+    char title[PLAYLIST_TITLE_MAX];  // aus #EXTINF bzw. TitleN, sonst leer
+    char url[PLAYLIST_URL_MAX];
+    uint8_t button;                  // M3U-Attribut button="N" (Taste der Leiter), 0 = keine
+};
+
+/**
+ * @brief Liest die Einträge einer M3U- oder PLS-Datei nacheinander aus einem Puffer.
+ * Das Format wird am Inhalt erkannt ("[playlist]" am Anfang = PLS). Es zählen nur Einträge mit
+ * "://"; zu lange URLs werden übersprungen. HLS-Playlists (#EXT-X-...) enthalten Segmente statt
+ * eines Streams und liefern keine Einträge.
+ */
+class PlaylistReader {
+public:
+    PlaylistReader(const char* text, size_t len);
+
+    bool next(PlaylistEntry& entry);
+    PlaylistFormat format() const { return _format; }
+
+private:
+    const char* _text;
+    size_t _len;
+    size_t _pos = 0;
+    PlaylistFormat _format = PLAYLIST_NONE;
+
+    // Nächste Zeile ohne Zeilenende und umgebende Leerzeichen; false am Ende
+    bool line(size_t& start, size_t& len);
+    bool nextM3u(PlaylistEntry& entry);
+    bool nextPls(PlaylistEntry& entry);
+};
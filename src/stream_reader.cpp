@@ -0,0 +1,54 @@
+#include "stream_reader.h"
+
+void StreamReader::begin(uint32_t now_ms) {
+    _reconnect.trigger(now_ms);
+    _lostAt = now_ms;
+    _lastData = now_ms;
+    _reconnectMs = 0;
+}
+
+StreamReader::Step StreamReader::connect() {
+    if (!_reconnect.due(_source.millis())) return SR_BACKOFF;
+    // Nur die Quelle wird (neu) geöffnet; Ring, Decoder und Ausgabe laufen weiter
+    _source.closeStream();
+    if (!_source.openStream()) {
+        _reconnect.onFailure(_source.millis());
+        return SR_CONNECT_FAILED;
+    }
+    _reconnect.onSuccess();
+    // Die Lücke des Abbruchs ist kein Netz-Jitter und soll die Zieltiefe nicht aufblähen
+    _jitter.onThrottled();
+    _lastData = _source.millis();
+    _reconnectMs = _lastData - _lostAt;
+    return SR_CONNECTED;
+}
+
+StreamReader::Step StreamReader::step() {
+    if (_reconnect.state() != ReconnectPolicy::RC_CONNECTED) return connect();
+
+    uint32_t now = _source.millis();
+    uint8_t* span;
+    size_t n = _ring.writeSpan(&span);
+    if (n == 0 || _ring.fill() >= (size_t)_ring.capacity() * STREAM_HIGH_WATERMARK_PERCENT / 100) {
+        _jitter.onThrottled();
+        _lastData = now;
+        return SR_THROTTLED;
+    }
+    if (n > STREAM_READ_CHUNK) n = STREAM_READ_CHUNK;
+
+    // Direkt in den Ring lesen, ohne Zwischenpuffer
+    int32_t got = _source.readStream(span, n);
+    if (got > 0) {
+        _ring.produce((size_t)got);
+        _lastData = _source.millis();
+        _jitter.onArrival(_lastData, (uint32_t)got);
+        return SR_DATA;
+    }
+    if (got < 0 || now - _lastData > _stallMs) {
+        _source.closeStream();
+        _lostAt = now;
+        _reconnect.onDisconnect(now);
+        return SR_LOST;
+    }
+    return SR_WAITING;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "spsc_ring.h"
+#include "jitter_buffer.h"
+#include "reconnect.h"
+
+// Ein Schritt des Netzwerk-Tasks von AudioFileSourceRing. Ohne Arduino-Abhängigkeiten (Quelle und
+// Zeit kommen von außen), damit der Host-Test denselben Code gegen einen gestörten Server fährt.
+
+// Der Netzwerk-Task liest in Häppchen dieser Größe direkt in den Ring
+#define STREAM_READ_CHUNK 2048
+// Solange der Ring so voll ist, pausiert der Netzwerk-Task
+#define STREAM_HIGH_WATERMARK_PERCENT 95
+// Kommen so lange keine Daten, gilt die Verbindung als tot, auch wenn sie noch offen ist
+#define STREAM_STALL_TIMEOUT_MS 8000
+
+/**
+ * @brief Quelle des Lesers: auf dem ESP32 der HTTP-Stream des Senders (samt Sender-Cache und
+ * simulierten Netzfehlern), auf dem Host HttpStream über einen Socket.
+ */
+class StreamReaderSource {
+public:
+    virtual ~StreamReaderSource() {}
+    // Quelle (neu) öffnen; blockiert für den Verbindungsaufbau
+    virtual bool openStream() = 0;
+    // Nicht blockierend: gelesene Bytes, 0 = gerade nichts da, -1 = Verbindung verloren
+    virtual int32_t readStream(uint8_t* dst, size_t len) = 0;
+    virtual void closeStream() = 0;
+    virtual uint32_t millis() = 0;
+};
+
+/**
+ * @brief Liest die Quelle in den Ring und baut die Verbindung nach Verlust wieder auf.
+ *
+ * Jeder Aufruf von step() macht genau eins: fälligen Verbindungsversuch (ReconnectPolicy), ein
+ * Häppchen direkt in den Ring lesen, oder bei fast vollem Ring drosseln. Kommen länger als das
+ * Stall-Timeout keine Daten oder meldet die Quelle -1, wird sie geschlossen und onDisconnect()
+ * gemeldet. Ankünfte und Lücken gehen an den JitterBuffer. Warten (und Meldungen) überlässt
+ * step() dem Aufrufer, siehe Step.
+ */
+class StreamReader {
+public:
+    enum Step : uint8_t {
+        SR_BACKOFF = 0,     // Versuch noch nicht fällig: etwas warten
+        SR_CONNECTED,       // Quelle geöffnet, reconnectMs() ist gesetzt
+        SR_CONNECT_FAILED,  // nächster Versuch nach backoffMs() der ReconnectPolicy
+        SR_THROTTLED,       // Ring fast voll: warten, bis der Decoder Platz gemacht hat
+        SR_DATA,            // Daten in den Ring geschrieben
+        SR_WAITING,         // gerade nichts da, Verbindung lebt noch: kurz warten
+        SR_LOST             // Verbindung verloren, Neuaufbau läuft über die ReconnectPolicy
+    };
+
+    StreamReader(StreamReaderSource& source, SpscRing& ring, JitterBuffer& jitter,
+                 ReconnectPolicy& reconnect)
+        : _source(source), _ring(ring), _jitter(jitter), _reconnect(reconnect) {}
+
+    // Neuer Sender: sofort verbinden; die Verbindungsdauer zählt ab jetzt
+    void begin(uint32_t now_ms);
+    Step step();
+
+    void setStallTimeout(uint32_t ms) { _stallMs = ms; }
+    // Dauer vom Start bzw. Verbindungsverlust bis zur letzten erfolgreichen Verbindung
+    uint32_t reconnectMs() const { return _reconnectMs; }
+
+private:
+    StreamReaderSource& _source;
+    SpscRing& _ring;
+    JitterBuffer& _jitter;
+    ReconnectPolicy& _reconnect;
+    uint32_t _stallMs = STREAM_STALL_TIMEOUT_MS;
+    uint32_t _lastData = 0;
+    uint32_t _lostAt = 0;
+    uint32_t _reconnectMs = 0;
+
+    Step connect();
+};
@@ -0,0 +1,272 @@
+#include <WiFi.h>
+#include "stream_ring.h"
+#include "station_cache.h"
+#include "boot_timeline.h"
+
+// Netzwerk-Task läuft neben dem WLAN-Stack, der Audio-Task auf Kern 1
+#define STREAM_TASK_CORE 0
+#define STREAM_TASK_PRIORITY 4
+// Verbindungsaufbau mit Weiterleitungen, Header-Zeile und Sender-Cache (NVS) laufen in diesem Task
+#define STREAM_TASK_STACK 6144
+
+AudioFileSourceRing::AudioFileSourceRing(AudioFileSourceStation* source, uint32_t bytes)
+    : _source(source), _reconnect(esp_random()), _reader(*this, _ring, _jitter, _reconnect)
+#ifdef STREAM_FAULT_INJECTION
+    , _fault(esp_random())
+#endif
+{
+    _url[0] = '\0';
+    if (psramFound()) {
+        _mem = (uint8_t*)ps_malloc(bytes);
+    }
+    if (!_mem) {
+        bytes = STREAM_BUFFER_FALLBACK;
+        _mem = (uint8_t*)malloc(bytes);
+        _fallback = true;
+    }
+    if (!_mem) {
+        Serial.println("Stream-Puffer konnte nicht angelegt werden!");
+        _eof = true;
+        return;
+    }
+    _bytes = bytes;
+    _ring.init(_mem, bytes);
+    Serial.printf("Stream-Puffer: %u Bytes im %s\n", bytes, _fallback ? "internen RAM" : "PSRAM");
+
+    // Der Task bleibt bestehen und wartet zwischen zwei Sendern auf _wake
+    _wake = xSemaphoreCreateBinary();
+    _idle = xSemaphoreCreateBinary();
+    xTaskCreatePinnedToCore(readerTask, "stream", STREAM_TASK_STACK, this,
+                            STREAM_TASK_PRIORITY, &_task, STREAM_TASK_CORE);
+}
+
+AudioFileSourceRing::~AudioFileSourceRing() {
+    stop();
+    // Der Task blockiert jetzt auf _wake und kann gefahrlos gelöscht werden
+    if (_task) vTaskDelete(_task);
+    if (_wake) vSemaphoreDelete(_wake);
+    if (_idle) vSemaphoreDelete(_idle);
+    free(_mem);
+}
+
+bool AudioFileSourceRing::start(const char* url, const uint8_t* preroll, uint32_t preroll_len,
+                                uint16_t bitrate_kbps) {
+    if (!_task) return false;
+    stop();
+
+    // Der Netzwerk-Task ruht, Ring und Zustände dürfen von hier aus zurückgesetzt werden
+    _ring.init(_mem, _bytes);
+    if (_history) _history->reset();
+    _jitter.begin((uint32_t)(bitrate_kbps ? bitrate_kbps : STREAM_BITRATE_KBPS) * 1000 / 8, _ring.capacity());
+    if (preroll_len > 0) {
+        _ring.write(preroll, preroll_len);
+        _jitter.skipPrefill();
+    }
+    strlcpy(_url, url, sizeof(_url));
+    _reader.begin(millis());
+    _pos = 0;
+    _lowPercent = 100;
+    _eof = false;
+
+    _running = true;
+    _active = true;
+    xSemaphoreGive(_wake);
+    return true;
+}
+
+void AudioFileSourceRing::stop() {
+    if (!_active) return;
+    _running = false;
+    // Der Task muss die Quelle losgelassen haben, bevor sie geschlossen oder neu geöffnet wird
+    xSemaphoreTake(_idle, portMAX_DELAY);
+    _active = false;
+    _source->close();
+}
+
+uint32_t AudioFileSourceRing::takeTail(uint8_t* dst, uint32_t max) {
+    if (_active) return 0;
+    if (_history) {
+        pump();
+        uint32_t len = _history->copyTail(dst, max);
+        _history->reset();
+        return len;
+    }
+    uint32_t fill = _ring.fill();
+    if (fill > max) _ring.consume(fill - max);
+    return _ring.read(dst, max);
+}
+
+void AudioFileSourceRing::readerTask(void* arg) {
+    AudioFileSourceRing* self = (AudioFileSourceRing*)arg;
+    for (;;) {
+        xSemaphoreTake(self->_wake, portMAX_DELAY);
+        self->fillFromSource();
+        xSemaphoreGive(self->_idle);
+    }
+}
+
+void AudioFileSourceRing::fillFromSource() {
+    while (_running) {
+        switch (_reader.step()) {
+        case StreamReader::SR_BACKOFF:
+            vTaskDelay(pdMS_TO_TICKS(50));
+            break;
+        case StreamReader::SR_CONNECTED:
+            boot_mark("HTTP verbunden");
+            Serial.printf("Stream verbunden nach %u ms.\n", _reader.reconnectMs());
+            break;
+        case StreamReader::SR_CONNECT_FAILED:
+            Serial.printf("Verbindung fehlgeschlagen, nächster Versuch in %u ms.\n", _reconnect.backoffMs());
+            break;
+        case StreamReader::SR_THROTTLED:
+            vTaskDelay(pdMS_TO_TICKS(10));
+            break;
+        case StreamReader::SR_WAITING:
+            vTaskDelay(pdMS_TO_TICKS(5));
+            break;
+        case StreamReader::SR_LOST:
+            Serial.println("Stream-Verbindung verloren, Wiedergabe läuft aus dem Puffer weiter.");
+            break;
+        case StreamReader::SR_DATA:
+            break;
+        }
+    }
+}
+
+bool AudioFileSourceRing::openStream() {
+    Serial.printf("Verbinde Stream (Versuch %u)...\n", _reconnect.failures() + 1);
+    if (WiFi.status() != WL_CONNECTED || !openSource()) return false;
+#ifdef STREAM_FAULT_INJECTION
+    _fault.begin(millis());
+#endif
+    return true;
+}
+
+int32_t AudioFileSourceRing::readStream(uint8_t* dst, size_t len) {
+#ifdef STREAM_FAULT_INJECTION
+    // Simuliertes Netz: drosselt, pausiert oder kappt die echte Verbindung; ein Stall endet wie
+    // ein echter nach STREAM_STALL_TIMEOUT_MS
+    bool cut;
+    len = _fault.allow(millis(), len, cut);
+    if (cut) {
+        Serial.println("[FAULT] Verbindung gekappt");
+        return -1;
+    }
+    if (len == 0) return 0;
+#endif
+    uint32_t got = _source->readNonBlock(dst, len);
+    if (got == 0) return _source->isOpen() ? 0 : -1;
+#ifdef STREAM_FAULT_INJECTION
+    _fault.consumed(millis(), got);
+#endif
+    return (int32_t)got;
+}
+
+void AudioFileSourceRing::closeStream() {
+    _source->close();
+}
+
+// Löst beim Start den Host vorab auf, damit die Zeitleiste DNS und HTTP getrennt zeigt.
+// Das anschließende open() findet die Adresse dann im DNS-Cache von lwIP.
+static void boot_resolve_host(const char* url) {
+    const char* host = strstr(url, "://");
+    host = host ? host + 3 : url;
+    char name[64];
+    size_t len = strcspn(host, ":/?");
+    if (len == 0 || len >= sizeof(name)) return;
+    memcpy(name, host, len);
+    name[len] = '\0';
+    IPAddress addr;
+    if (WiFi.hostByName(name, addr)) boot_mark("DNS aufgelöst");
+}
+
+bool AudioFileSourceRing::openSource() {
+    // Gemerktes Ziel zuerst, bei Fehlschlag die Preset-URL (siehe station_open())
+    StationInfo info;
+    return station_open(_url, info, [this](const char* url, StationInfo& i) {
+        if (boot_timeline_active()) boot_resolve_host(url);
+        return _source->open(url, i);
+    });
+}
+
+void AudioFileSourceRing::pump() {
+    if (!_history) return;
+    const uint8_t* span;
+    size_t n;
+    while ((n = _ring.readSpan(&span)) > 0) {
+        _history->append(span, n);
+        _ring.consume(n);
+    }
+}
+
+uint32_t AudioFileSourceRing::take(uint8_t* dst, uint32_t len) {
+    if (!_history) return _ring.read(dst, len);
+    pump();
+    return _history->read(dst, len);
+}
+
+uint32_t AudioFileSourceRing::read(void* data, uint32_t len) {
+    // Wie AudioFileSourceBuffer: blockiert, bis 'len' Bytes da sind (oder Timeout/Ende)
+    uint8_t* dst = (uint8_t*)data;
+    uint32_t done = take(dst, len);
+    uint32_t start = millis();
+    while (done < len && _running && !_eof && millis() - start < STREAM_READ_TIMEOUT_MS) {
+        vTaskDelay(1);
+        done += take(dst + done, len - done);
+    }
+
+    uint8_t percent = getFillPercent();
+    if (percent < _lowPercent) _lowPercent = percent;
+    _pos += done;
+    return done;
+}
+
+uint32_t AudioFileSourceRing::readNonBlock(void* data, uint32_t len) {
+    uint32_t done = take((uint8_t*)data, len);
+    _pos += done;
+    return done;
+}
+
+bool AudioFileSourceRing::seek(int32_t pos, int dir) {
+    (void)pos;
+    (void)dir;
+    return false; // Streams lassen sich nicht spulen
+}
+
+bool AudioFileSourceRing::close() {
+    // Der Decoder ruft close() in stop(); der Ring selbst bleibt für den nächsten Sender bestehen
+    stop();
+    return true;
+}
+
+bool AudioFileSourceRing::isOpen() {
+    // Solange der Netzwerk-Task läuft (auch beim Neuverbinden), gilt der Stream als offen
+    return (_active && !_eof) || getFillLevel() > 0;
+}
+
+uint32_t AudioFileSourceRing::getSize() {
+    return _source->getSize();
+}
+
+uint32_t AudioFileSourceRing::getPos() {
+    return _pos;
+}
+
+bool AudioFileSourceRing::loop() {
+    // Nachgefüllt wird im Netzwerk-Task, hier ist nichts zu tun
+    return true;
+}
+
+uint8_t AudioFileSourceRing::getFillPercent() const {
+    // Mit Zeitversatz kann mehr als der Ring vor dem Cursor liegen
+    uint32_t cap = _ring.capacity();
+    uint32_t fill = getFillLevel();
+    if (fill > cap) fill = cap;
+    return cap ? (uint8_t)((uint64_t)fill * 100 / cap) : 0;
+}
+
+uint8_t AudioFileSourceRing::takeLowWatermark() {
+    uint8_t low = _lowPercent;
+    _lowPercent = getFillPercent();
+    return low;
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <Arduino.h>
+#include "AudioFileSource.h"
+#include "station_source.h"
+#include "spsc_ring.h"
+#include "jitter_buffer.h"
+#include "reconnect.h"
+#include "stream_reader.h"
+#include "timeshift.h"
+#ifdef STREAM_FAULT_INJECTION
+#include "stream_fault.h"
+#endif
+
+// Puffertiefe in Sekunden Stream. Die Größe in Bytes ergibt sich aus STREAM_BITRATE_KBPS.
+#ifndef STREAM_BUFFER_SECONDS
+#define STREAM_BUFFER_SECONDS 15
+#endif
+// Bitrate, für die der Puffer dimensioniert wird (höhere Raten bekommen entsprechend weniger Sekunden)
+#ifndef STREAM_BITRATE_KBPS
+#define STREAM_BITRATE_KBPS 128
+#endif
+// Ohne PSRAM bleibt es bei der bisherigen Größe im internen RAM
+#define STREAM_BUFFER_FALLBACK 16384
+
+// Wie lange read() höchstens auf Nachschub wartet, bevor es mit dem zurückkehrt, was da ist
+#define STREAM_READ_TIMEOUT_MS 1000
+#define STREAM_URL_MAX 256
+
+/**
+ * @brief AudioFileSource über einem SPSC-Ring im PSRAM, ersetzt AudioFileSourceBuffer.
+ * Ein eigener Task (Kern 0, neben dem WLAN-Stack) liest die Quelle (den HTTP-Stream des Senders) und
+ * schreibt direkt in den Ring; der Decoder liest mit read() direkt aus dem Ring in seinen
+ * Eingangspuffer. Kein Lock, keine Allokation im laufenden Betrieb.
+ *
+ * Ring, Task und Quelle werden einmal angelegt und für jeden Sender wiederverwendet:
+ * start(url) öffnet die Quelle im Netzwerk-Task (der Audio-Task wartet also nicht auf den
+ * Verbindungsaufbau), stop() schließt sie wieder. Dazwischen gehört die Quelle dem Netzwerk-Task.
+ * Geöffnet wird bevorzugt das im Sender-Cache gemerkte Ziel (siehe station_cache.h).
+ * Bricht die Verbindung ab, öffnet er sie mit Backoff neu (siehe ReconnectPolicy). Ring, Decoder und
+ * Ausgabe bleiben dabei bestehen: erst läuft der Puffer aus, dann spielt die Ausgabe Stille.
+ * Die Schritte des Netzwerk-Tasks macht StreamReader; diese Klasse ist dessen Quelle.
+ *
+ * Mit setHistory() liest der Decoder nicht direkt aus dem Ring: der Audio-Task übernimmt die
+ * Live-Daten in den Zeitversatz-Verlauf (auch während der Pause, siehe pump()) und der Decoder
+ * liest ab dessen Cursor.
+ */
+class AudioFileSourceRing : public AudioFileSource, private StreamReaderSource {
+public:
+    AudioFileSourceRing(AudioFileSourceStation* source, uint32_t bytes = ringBytes());
+    virtual ~AudioFileSourceRing() override;
+
+    /**
+     * @brief Leert den Ring und lässt den Netzwerk-Task 'url' öffnen und lesen.
+     * @param preroll Optional bereits vorhandene Stream-Daten (z.B. Preroll-Cache), die vor den
+     * Live-Daten abgespielt werden; damit startet die Wiedergabe ohne Vorpuffer.
+     * @param bitrate_kbps Bekannte Bitrate des Senders (0 = STREAM_BITRATE_KBPS annehmen)
+     */
+    bool start(const char* url, const uint8_t* preroll = nullptr, uint32_t preroll_len = 0,
+               uint16_t bitrate_kbps = 0);
+    // Hält den Netzwerk-Task an und schließt die Quelle; der Inhalt des Rings bleibt erhalten
+    void stop();
+    // Nach stop(): kopiert die jüngsten höchstens 'max' Bytes aus dem Ring und leert ihn
+    uint32_t takeTail(uint8_t* dst, uint32_t max);
+
+    // Zeitversatz: Verlauf, der ab jetzt alle Stream-Daten aufnimmt (vor dem ersten start() setzen)
+    void setHistory(TimeshiftHistory* history) { _history = history; }
+    // Nur vom Audio-Task: Live-Daten aus dem Ring in den Verlauf übernehmen
+    void pump();
+
+    virtual uint32_t read(void* data, uint32_t len) override;
+    virtual uint32_t readNonBlock(void* data, uint32_t len) override;
+    virtual bool seek(int32_t pos, int dir) override;
+    virtual bool close() override;
+    virtual bool isOpen() override;
+    virtual uint32_t getSize() override;
+    virtual uint32_t getPos() override;
+    virtual bool loop() override;
+
+    // Füllstand in Bytes bzw. Prozent der Kapazität; mit Zeitversatz zählt alles ab dem Cursor
+    uint32_t getFillLevel() const { return _ring.fill() + (_history ? _history->available() : 0); }
+    uint8_t getFillPercent() const;
+    uint32_t getCapacity() const { return _ring.capacity(); }
+    // Niedrigster Füllstand seit dem letzten Aufruf (in Prozent), für die Diagnose
+    uint8_t takeLowWatermark();
+    // true, wenn der Buffer ohne PSRAM (kleiner Fallback) angelegt werden musste
+    bool isFallback() const { return _fallback; }
+
+    // Vom Audio-Task vor jedem Decoder-Durchlauf: false = pausieren, der Puffer füllt sich noch
+    bool readyToPlay() {
+        pump();
+        return _jitter.update(getFillLevel(), _eof);
+    }
+    const JitterBuffer& jitter() const { return _jitter; }
+    const ReconnectPolicy& reconnect() const { return _reconnect; }
+
+    // Standardgröße aus STREAM_BUFFER_SECONDS und STREAM_BITRATE_KBPS
+    static uint32_t ringBytes() { return (uint32_t)STREAM_BUFFER_SECONDS * STREAM_BITRATE_KBPS * 1000 / 8; }
+
+private:
+    AudioFileSourceStation* _source;
+    uint8_t* _mem = nullptr;
+    uint32_t _bytes = 0;
+    bool _fallback = false;
+    SpscRing _ring;
+    TimeshiftHistory* _history = nullptr;  // nur vom Audio-Task benutzt
+    JitterBuffer _jitter;
+    ReconnectPolicy _reconnect;  // nur vom Netzwerk-Task benutzt
+    StreamReader _reader;        // nur vom Netzwerk-Task benutzt (außer begin() in start())
+#ifdef STREAM_FAULT_INJECTION
+    StreamFaultInjector _fault;
+#endif
+    char _url[STREAM_URL_MAX];
+    uint32_t _pos = 0;
+    uint8_t _lowPercent = 100;
+
+    TaskHandle_t _task = nullptr;
+    SemaphoreHandle_t _wake = nullptr;
+    SemaphoreHandle_t _idle = nullptr;
+    bool _active = false;            // nur vom Audio-Task benutzt
+    volatile bool _running = false;  // Anforderung an den Netzwerk-Task
+    volatile bool _eof = false;
+
+    static void readerTask(void* arg);
+    void fillFromSource();
+    uint32_t take(uint8_t* dst, uint32_t len);
+    bool openSource();
+
+    // StreamReaderSource, nur vom Netzwerk-Task
+    bool openStream() override;
+    int32_t readStream(uint8_t* dst, size_t len) override;
+    void closeStream() override;
+    uint32_t millis() override { return ::millis(); }
+};
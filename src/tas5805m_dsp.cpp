@@ -0,0 +1,82 @@
+#include "tas5805m_dsp.h"
+
+int32_t Tas5805mDsp::toFixed527(float c) {
+    double v = (double)c * (double)(1 << 27);
+    v += (v >= 0) ? 0.5 : -0.5;
+    if (v >  2147483647.0) return INT32_MAX;
+    if (v < -2147483648.0) return INT32_MIN;
+    return (int32_t)v;
+}
+
+void Tas5805mDsp::coefficientAddress(uint8_t channel, uint8_t index, uint8_t word, uint8_t& page, uint8_t& reg) {
+    // Linearer Byte-Offset ab Beginn der Nutzdaten der Basis-Page des Kanals;
+    // Worte überschreiten nie eine Page-Grenze (120 Byte Nutzdaten pro Page)
+    const uint8_t base_page = channel ? TAS5805M_BQ_RIGHT_PAGE : TAS5805M_BQ_LEFT_PAGE;
+    const uint8_t base_reg  = channel ? TAS5805M_BQ_RIGHT_REG : TAS5805M_BQ_LEFT_REG;
+    uint32_t offset = (base_reg - TAS5805M_PAGE_DATA_START) + (uint32_t)index * 20 + word * 4;
+    page = base_page + offset / TAS5805M_PAGE_DATA_BYTES;
+    reg  = TAS5805M_PAGE_DATA_START + offset % TAS5805M_PAGE_DATA_BYTES;
+}
+
+bool Tas5805mDsp::select(uint8_t book, uint8_t page) {
+    if (_book != book) {
+        // Book-Wechsel geht nur von Page 0 aus
+        uint8_t zero = 0;
+        if (!_bus.write(TAS5805M_REG_PAGE, &zero, 1)) return false;
+        if (!_bus.write(TAS5805M_REG_BOOK, &book, 1)) return false;
+        _book = book;
+        _page = 0;
+    }
+    if (_page != page) {
+        if (!_bus.write(TAS5805M_REG_PAGE, &page, 1)) return false;
+        _page = page;
+    }
+    return true;
+}
+
+bool Tas5805mDsp::writeBiquad(uint8_t channel, uint8_t index, const BiquadCoefficients& k) {
+    if (channel > 1 || index >= TAS5805M_BQ_PER_CHANNEL) return false;
+
+    // Der TAS5805M rechnet y = b0*x + b1*x1 + b2*x2 + a1*y1 + a2*y2, a1/a2 daher mit umgekehrtem Vorzeichen
+    const float words[5] = { k.b0, k.b1, k.b2, -k.a1, -k.a2 };
+    for (uint8_t w = 0; w < 5; w++) {
+        uint8_t page, reg;
+        coefficientAddress(channel, index, w, page, reg);
+        if (!select(TAS5805M_BQ_BOOK, page)) return false;
+
+        int32_t v = toFixed527(words[w]);
+        uint8_t data[4] = {
+            (uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v
+        };
+        if (!_bus.write(reg, data, 4)) return false;
+    }
+    return true;
+}
+
+bool Tas5805mDsp::restoreDefaultPage() {
+    return select(0, 0);
+}
+
+bool Tas5805mDsp::setEqEnabled(bool enabled) {
+    if (!select(0, 0)) return false;
+    uint8_t misc;
+    if (!_bus.read(TAS5805M_REG_DSP_MISC, &misc, 1)) return false;
+    if (enabled) {
+        misc &= ~TAS5805M_DSP_MISC_BYPASS_EQ;
+    } else {
+        misc |= TAS5805M_DSP_MISC_BYPASS_EQ;
+    }
+    return _bus.write(TAS5805M_REG_DSP_MISC, &misc, 1);
+}
+
+uint8_t Tas5805mVolumeSink::registerValue(float db, bool mute) {
+    if (mute) return TAS5805M_DIG_VOL_MUTE;
+    float steps = TAS5805M_DIG_VOL_0DB - db / TAS5805M_DIG_VOL_STEP_DB;
+    if (steps < 0.0f) return 0;
+    if (steps > TAS5805M_DIG_VOL_MUTE - 1) return TAS5805M_DIG_VOL_MUTE - 1;
+    return (uint8_t)(steps + 0.5f);
+}
+
+float Tas5805mVolumeSink::toDb(uint8_t value) {
+    return ((int)TAS5805M_DIG_VOL_0DB - (int)value) * TAS5805M_DIG_VOL_STEP_DB;
+}
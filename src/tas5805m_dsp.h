@@ -0,0 +1,101 @@
+#pragma once
+#include <stdint.h>
+#include "biquad.h"
+#include "volume_engine.h"
+
+// Übersetzung von Biquad-Koeffizienten in Register-Schreibzugriffe für die DSP-Biquads des TAS5805M.
+// Ohne Arduino-Abhängigkeiten: der I2C-Zugriff läuft über TasRegisterBus, auf dem Host lässt sich
+// dafür eine Register-Map als Mock einsetzen.
+
+// Koeffizientenspeicher der Biquads (Register Map, Book 0xAA): je Kanal 15 Biquads zu 5 Worten
+// b0, b1, b2, a1, a2 à 4 Byte, fortlaufend über die Nutzdaten der Pages. BQ1 links beginnt bei
+// Page 0x24 / Register 0x18, BQ1 rechts bei Page 0x26 / Register 0x64. Zwischen dem Ende von BQ15
+// links (Page 0x26 / 0x53) und BQ1 rechts liegen 16 Byte, die nicht zum EQ gehören.
+#define TAS5805M_BQ_BOOK         0xAA
+#define TAS5805M_BQ_LEFT_PAGE    0x24
+#define TAS5805M_BQ_LEFT_REG     0x18
+#define TAS5805M_BQ_RIGHT_PAGE   0x26
+#define TAS5805M_BQ_RIGHT_REG    0x64
+#define TAS5805M_BQ_PER_CHANNEL  15
+
+// Pro Page sind die Register 0x08..0x7F Nutzdaten, 0x00 (Page) und 0x7F auf Page 0 (Book) steuern
+#define TAS5805M_REG_PAGE        0x00
+#define TAS5805M_REG_BOOK        0x7F
+#define TAS5805M_PAGE_DATA_START 0x08
+#define TAS5805M_PAGE_DATA_BYTES 120
+
+// Book 0 / Page 0: DSP-Steuerung, Bit 0 überbrückt den EQ
+#define TAS5805M_REG_DSP_MISC    0x66
+#define TAS5805M_DSP_MISC_BYPASS_EQ 0x01
+
+// Book 0 / Page 0: digitale Lautstärke, 0x00 = +24 dB, 0x30 = 0 dB, 0,5 dB pro Schritt, 0xFF = stumm
+#define TAS5805M_REG_DIG_VOL     0x4C
+#define TAS5805M_DIG_VOL_0DB     0x30
+#define TAS5805M_DIG_VOL_MUTE    0xFF
+#define TAS5805M_DIG_VOL_STEP_DB 0.5f
+
+/**
+ * @brief Minimaler Registerzugriff auf den Verstärker (aktuelle Book/Page).
+ */
+class TasRegisterBus {
+public:
+    virtual ~TasRegisterBus() {}
+    virtual bool write(uint8_t reg, const uint8_t* data, uint8_t len) = 0;
+    virtual bool read(uint8_t reg, uint8_t* data, uint8_t len) = 0;
+};
+
+class Tas5805mDsp {
+public:
+    explicit Tas5805mDsp(TasRegisterBus& bus) : _bus(bus) {}
+
+    /**
+     * @brief Schreibt ein Biquad in den Koeffizientenspeicher.
+     * @param channel 0 = links, 1 = rechts
+     * @param index 0..TAS5805M_BQ_PER_CHANNEL-1
+     */
+    bool writeBiquad(uint8_t channel, uint8_t index, const BiquadCoefficients& k);
+
+    // EQ-Block im DSP ein- bzw. ausschalten (Bypass-Bit in DSP_MISC)
+    bool setEqEnabled(bool enabled);
+
+    /**
+     * @brief Zurück auf Book 0 / Page 0.
+     * Muss nach jeder Koeffizienten-Sequenz passieren, sonst landen die Zugriffe der
+     * tas5805m-Bibliothek (z.B. Lautstärke) im falschen Speicherbereich.
+     */
+    bool restoreDefaultPage();
+
+    // 5.27-Festkomma (Vorzeichen, 4 Ganzzahl-, 27 Nachkommabits), Big-Endian im Register
+    static int32_t toFixed527(float c);
+    // Register-Adresse eines Koeffizienten-Worts (0..4 = b0, b1, b2, a1, a2)
+    static void coefficientAddress(uint8_t channel, uint8_t index, uint8_t word, uint8_t& page, uint8_t& reg);
+
+private:
+    TasRegisterBus& _bus;
+    int16_t _book = -1;
+    int16_t _page = -1;
+
+    bool select(uint8_t book, uint8_t page);
+};
+
+/**
+ * @brief Ausgabe der VolumeEngine in das Lautstärke-Register des TAS5805M.
+ * Ein Pegelwechsel ist genau ein I2C-Schreibzugriff. Setzt Book 0 / Page 0 voraus
+ * (siehe Tas5805mDsp::restoreDefaultPage()).
+ */
+class Tas5805mVolumeSink : public VolumeSink {
+public:
+    explicit Tas5805mVolumeSink(TasRegisterBus& bus) : _bus(bus) {}
+
+    int32_t code(float db, bool mute) const override { return registerValue(db, mute); }
+    bool write(int32_t code) override {
+        uint8_t value = (uint8_t)code;
+        return _bus.write(TAS5805M_REG_DIG_VOL, &value, 1);
+    }
+
+    static uint8_t registerValue(float db, bool mute);
+    static float toDb(uint8_t value);
+
+private:
+    TasRegisterBus& _bus;
+};
@@ -0,0 +1,109 @@
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <atomic>
+
+#include "telemetry.h"
+
+namespace {
+// Intervall-Werte werden beim Ausgeben mit exchange() zurückgesetzt
+std::atomic<uint32_t> decode_calls{0};
+std::atomic<uint32_t> decode_cycles{0};
+std::atomic<uint32_t> decode_max{0};
+std::atomic<uint32_t> decode_hist[TELEMETRY_DECODE_BUCKETS];
+std::atomic<uint8_t> fill_now{0};
+std::atomic<uint8_t> fill_min{100};
+std::atomic<uint32_t> a2dp_packets{0};
+std::atomic<uint32_t> a2dp_max_gap_us{0};
+
+// Summen seit dem Start
+std::atomic<uint32_t> underruns{0};
+std::atomic<uint32_t> reconnects{0};
+std::atomic<uint32_t> a2dp_gaps{0};
+uint32_t a2dp_last_us = 0;  // nur im Bluetooth-Task
+
+#ifdef TELEMETRY_CSV
+uint32_t last_report = 0;
+bool header_sent = false;
+#endif
+
+// Nur der schreibende Task erhöht das Maximum, ein Lesen/Schreiben ohne CAS reicht
+inline void raise(std::atomic<uint32_t>& max, uint32_t value) {
+    if (value > max.load(std::memory_order_relaxed)) max.store(value, std::memory_order_relaxed);
+}
+}
+
+void telemetry_decode(uint32_t cycles) {
+    decode_calls.fetch_add(1, std::memory_order_relaxed);
+    decode_cycles.fetch_add(cycles, std::memory_order_relaxed);
+    raise(decode_max, cycles);
+
+    uint32_t us = cycles / getCpuFrequencyMhz();
+    uint8_t bucket = 0;
+    for (uint32_t limit = TELEMETRY_DECODE_BUCKET0_US; us >= limit && bucket < TELEMETRY_DECODE_BUCKETS - 1; limit <<= 1) {
+        bucket++;
+    }
+    decode_hist[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void telemetry_stream(uint8_t fill_percent, uint32_t total_reconnects) {
+    fill_now.store(fill_percent, std::memory_order_relaxed);
+    if (fill_percent < fill_min.load(std::memory_order_relaxed)) {
+        fill_min.store(fill_percent, std::memory_order_relaxed);
+    }
+    reconnects.store(total_reconnects, std::memory_order_relaxed);
+}
+
+void telemetry_underrun() {
+    underruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+void telemetry_a2dp_packet() {
+    uint32_t now = micros();
+    a2dp_packets.fetch_add(1, std::memory_order_relaxed);
+    if (a2dp_last_us != 0) {
+        uint32_t gap = now - a2dp_last_us;
+        raise(a2dp_max_gap_us, gap);
+        if (gap >= TELEMETRY_A2DP_GAP_MS * 1000) a2dp_gaps.fetch_add(1, std::memory_order_relaxed);
+    }
+    a2dp_last_us = now;
+}
+
+void telemetry_poll() {
+#ifdef TELEMETRY_CSV
+    uint32_t now = millis();
+    if (now - last_report < TELEMETRY_INTERVAL_MS) return;
+    last_report = now;
+
+    uint32_t calls = decode_calls.exchange(0, std::memory_order_relaxed);
+    uint32_t cycles = decode_cycles.exchange(0, std::memory_order_relaxed);
+    uint32_t max_cycles = decode_max.exchange(0, std::memory_order_relaxed);
+    uint32_t hist[TELEMETRY_DECODE_BUCKETS];
+    for (uint8_t i = 0; i < TELEMETRY_DECODE_BUCKETS; i++) {
+        hist[i] = decode_hist[i].exchange(0, std::memory_order_relaxed);
+    }
+    uint8_t fill_low = fill_min.exchange(100, std::memory_order_relaxed);
+    uint32_t packets = a2dp_packets.exchange(0, std::memory_order_relaxed);
+    uint32_t max_gap = a2dp_max_gap_us.exchange(0, std::memory_order_relaxed);
+
+    // "T," vorne, damit sich die Zeilen aus der übrigen seriellen Ausgabe herausfiltern lassen
+    if (!header_sent) {
+        Serial.print("T,ms,underruns,reconnects,fill_pct,fill_min_pct,decode_calls,decode_avg_us,decode_max_us");
+        for (uint8_t i = 0; i < TELEMETRY_DECODE_BUCKETS; i++) Serial.printf(",hist%u", i);
+        Serial.println(",a2dp_packets,a2dp_gaps,a2dp_max_gap_ms,heap_free,heap_min,psram_free,psram_min");
+        header_sent = true;
+    }
+
+    uint32_t mhz = getCpuFrequencyMhz();
+    Serial.printf("T,%u,%u,%u,%u,%u,%u,%u,%u", now,
+                  underruns.load(std::memory_order_relaxed), reconnects.load(std::memory_order_relaxed),
+                  fill_now.load(std::memory_order_relaxed), fill_low,
+                  calls, calls ? cycles / calls / mhz : 0, max_cycles / mhz);
+    for (uint8_t i = 0; i < TELEMETRY_DECODE_BUCKETS; i++) Serial.printf(",%u", hist[i]);
+    Serial.printf(",%u,%u,%u,%u,%u,%u,%u\n",
+                  packets, a2dp_gaps.load(std::memory_order_relaxed), max_gap / 1000,
+                  heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+                  heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL),
+                  heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+                  heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM));
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @brief Zähler und Histogramme für die Audio-Pipeline.
+ * Das Aufzeichnen ist lock-frei (wenige relaxed Atomics, Kosten siehe test_benchmark);
+ * jede Größe hat genau einen schreibenden Task. Mit -D TELEMETRY_CSV gibt telemetry_poll() aus
+ * loop() die Werte alle TELEMETRY_INTERVAL_MS als CSV-Zeile aus und setzt die Intervall-Werte zurück.
+ */
+#ifndef TELEMETRY_INTERVAL_MS
+#define TELEMETRY_INTERVAL_MS 10000
+#endif
+// Abstände zwischen zwei A2DP-Paketen ab dieser Länge zählen als Lücke
+#ifndef TELEMETRY_A2DP_GAP_MS
+#define TELEMETRY_A2DP_GAP_MS 50
+#endif
+// Histogramm der Decoder-Zeit: Fach 0 < 250 us, jedes weitere doppelt so breit, das letzte offen
+#define TELEMETRY_DECODE_BUCKETS 8
+#define TELEMETRY_DECODE_BUCKET0_US 250
+
+// Audio-Task: Dauer eines mp3->loop() in CPU-Zyklen
+void telemetry_decode(uint32_t cycles);
+// Audio-Task: Füllstand des Stream-Puffers und Wiederverbindungen (Stream und Neustarts) insgesamt
+void telemetry_stream(uint8_t fill_percent, uint32_t reconnects);
+// Audio-Task: Ausgabe nicht rechtzeitig versorgt. Heuristik: Lücke zwischen zwei Decoder-Durchläufen
+// über RADIO_UNDERRUN_MS, kein gemeldeter Unterlauf der I2S-DMA
+void telemetry_underrun();
+// Bluetooth-Task: ein A2DP-Paket ist angekommen
+void telemetry_a2dp_packet();
+
+// Aus loop(): gibt den Datensatz aus, sobald das Intervall um ist
+void telemetry_poll();
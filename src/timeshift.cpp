@@ -0,0 +1,216 @@
+#include <string.h>
+#include "timeshift.h"
+
+// Bitraten in kbps je [MPEG-1?][Layer-Index 1..3][Bitrate-Index]; 0 = frei/ungültig
+static const uint16_t BITRATES[2][3][16] = {
+    {   // MPEG 2 / 2.5
+        { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0 },  // Layer I
+        { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 },       // Layer II
+        { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 },       // Layer III
+    },
+    {   // MPEG 1
+        { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 },
+        { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0 },
+        { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 },
+    },
+};
+static const uint32_t RATES[3] = { 44100, 48000, 32000 };
+// ADTS-Abtastraten je Index; 13 und 14 sind reserviert, 15 (explizit) gibt es in ADTS nicht
+static const uint32_t ADTS_RATES[16] = {
+    96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350, 0, 0, 0
+};
+
+// AAC in ADTS: Sync 0xFFF, Layer 00, Frame-Länge (13 Bit, mit Header) in den Bytes 3 bis 5,
+// 1024 Samples je Raw-Block. Bei HE-AAC steht die Kern-Rate im Header; Dauer passt trotzdem.
+static uint16_t adtsFrameLength(const uint8_t* h, uint16_t* samples, uint32_t* rate) {
+    uint32_t sr = ADTS_RATES[(h[2] >> 2) & 0x0F];
+    if (sr == 0) return 0;
+    uint16_t len = (uint16_t)(((h[3] & 0x03) << 11) | (h[4] << 3) | (h[5] >> 5));
+    uint16_t header = (h[1] & 0x01) ? 7 : 9;  // ohne bzw. mit CRC
+    if (len <= header) return 0;
+    *samples = (uint16_t)(1024 * ((h[6] & 0x03) + 1));
+    *rate = sr;
+    return len;
+}
+
+uint16_t TimeshiftHistory::frameLength(const uint8_t* h, uint16_t* samples, uint32_t* rate) {
+    if (h[0] != 0xFF || (h[1] & 0xE0) != 0xE0) return 0;
+    uint8_t version = (h[1] >> 3) & 3;  // 0 = 2.5, 1 = reserviert, 2 = 2, 3 = 1
+    uint8_t layer = (h[1] >> 1) & 3;    // 0 = ADTS (AAC), 1 = III, 2 = II, 3 = I
+    if (layer == 0 && (h[1] & 0xF0) == 0xF0) return adtsFrameLength(h, samples, rate);
+    uint8_t br_index = h[2] >> 4;
+    uint8_t sr_index = (h[2] >> 2) & 3;
+    if (version == 1 || layer == 0 || sr_index == 3) return 0;
+
+    bool mpeg1 = version == 3;
+    uint32_t kbps = BITRATES[mpeg1][3 - layer][br_index];
+    if (kbps == 0) return 0;
+    uint32_t sr = RATES[sr_index] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+    uint32_t padding = (h[2] >> 1) & 1;
+
+    if (layer == 3) {
+        *samples = 384;
+        *rate = sr;
+        return (uint16_t)((12 * kbps * 1000 / sr + padding) * 4);
+    }
+    bool half = layer == 1 && !mpeg1;  // Layer III in MPEG 2/2.5: halbe Frames
+    *samples = half ? 576 : 1152;
+    *rate = sr;
+    return (uint16_t)((half ? 72 : 144) * kbps * 1000 / sr + padding);
+}
+
+void TimeshiftHistory::init(uint8_t* mem, uint32_t bytes, TimeshiftFrame* index, uint32_t frames) {
+    _mem = mem;
+    _bytes = bytes;
+    _index = index;
+    _cap = frames;
+    reset();
+}
+
+void TimeshiftHistory::reset() {
+    _first = 0;
+    _count = 0;
+    _head = 0;
+    _read = 0;
+    _scan = 0;
+    _timeUs = 0;
+    _synced = false;
+    _lost = 0;
+}
+
+void TimeshiftHistory::copy(uint64_t pos, uint8_t* dst, uint32_t len) const {
+    uint32_t off = (uint32_t)(pos % _bytes);
+    uint32_t n = _bytes - off;
+    if (n > len) n = len;
+    memcpy(dst, _mem + off, n);
+    if (len > n) memcpy(dst + n, _mem, len - n);
+}
+
+void TimeshiftHistory::append(const uint8_t* data, uint32_t len) {
+    if (!_mem || len == 0) return;
+    // Mehr als der ganze Ring: nur das Ende zählt
+    if (len > _bytes) {
+        _head += len - _bytes;
+        data += len - _bytes;
+        len = _bytes;
+    }
+    uint32_t off = (uint32_t)(_head % _bytes);
+    uint32_t n = _bytes - off;
+    if (n > len) n = len;
+    memcpy(_mem + off, data, n);
+    memcpy(_mem, data + n, len - n);
+    _head += len;
+
+    // Überschriebene Frames aus dem Index nehmen
+    uint64_t oldest = tail();
+    while (_count > 0 && entryPos(0) < oldest) {
+        _first = (_first + 1) % _cap;
+        _count--;
+    }
+    if (_scan < oldest) {
+        _scan = oldest;
+        _synced = false;
+    }
+    scan();
+
+    // Cursor eingeholt: auf den ältesten noch vollständigen Frame vorrücken
+    if (_read < oldest) {
+        uint64_t to = _count > 0 ? entryPos(0) : oldest;
+        _lost += (uint32_t)(to - _read);
+        _read = to;
+    }
+}
+
+void TimeshiftHistory::scan() {
+    uint8_t h[TIMESHIFT_HEADER_BYTES];
+    uint16_t samples;
+    uint32_t rate;
+    while (_scan + TIMESHIFT_HEADER_BYTES <= _head) {
+        copy(_scan, h, TIMESHIFT_HEADER_BYTES);
+        uint16_t len = frameLength(h, &samples, &rate);
+        if (len && !_synced) {
+            // Nach einer Störung erst bestätigen: am Frame-Ende folgt ein Header derselben Art
+            if (_head - _scan < (uint64_t)len + TIMESHIFT_HEADER_BYTES) return;
+            uint8_t next[TIMESHIFT_HEADER_BYTES];
+            uint16_t s;
+            uint32_t r;
+            copy(_scan + len, next, TIMESHIFT_HEADER_BYTES);
+            if (!frameLength(next, &s, &r) || s != samples || r != rate) len = 0;
+        }
+        if (len == 0) {
+            _synced = false;
+            _scan++;
+            continue;
+        }
+        _synced = true;
+
+        // Index voll: ältesten Eintrag opfern (der Verlauf reicht dann nicht ganz zurück)
+        if (_count == _cap) {
+            _first = (_first + 1) % _cap;
+            _count--;
+        }
+        TimeshiftFrame& e = _index[(_first + _count) % _cap];
+        e.pos = (uint32_t)_scan;
+        e.ms = (uint32_t)(_timeUs / 1000);
+        _count++;
+        _timeUs += (uint64_t)samples * 1000000 / rate;
+        _scan += len;
+    }
+}
+
+uint32_t TimeshiftHistory::read(uint8_t* dst, uint32_t len) {
+    uint32_t n = available();
+    if (n > len) n = len;
+    if (n == 0) return 0;
+    copy(_read, dst, n);
+    _read += n;
+    return n;
+}
+
+uint32_t TimeshiftHistory::copyTail(uint8_t* dst, uint32_t max) const {
+    uint32_t n = (uint32_t)(_head - tail());
+    if (n > max) n = max;
+    copy(_head - n, dst, n);
+    return n;
+}
+
+uint32_t TimeshiftHistory::findPos(uint64_t pos) const {
+    uint32_t lo = 0, hi = _count;
+    while (hi - lo > 1) {
+        uint32_t mid = (lo + hi) / 2;
+        if (entryPos(mid) <= pos) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+uint32_t TimeshiftHistory::findMs(uint32_t ms) const {
+    uint32_t lo = 0, hi = _count;
+    while (hi - lo > 1) {
+        uint32_t mid = (lo + hi) / 2;
+        if (entry(mid).ms <= ms) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+uint32_t TimeshiftHistory::delayMs() const {
+    if (_count == 0) return 0;
+    uint32_t live = (uint32_t)(_timeUs / 1000);
+    return live - entry(findPos(_read)).ms;
+}
+
+uint32_t TimeshiftHistory::lengthMs() const {
+    if (_count == 0) return 0;
+    return (uint32_t)(_timeUs / 1000) - entry(0).ms;
+}
+
+uint32_t TimeshiftHistory::seek(int32_t delta_ms) {
+    if (_count == 0) return 0;
+    int64_t target = (int64_t)entry(findPos(_read)).ms + delta_ms;
+    uint32_t last = entry(_count - 1).ms;
+    if (target < entry(0).ms) target = entry(0).ms;
+    if (target > last) target = last;
+    _read = entryPos(findMs((uint32_t)target));
+    return delayMs();
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <stdint.h>
+
+// Zeitversetztes Hören: Verlauf des komprimierten Streams mit Index der MP3- bzw. AAC-Frames (ADTS).
+// Ohne Arduino-Abhängigkeiten, damit Speicherbedarf und Sprungzeiten auf dem Host messbar sind.
+
+// Länge des Verlaufs in Sekunden (0 = aus); die Größe in Bytes ergibt sich aus STREAM_BITRATE_KBPS
+#ifndef TIMESHIFT_SECONDS
+#define TIMESHIFT_SECONDS 0
+#endif
+// Sprungweite von "zurückspulen"
+#ifndef TIMESHIFT_SKIP_SECONDS
+#define TIMESHIFT_SKIP_SECONDS 10
+#endif
+// Höchstens so viele Frames pro Sekunde müssen in den Index passen: AAC mit 48 kHz und 1024
+// Samples (MP3 mit 48 kHz und 1152 Samples: 42)
+#define TIMESHIFT_FRAMES_PER_SECOND 47
+// So viele Bytes braucht frameLength() ab dem Frame-Anfang (ADTS-Header ohne CRC)
+#define TIMESHIFT_HEADER_BYTES 7
+
+// Ein Indexeintrag: Anfang eines Frames im Stream (untere 32 Bit der Byteposition) und Stream-Zeit
+struct TimeshiftFrame {
+    uint32_t pos;
+    uint32_t ms;
+};
+
+/**
+ * @brief Ring über fremdem Speicher (PSRAM), der den Stream fortlaufend aufnimmt und dabei die
+ * ältesten Daten überschreibt, mit einer Lese-Position (Cursor) für den Decoder.
+ *
+ * append() sucht in den neuen Daten die Frame-Header (MP3: Sync, Version, Layer, Bitrate, Rate;
+ * AAC: ADTS mit Rate und Frame-Länge) und legt für jeden Frame einen Indexeintrag an; die
+ * Frame-Dauer ergibt die Stream-Zeit. Nach einer Störung gilt ein Header erst als gefunden, wenn
+ * am Ende des Frames der nächste folgt.
+ * seek() springt per Binärsuche im Index auf einen Frame-Anfang, ohne etwas zu dekodieren.
+ *
+ * Schreiben und Lesen geschehen im selben Task (Audio-Task); die Klasse ist nicht threadsicher.
+ * Wird der Cursor beim Pausieren vom Schreiber eingeholt, rückt er auf den ältesten Frame vor.
+ */
+class TimeshiftHistory {
+public:
+    void init(uint8_t* mem, uint32_t bytes, TimeshiftFrame* index, uint32_t frames);
+    bool ready() const { return _mem != nullptr; }
+
+    // Verlauf verwerfen (neuer Sender)
+    void reset();
+    // Live-Daten anhängen
+    void append(const uint8_t* data, uint32_t len);
+    // Ab dem Cursor lesen; liefert höchstens available() Bytes
+    uint32_t read(uint8_t* dst, uint32_t len);
+    // Die jüngsten höchstens 'max' Bytes kopieren (Cursor bleibt unverändert)
+    uint32_t copyTail(uint8_t* dst, uint32_t max) const;
+
+    /**
+     * @brief Cursor um delta_ms verschieben (negativ = zurück), begrenzt auf den ältesten Frame
+     * und live. Landet auf einem Frame-Anfang.
+     * @return neuer Abstand zu live in ms
+     */
+    uint32_t seek(int32_t delta_ms);
+    // Zurück auf live (jüngster Frame)
+    void goLive() { seek(INT32_MAX); }
+
+    // Bytes zwischen Cursor und live
+    uint32_t available() const { return (uint32_t)(_head - _read); }
+    // Wie weit der Cursor hinter live liegt bzw. wie viel Stream-Zeit der Verlauf umfasst
+    uint32_t delayMs() const;
+    uint32_t lengthMs() const;
+    uint32_t frames() const { return _count; }
+    // Bytes, die der Cursor verloren hat, weil sie beim Pausieren überschrieben wurden
+    uint32_t lost() const { return _lost; }
+
+    /**
+     * @brief Prüft einen Frame-Header: MPEG 1/2/2.5 Layer I-III oder ADTS (AAC).
+     * @param h mindestens TIMESHIFT_HEADER_BYTES Bytes
+     * @return Frame-Länge in Bytes, 0 wenn kein gültiger Header
+     */
+    static uint16_t frameLength(const uint8_t* h, uint16_t* samples, uint32_t* rate);
+
+private:
+    uint8_t* _mem = nullptr;
+    uint32_t _bytes = 0;
+    TimeshiftFrame* _index = nullptr;
+    uint32_t _cap = 0;
+    uint32_t _first = 0;   // ältester Eintrag im Index-Ring
+    uint32_t _count = 0;
+
+    uint64_t _head = 0;    // Stream-Position hinter dem letzten Byte
+    uint64_t _read = 0;    // Cursor des Decoders
+    uint64_t _scan = 0;    // hier wird der nächste Frame-Header erwartet
+    uint64_t _timeUs = 0;  // Stream-Zeit am Ende des zuletzt indizierten Frames
+    bool _synced = false;
+    uint32_t _lost = 0;
+
+    uint64_t tail() const { return _head > _bytes ? _head - _bytes : 0; }
+    const TimeshiftFrame& entry(uint32_t i) const { return _index[(_first + i) % _cap]; }
+    // Volle Position eines Eintrags (der Index speichert nur die unteren 32 Bit)
+    uint64_t entryPos(uint32_t i) const { return _head - (uint32_t)((uint32_t)_head - entry(i).pos); }
+    // Letzter Eintrag mit Position <= pos bzw. Zeit <= ms (0, wenn keiner davor liegt)
+    uint32_t findPos(uint64_t pos) const;
+    uint32_t findMs(uint32_t ms) const;
+    void copy(uint64_t pos, uint8_t* dst, uint32_t len) const;
+    void scan();
+};
@@ -0,0 +1,82 @@
+#include "volume_engine.h"
+
+VolumeEngine::VolumeEngine(uint16_t level)
+    : _published(level), _target(level), _current(level) {}
+
+void VolumeEngine::step(int detents) {
+    _delta.fetch_add(detents, std::memory_order_relaxed);
+}
+
+void VolumeEngine::set(uint16_t level) {
+    _absolute.store(level, std::memory_order_relaxed);
+}
+
+void VolumeEngine::sync(uint16_t level) {
+    _synced.store(level, std::memory_order_relaxed);
+}
+
+void VolumeEngine::route(VolumeSink* sink, uint16_t level) {
+    // Erst den Pegel, dann die Ausgabe veröffentlichen: tick() sieht beide zusammen
+    _absolute.store(level, std::memory_order_relaxed);
+    _nextSink.store(sink, std::memory_order_release);
+}
+
+bool VolumeEngine::busy() const {
+    return _current != _target ||
+           _delta.load(std::memory_order_relaxed) != 0 ||
+           _absolute.load(std::memory_order_relaxed) >= 0 ||
+           _synced.load(std::memory_order_relaxed) >= 0 ||
+           _nextSink.load(std::memory_order_relaxed) != nullptr;
+}
+
+float VolumeEngine::toDb(uint16_t level) {
+    return (float)VOLUME_DB_MIN + level * VOLUME_STEP_DB;
+}
+
+uint16_t VolumeEngine::fromDb(float db) {
+    if (db <= (float)VOLUME_DB_MIN) return 0;
+    if (db >= (float)VOLUME_DB_MAX) return VOLUME_LEVELS;
+    return (uint16_t)((db - (float)VOLUME_DB_MIN) / VOLUME_STEP_DB + 0.5f);
+}
+
+bool VolumeEngine::tick() {
+    bool jump = false;
+    VolumeSink* sink = _nextSink.exchange(nullptr, std::memory_order_acquire);
+    if (sink) {
+        _sink = sink;
+        _lastCode = INT32_MIN;
+        jump = true;
+    }
+
+    int32_t absolute = _absolute.exchange(-1, std::memory_order_relaxed);
+    if (absolute >= 0) _target = absolute;
+    _target += _delta.exchange(0, std::memory_order_relaxed);
+    if (_target < 0) _target = 0;
+    if (_target > VOLUME_LEVELS) _target = VOLUME_LEVELS;
+
+    int32_t synced = _synced.exchange(-1, std::memory_order_relaxed);
+    if (synced >= 0 && !jump) {
+        // Das Gerät steht schon auf dem Pegel: nur den Zustand nachziehen
+        _target = synced > VOLUME_LEVELS ? VOLUME_LEVELS : synced;
+        _current = _target;
+        if (_sink) _lastCode = _sink->code(toDb(_current), _current == 0);
+    }
+    _published.store(_target, std::memory_order_relaxed);
+
+    if (jump) {
+        _current = _target;
+    } else if (_current < _target) {
+        _current = (_target - _current > VOLUME_RAMP_LEVELS) ? _current + VOLUME_RAMP_LEVELS : _target;
+    } else if (_current > _target) {
+        _current = (_current - _target > VOLUME_RAMP_LEVELS) ? _current - VOLUME_RAMP_LEVELS : _target;
+    }
+
+    if (!_sink) return false;
+    int32_t code = _sink->code(toDb(_current), _current == 0);
+    if (code == _lastCode) return false;
+    // Schlägt der Zugriff fehl, wird es in der nächsten Zeitscheibe erneut versucht
+    if (!_sink->write(code)) return false;
+    _lastCode = code;
+    _writes++;
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+// Lautstärke-Logik ohne Arduino-Abhängigkeiten: Zeit (Aufruf von tick()) und Ausgabe (VolumeSink)
+// kommen von außen, damit sie sich auf dem Host gegen einen Mock-Bus prüfen lässt.
+
+// Pegelbereich. Oben wie vor der Engine bis +24 dB (TAS5805M-Register 0x00, 0x30 = 0 dB).
+#ifndef VOLUME_DB_MIN
+#define VOLUME_DB_MIN -60.0
+#endif
+#ifndef VOLUME_DB_MAX
+#define VOLUME_DB_MAX 24.0
+#endif
+// Pegelschritt pro Encoder-Raste (entspricht einem Registerschritt des TAS5805M)
+#define VOLUME_STEP_DB 0.5f
+#define VOLUME_LEVELS ((uint16_t)((VOLUME_DB_MAX - VOLUME_DB_MIN) / VOLUME_STEP_DB))
+// Zeitscheibe des Lautstärke-Tasks: höchstens ein Schreibzugriff pro Scheibe
+#ifndef VOLUME_SLICE_MS
+#define VOLUME_SLICE_MS 20
+#endif
+// So viele Pegelschritte geht die Rampe pro Zeitscheibe (2 x 0,5 dB / 20 ms = 50 dB/s)
+#ifndef VOLUME_RAMP_LEVELS
+#define VOLUME_RAMP_LEVELS 2
+#endif
+
+/**
+ * @brief Ausgabe eines Pegels, z.B. das Lautstärke-Register des Verstärkers oder die A2DP-Lautstärke.
+ */
+class VolumeSink {
+public:
+    virtual ~VolumeSink() {}
+    // Geräte-Wert für den Pegel; ergibt ein Schritt denselben Wert, wird nicht erneut geschrieben
+    virtual int32_t code(float db, bool mute) const = 0;
+    virtual bool write(int32_t code) = 0;
+};
+
+/**
+ * @brief Sammelt Lautstärke-Änderungen aus beliebigen Tasks und fährt sie als Rampe an.
+ *
+ * Pegel sind Stufen zu VOLUME_STEP_DB von VOLUME_DB_MIN (Stufe 0, stumm) bis VOLUME_DB_MAX
+ * (Stufe VOLUME_LEVELS). step(), set(), sync() und route() sind lock-frei und dürfen aus jedem
+ * Task kommen; sie hinterlegen nur Anforderungen. tick() wird einmal pro Zeitscheibe aus genau
+ * einem Task aufgerufen, verrechnet die Anforderungen, bewegt den Pegel um höchstens
+ * VOLUME_RAMP_LEVELS auf das Ziel zu und schreibt höchstens einmal in die Ausgabe.
+ */
+class VolumeEngine {
+public:
+    explicit VolumeEngine(uint16_t level = VOLUME_LEVELS / 2);
+
+    // Encoder-Rasten; mehrere Aufrufe zwischen zwei tick() werden zu einer Änderung zusammengefasst
+    void step(int detents);
+    // Neues Ziel
+    void set(uint16_t level);
+    // Pegel wurde außerhalb geändert (z.B. am Telefon): übernehmen, ohne zu schreiben
+    void sync(uint16_t level);
+    // Andere Ausgabe mit eigenem Pegel; der wird ohne Rampe sofort geschrieben
+    void route(VolumeSink* sink, uint16_t level);
+
+    // true, wenn geschrieben wurde
+    bool tick();
+    // true, solange die Rampe läuft oder Anforderungen offen sind (aus dem tick()-Task)
+    bool busy() const;
+
+    uint16_t target() const { return _published.load(std::memory_order_relaxed); }
+    uint16_t current() const { return _current; }
+    VolumeSink* sink() const { return _sink; }
+    uint32_t writes() const { return _writes; }
+
+    static float toDb(uint16_t level);
+    static uint16_t fromDb(float db);
+
+private:
+    // --- Anforderungen aus anderen Tasks ---
+    std::atomic<int32_t> _delta{0};
+    std::atomic<int32_t> _absolute{-1};
+    std::atomic<int32_t> _synced{-1};
+    std::atomic<VolumeSink*> _nextSink{nullptr};
+    std::atomic<uint16_t> _published;
+
+    // --- Nur im tick()-Task ---
+    VolumeSink* _sink = nullptr;
+    int32_t _target;
+    uint16_t _current;
+    int32_t _lastCode = INT32_MIN;
+    uint32_t _writes = 0;
+};
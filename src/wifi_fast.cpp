@@ -0,0 +1,92 @@
+#include <Arduino.h>
+#include <WiFi.h>
+#include <Preferences.h>
+#include <esp_wifi.h>
+
+#include "wifi_fast.h"
+
+// Eigene Instanz wie im Sender-Cache, unabhängig vom Einstellungsspeicher
+static Preferences fast_prefs;
+
+static bool fast_load(WifiFastInfo& info) {
+    fast_prefs.begin("wifi_fast", true);
+    bool found = fast_prefs.getBytesLength("ap") == sizeof(WifiFastInfo) &&
+                 fast_prefs.getBytes("ap", &info, sizeof(WifiFastInfo)) == sizeof(WifiFastInfo);
+    fast_prefs.end();
+    info.ssid[sizeof(info.ssid) - 1] = '\0';
+    return found && info.channel != 0;
+}
+
+static void fast_forget() {
+    fast_prefs.begin("wifi_fast", false);
+    fast_prefs.remove("ap");
+    fast_prefs.end();
+}
+
+bool wifi_fast_connect(uint32_t timeout_ms) {
+    WifiFastInfo info;
+    if (!fast_load(info)) return false;
+
+    WiFi.mode(WIFI_STA);
+
+    // Zugangsdaten so, wie WiFiManager sie im WLAN-Treiber hinterlegt hat
+    wifi_config_t conf;
+    if (esp_wifi_get_config(WIFI_IF_STA, &conf) != ESP_OK) return false;
+    char ssid[33];
+    char pass[65];
+    memcpy(ssid, conf.sta.ssid, 32);
+    ssid[32] = '\0';
+    memcpy(pass, conf.sta.password, 64);
+    pass[64] = '\0';
+    if (ssid[0] == '\0' || strcmp(ssid, info.ssid) != 0) {
+        // Inzwischen ein anderes Netz eingerichtet: der gemerkte AP passt nicht mehr
+        fast_forget();
+        return false;
+    }
+
+#ifdef WIFI_FAST_STATIC_IP
+    // Die alte Lease fest einstellen spart die DHCP-Runde. Ist sie inzwischen vergeben, scheitert
+    // die Verbindung nicht, aber es droht ein Adresskonflikt; daher nur auf Wunsch.
+    WiFi.config(IPAddress(info.ip), IPAddress(info.gateway), IPAddress(info.subnet), IPAddress(info.dns));
+#endif
+
+    Serial.printf("WLAN: schneller Verbindungsaufbau zu %s (Kanal %u)...\n", info.ssid, info.channel);
+    WiFi.begin(ssid, pass, info.channel, info.bssid, true);
+    uint32_t start = millis();
+    while (WiFi.status() != WL_CONNECTED && millis() - start < timeout_ms) {
+        delay(10);
+    }
+    if (WiFi.status() == WL_CONNECTED) return true;
+
+    // AP umgezogen, Kanal gewechselt o.ä.: zurück auf den normalen Weg mit Scan und DHCP
+    Serial.println("WLAN: gemerkter Access Point nicht erreichbar, normaler Verbindungsaufbau.");
+    WiFi.disconnect();
+#ifdef WIFI_FAST_STATIC_IP
+    WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+#endif
+    fast_forget();
+    return false;
+}
+
+void wifi_fast_store() {
+    if (WiFi.status() != WL_CONNECTED) return;
+
+    WifiFastInfo info;
+    memset(&info, 0, sizeof(info));
+    strncpy(info.ssid, WiFi.SSID().c_str(), sizeof(info.ssid) - 1);
+    uint8_t* bssid = WiFi.BSSID();
+    if (!bssid) return;
+    memcpy(info.bssid, bssid, sizeof(info.bssid));
+    info.channel = WiFi.channel();
+    info.ip      = (uint32_t)WiFi.localIP();
+    info.gateway = (uint32_t)WiFi.gatewayIP();
+    info.subnet  = (uint32_t)WiFi.subnetMask();
+    info.dns     = (uint32_t)WiFi.dnsIP();
+
+    // Nur bei Änderungen schreiben, um den Flash zu schonen
+    WifiFastInfo old;
+    if (fast_load(old) && memcmp(&old, &info, sizeof(WifiFastInfo)) == 0) return;
+    fast_prefs.begin("wifi_fast", false);
+    fast_prefs.putBytes("ap", &info, sizeof(WifiFastInfo));
+    fast_prefs.end();
+}
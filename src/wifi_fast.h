@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+
+// So lange wird auf den gemerkten Access Point gewartet, bevor der normale Weg (Scan, WiFiManager) greift
+#ifndef WIFI_FAST_TIMEOUT_MS
+#define WIFI_FAST_TIMEOUT_MS 3000
+#endif
+
+/**
+ * @brief Was beim letzten erfolgreichen Verbindungsaufbau über das WLAN gelernt wurde.
+ * Liegt im NVS (Namensraum "wifi_fast").
+ */
+struct WifiFastInfo {
+    char ssid[33];       // gehört zu den von WiFiManager gespeicherten Zugangsdaten
+    uint8_t bssid[6];    // Access Point, mit dem zuletzt verbunden war
+    uint8_t channel;
+    uint32_t ip;         // DHCP-Lease, nur mit -D WIFI_FAST_STATIC_IP benutzt
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+};
+
+/**
+ * @brief Verbindet direkt mit dem gemerkten Access Point auf dessen Kanal, ohne Scan.
+ * Mit -D WIFI_FAST_STATIC_IP wird zusätzlich die letzte DHCP-Lease fest eingestellt und DHCP
+ * übersprungen. Benutzt die von WiFiManager gespeicherten Zugangsdaten.
+ * @return true bei Verbindung; false (ohne Eintrag, anderes Netz oder Timeout), dann ist das
+ * WLAN wieder getrennt und auf DHCP gestellt, und der Aufrufer nimmt den normalen Weg.
+ */
+bool wifi_fast_connect(uint32_t timeout_ms = WIFI_FAST_TIMEOUT_MS);
+
+// Nach einer erfolgreichen Verbindung aufrufen: merkt AP, Kanal und Lease (schreibt nur bei Änderung)
+void wifi_fast_store();
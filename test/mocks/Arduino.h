@@ -0,0 +1,265 @@
+#pragma once
+// Attrappe des Arduino-Kerns (ESP32) für den Host-Build [env:native]. Enthält nur, was die dort
+// mitgebauten Module brauchen. Zeit, ADC, Pins und die serielle Ausgabe lassen sich über mock::
+// steuern bzw. auslesen; FreeRTOS-Semaphoren und -Queues sind über die Standardbibliothek nachgebaut.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define IRAM_ATTR
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define LOW 0
+#define HIGH 1
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+namespace mock {
+// Simulierte Zeit: millis()/micros() lesen sie, delay(), vTaskDelay() und blockierende
+// Queue-Zugriffe schieben sie weiter. Tests setzen sie direkt.
+inline uint64_t now_us = 0;
+inline void advance_ms(uint32_t ms) { now_us += (uint64_t)ms * 1000; }
+
+// ADC-Werte und Pegel je Pin; analog_source hat Vorrang (z.B. für aufgezeichnete Verläufe)
+inline uint16_t analog[64] = {};
+inline uint16_t (*analog_source)(uint8_t pin) = nullptr;
+inline uint32_t analog_reads = 0;
+inline uint8_t digital[64] = {};
+
+// Alles, was über Serial ausgegeben wurde; serial_echo reicht es zusätzlich an stdout weiter
+inline std::string serial;
+inline bool serial_echo = false;
+
+inline uint32_t cpu_mhz = 240;
+inline uint32_t restarts = 0;
+
+inline void reset() {
+    now_us = 0;
+    memset(analog, 0, sizeof(analog));
+    analog_source = nullptr;
+    analog_reads = 0;
+    memset(digital, 0, sizeof(digital));
+    serial.clear();
+    cpu_mhz = 240;
+    restarts = 0;
+}
+}
+
+inline unsigned long millis() { return (unsigned long)(uint32_t)(mock::now_us / 1000); }
+inline unsigned long micros() { return (unsigned long)(uint32_t)mock::now_us; }
+inline void delay(uint32_t ms) { mock::advance_ms(ms); }
+
+inline int analogRead(uint8_t pin) {
+    mock::analog_reads++;
+    return mock::analog_source ? mock::analog_source(pin) : mock::analog[pin & 63];
+}
+inline void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+inline int digitalRead(uint8_t pin) { return mock::digital[pin & 63]; }
+inline void digitalWrite(uint8_t pin, uint8_t value) { mock::digital[pin & 63] = value; }
+
+inline void setCpuFrequencyMhz(uint32_t mhz) { mock::cpu_mhz = mhz; }
+inline uint32_t getCpuFrequencyMhz() { return mock::cpu_mhz; }
+
+template <class T, class L, class H>
+inline T constrain(T x, L low, H high) { return x < low ? (T)low : (x > high ? (T)high : x); }
+
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+inline void* ps_malloc(size_t size) { return malloc(size); }
+inline bool psramFound() { return true; }
+
+class String {
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    String(int v) : _s(std::to_string(v)) {}
+    String(unsigned v) : _s(std::to_string(v)) {}
+    String(long v) : _s(std::to_string(v)) {}
+    String(unsigned long v) : _s(std::to_string(v)) {}
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned length() const { return (unsigned)_s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    bool startsWith(const char* p) const { return _s.rfind(p, 0) == 0; }
+    bool endsWith(const char* p) const {
+        size_t n = strlen(p);
+        return _s.size() >= n && _s.compare(_s.size() - n, n, p) == 0;
+    }
+    int indexOf(char c, unsigned from = 0) const {
+        size_t p = _s.find(c, from);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    String substring(unsigned from, unsigned to) const { return String(_s.substr(from, to - from)); }
+    String substring(unsigned from) const { return String(_s.substr(from)); }
+    long toInt() const { return atol(_s.c_str()); }
+
+    bool operator==(const String& o) const { return _s == o._s; }
+    bool operator!=(const String& o) const { return _s != o._s; }
+    String operator+(const String& o) const { return String(_s + o._s); }
+    String& operator+=(const String& o) { _s += o._s; return *this; }
+
+private:
+    std::string _s;
+};
+
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void flush() {}
+    size_t write(const uint8_t* data, size_t len) { return out(std::string((const char*)data, len)); }
+    size_t print(const char* s) { return out(s); }
+    size_t print(const String& s) { return out(s.c_str()); }
+    size_t print(long v) { return out(std::to_string(v)); }
+    size_t println() { return out("\n"); }
+    size_t println(const char* s) { return out(std::string(s) + "\n"); }
+    size_t println(const String& s) { return println(s.c_str()); }
+    size_t println(long v) { return out(std::to_string(v) + "\n"); }
+
+    size_t printf(const char* fmt, ...) {
+        char buf[512];
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        return n > 0 ? out(buf) : 0;
+    }
+
+private:
+    size_t out(const std::string& s) {
+        mock::serial += s;
+        if (mock::serial_echo) fputs(s.c_str(), stdout);
+        return s.size();
+    }
+};
+inline HardwareSerial Serial;
+
+class EspClass {
+public:
+    // Zyklen bei der eingestellten Frequenz aus der echten Rechenzeit, damit Profilierung und
+    // Lastmessung (power_work) auf dem Host plausible Werte sehen
+    uint32_t getCycleCount() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        return (uint32_t)((uint64_t)ns * mock::cpu_mhz / 1000);
+    }
+    void restart() { mock::restarts++; }
+    uint32_t getFreeHeap() { return 200000; }
+    uint32_t getFreePsram() { return 4000000; }
+};
+inline EspClass ESP;
+
+// --- FreeRTOS (kommt auf dem ESP32 mit Arduino.h) ---
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef void* TaskHandle_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define errQUEUE_FULL 0
+#define portMAX_DELAY 0xFFFFFFFFu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+inline void vTaskDelay(TickType_t ticks) { mock::advance_ms(ticks); }
+inline TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+
+// Zählende Semaphore; ein Mutex ist eine mit Startwert 1. Wartet in echter Zeit, damit
+// Tests mit mehreren Threads funktionieren.
+struct MockSemaphore {
+    std::mutex m;
+    std::condition_variable cv;
+    UBaseType_t count;
+    UBaseType_t max;
+};
+typedef MockSemaphore* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return new MockSemaphore{{}, {}, 0, 1}; }
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return new MockSemaphore{{}, {}, 1, 1}; }
+inline void vSemaphoreDelete(SemaphoreHandle_t s) { delete s; }
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(s->m);
+    auto ready = [s] { return s->count > 0; };
+    if (ticks == portMAX_DELAY) {
+        s->cv.wait(lock, ready);
+    } else if (!s->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready)) {
+        return pdFALSE;
+    }
+    s->count--;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+    std::lock_guard<std::mutex> lock(s->m);
+    if (s->count >= s->max) return pdFALSE;
+    s->count++;
+    s->cv.notify_one();
+    return pdTRUE;
+}
+
+// Queue fester Elementgröße. Leer wartet sie nicht wirklich, sondern schiebt die simulierte Zeit
+// um die Wartezeit weiter (reicht für Tests, in denen nur ein Thread liest und schreibt).
+struct MockQueue {
+    std::mutex m;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t size;
+};
+typedef MockQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t size) {
+    return new MockQueue{{}, {}, length, size};
+}
+inline void vQueueDelete(QueueHandle_t q) { delete q; }
+
+inline BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks) {
+    (void)ticks;
+    std::lock_guard<std::mutex> lock(q->m);
+    if (q->items.size() >= q->length) return errQUEUE_FULL;
+    const uint8_t* p = (const uint8_t*)item;
+    q->items.emplace_back(p, p + q->size);
+    return pdPASS;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks) {
+    std::lock_guard<std::mutex> lock(q->m);
+    if (q->items.empty()) {
+        if (ticks != portMAX_DELAY) mock::advance_ms(ticks);
+        return pdFALSE;
+    }
+    memcpy(item, q->items.front().data(), q->size);
+    q->items.pop_front();
+    return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    std::lock_guard<std::mutex> lock(q->m);
+    return (UBaseType_t)q->items.size();
+}
@@ -0,0 +1,69 @@
+#pragma once
+// Attrappe der ESP8266Audio-Schnittstelle AudioOutput (gleiche virtuelle Methoden und Felder)
+// und eine Ausgabe, die alles Empfangene aufzeichnet.
+#include <Arduino.h>
+
+class AudioOutput {
+public:
+    AudioOutput() {}
+    virtual ~AudioOutput() {}
+    virtual bool SetRate(int hz) { hertz = hz; return true; }
+    virtual bool SetBitsPerSample(int bits) { bps = bits; return true; }
+    virtual bool SetChannels(int chan) { channels = chan; return true; }
+    virtual bool SetGain(float f) {
+        if (f > 4.0f) f = 4.0f;
+        if (f < 0.0f) f = 0.0f;
+        gainF2P6 = (uint8_t)(f * (1 << 6));
+        return true;
+    }
+    virtual bool begin() { return false; }
+    typedef enum { LEFTCHANNEL = 0, RIGHTCHANNEL = 1 } SampleIndex;
+    virtual bool ConsumeSample(int16_t sample[2]) = 0;
+    virtual uint16_t ConsumeSamples(int16_t* samples, uint16_t count) {
+        for (uint16_t i = 0; i < count; i++) {
+            if (!ConsumeSample(samples)) return i;
+            samples += 2;
+        }
+        return count;
+    }
+    virtual bool stop() { return false; }
+    virtual void flush() {}
+    virtual bool loop() { return true; }
+
+protected:
+    uint16_t hertz = 0;
+    uint8_t bps = 16;
+    uint8_t channels = 2;
+    uint8_t gainF2P6 = 1 << 6;
+};
+
+/**
+ * @brief Ausgabe für Tests: zeichnet die Stereo-Frames auf und nimmt pro Aufruf höchstens
+ * 'accept' Frames ab (Gegendruck wie eine volle I2S-DMA). Zählt die Aufrufe je Pfad.
+ */
+class AudioOutputCapture : public AudioOutput {
+public:
+    std::vector<int16_t> samples;  // verschränkt links/rechts
+    uint16_t accept = 0xFFFF;
+    uint32_t single_calls = 0;
+    uint32_t block_calls = 0;
+    uint32_t stops = 0;
+
+    bool begin() override { return true; }
+    bool ConsumeSample(int16_t sample[2]) override {
+        single_calls++;
+        if (accept == 0) return false;
+        samples.push_back(sample[LEFTCHANNEL]);
+        samples.push_back(sample[RIGHTCHANNEL]);
+        return true;
+    }
+    uint16_t ConsumeSamples(int16_t* frames, uint16_t count) override {
+        block_calls++;
+        uint16_t n = count < accept ? count : accept;
+        samples.insert(samples.end(), frames, frames + 2 * n);
+        return n;
+    }
+    bool stop() override { stops++; return true; }
+    int rate() const { return hertz; }
+    size_t frames() const { return samples.size() / 2; }
+};
@@ -0,0 +1,41 @@
+#pragma once
+// Attrappe der Lautstärke-Schnittstelle von ESP32-A2DP: derselbe Frame-Typ und dieselben
+// virtuellen Methoden, über die der Stack die dekodierten Pakete an A2DPVolumeControl gibt.
+#include <Arduino.h>
+
+struct __attribute__((packed)) Frame {
+    int16_t channel1;
+    int16_t channel2;
+};
+
+class A2DPVolumeControl {
+public:
+    virtual ~A2DPVolumeControl() {}
+
+    // So ruft der Stack die Klasse: Bytes des Pakets, 4 pro Stereo-Frame
+    virtual void update_audio_data(uint8_t* data, uint16_t byteCount) {
+        update_audio_data((Frame*)data, byteCount / 4);
+    }
+    virtual void update_audio_data(Frame* data, uint16_t frameCount) {
+        if (data == nullptr || !_volumeUsed) return;
+        for (uint16_t i = 0; i < frameCount; i++) {
+            data[i].channel1 = (int16_t)((int32_t)data[i].channel1 * _factor / FACTOR_MAX);
+            data[i].channel2 = (int16_t)((int32_t)data[i].channel2 * _factor / FACTOR_MAX);
+        }
+    }
+    virtual void set_volume(uint8_t volume) = 0;
+
+protected:
+    static const int32_t FACTOR_MAX = 0x1000;
+    int32_t _factor = FACTOR_MAX;
+    bool _volumeUsed = false;
+};
+
+// Linear statt der exponentiellen Kurve des Originals; 127 = unverändert
+class A2DPDefaultVolumeControl : public A2DPVolumeControl {
+public:
+    void set_volume(uint8_t volume) override {
+        _factor = (int32_t)volume * FACTOR_MAX / 127;
+        _volumeUsed = volume < 127;
+    }
+};
@@ -0,0 +1,18 @@
+#pragma once
+// Attrappe von ESP32Encoder: der Zählerstand (PCNT) wird von Tests über mock::encoder_count gesetzt
+#include <Arduino.h>
+
+namespace mock {
+inline int64_t encoder_count = 0;
+}
+
+enum class puType { up, down, none };
+
+class ESP32Encoder {
+public:
+    static inline puType useInternalWeakPullResistors = puType::up;
+    void attachFullQuad(int a, int b) { (void)a; (void)b; }
+    void attachHalfQuad(int a, int b) { (void)a; (void)b; }
+    int64_t getCount() { return mock::encoder_count; }
+    int64_t clearCount() { mock::encoder_count = 0; return 0; }
+};
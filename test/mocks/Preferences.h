@@ -0,0 +1,91 @@
+#pragma once
+// Attrappe der ESP32-Preferences (NVS) im RAM. Der Inhalt bleibt über begin()/end() hinweg
+// erhalten, bis mock::nvs_clear() ihn löscht; mock::nvs_writes zählt die Schreibzugriffe.
+#include <Arduino.h>
+#include <map>
+#include <thread>
+
+namespace mock {
+inline std::map<std::string, std::map<std::string, std::vector<uint8_t>>> nvs;
+inline uint32_t nvs_writes = 0;
+// Dauer eines Schreibzugriffs in echter Zeit (Flash-Seite löschen und schreiben), damit Tests mit
+// mehreren Threads sehen, wer währenddessen wartet
+inline uint32_t nvs_write_us = 0;
+inline void nvs_clear() { nvs.clear(); nvs_writes = 0; nvs_write_us = 0; }
+}
+
+class Preferences {
+public:
+    bool begin(const char* name, bool read_only = false) {
+        _ns = &mock::nvs[name];
+        _readOnly = read_only;
+        return true;
+    }
+    void end() { _ns = nullptr; }
+
+    uint32_t getUInt(const char* key, uint32_t def = 0) { return get(key, def); }
+    size_t putUInt(const char* key, uint32_t value) { return put(key, &value, sizeof(value)); }
+    int32_t getInt(const char* key, int32_t def = 0) { return get(key, def); }
+    size_t putInt(const char* key, int32_t value) { return put(key, &value, sizeof(value)); }
+    uint8_t getUChar(const char* key, uint8_t def = 0) { return get(key, def); }
+    size_t putUChar(const char* key, uint8_t value) { return put(key, &value, sizeof(value)); }
+    bool getBool(const char* key, bool def = false) { return get<uint8_t>(key, def) != 0; }
+    size_t putBool(const char* key, bool value) { return putUChar(key, value ? 1 : 0); }
+    float getFloat(const char* key, float def = 0) { return get(key, def); }
+    size_t putFloat(const char* key, float value) { return put(key, &value, sizeof(value)); }
+
+    String getString(const char* key, const String& def = String()) {
+        const std::vector<uint8_t>* v = find(key);
+        return v ? String(std::string(v->begin(), v->end())) : def;
+    }
+    size_t putString(const char* key, const char* value) { return put(key, value, strlen(value)); }
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+
+    size_t getBytesLength(const char* key) {
+        const std::vector<uint8_t>* v = find(key);
+        return v ? v->size() : 0;
+    }
+    size_t getBytes(const char* key, void* buf, size_t len) {
+        const std::vector<uint8_t>* v = find(key);
+        if (!v || v->size() > len) return 0;
+        memcpy(buf, v->data(), v->size());
+        return v->size();
+    }
+    size_t putBytes(const char* key, const void* value, size_t len) { return put(key, value, len); }
+
+    bool isKey(const char* key) { return find(key) != nullptr; }
+    bool remove(const char* key) { return _ns && !_readOnly && _ns->erase(key) > 0; }
+    bool clear() {
+        if (!_ns || _readOnly) return false;
+        _ns->clear();
+        return true;
+    }
+
+private:
+    std::map<std::string, std::vector<uint8_t>>* _ns = nullptr;
+    bool _readOnly = false;
+
+    const std::vector<uint8_t>* find(const char* key) const {
+        if (!_ns) return nullptr;
+        auto it = _ns->find(key);
+        return it == _ns->end() ? nullptr : &it->second;
+    }
+
+    template <class T>
+    T get(const char* key, T def) {
+        const std::vector<uint8_t>* v = find(key);
+        if (!v || v->size() != sizeof(T)) return def;
+        T value;
+        memcpy(&value, v->data(), sizeof(T));
+        return value;
+    }
+
+    size_t put(const char* key, const void* value, size_t len) {
+        if (!_ns || _readOnly) return 0;
+        const uint8_t* p = (const uint8_t*)value;
+        (*_ns)[key].assign(p, p + len);
+        mock::nvs_writes++;
+        if (mock::nvs_write_us) std::this_thread::sleep_for(std::chrono::microseconds(mock::nvs_write_us));
+        return len;
+    }
+};
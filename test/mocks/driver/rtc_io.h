@@ -0,0 +1,5 @@
+#pragma once
+// Attrappe von ESP-IDF driver/rtc_io für power.cpp
+#include <esp_sleep.h>
+
+inline esp_err_t rtc_gpio_deinit(gpio_num_t pin) { (void)pin; return ESP_OK; }
@@ -0,0 +1,10 @@
+#pragma once
+// Attrappe von ESP-IDF heap_caps für telemetry.cpp
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+
+inline size_t heap_caps_get_free_size(uint32_t caps) { return caps & MALLOC_CAP_SPIRAM ? 4000000 : 200000; }
+inline size_t heap_caps_get_minimum_free_size(uint32_t caps) { return caps & MALLOC_CAP_SPIRAM ? 3900000 : 150000; }
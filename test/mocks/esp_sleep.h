@@ -0,0 +1,14 @@
+#pragma once
+// Attrappe von ESP-IDF esp_sleep für power.cpp; der Light Sleep kehrt sofort zurück
+#include <Arduino.h>
+
+typedef enum { GPIO_NUM_0 = 0 } gpio_num_t;
+typedef enum { ESP_EXT1_WAKEUP_ALL_LOW = 0, ESP_EXT1_WAKEUP_ANY_HIGH = 1 } esp_sleep_ext1_wakeup_mode_t;
+typedef enum { ESP_SLEEP_WAKEUP_ALL = 1, ESP_SLEEP_WAKEUP_EXT0 = 2, ESP_SLEEP_WAKEUP_EXT1 = 3 } esp_sleep_source_t;
+typedef esp_sleep_source_t esp_sleep_wakeup_cause_t;
+
+inline esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t pin, int level) { (void)pin; (void)level; return ESP_OK; }
+inline esp_err_t esp_sleep_enable_ext1_wakeup(uint64_t mask, esp_sleep_ext1_wakeup_mode_t mode) { (void)mask; (void)mode; return ESP_OK; }
+inline esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source) { (void)source; return ESP_OK; }
+inline esp_err_t esp_light_sleep_start() { return ESP_OK; }
+inline esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return ESP_SLEEP_WAKEUP_EXT1; }
@@ -0,0 +1,58 @@
+#pragma once
+// Attrappe von ESP-IDF esp_timer: periodische Timer laufen nicht selbst, sondern werden von
+// mock::timer_run() in simulierter Zeit ausgelöst
+#include <Arduino.h>
+
+typedef void (*esp_timer_cb_t)(void* arg);
+
+struct esp_timer_create_args_t {
+    esp_timer_cb_t callback;
+    void* arg;
+    int dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+};
+
+struct MockTimer {
+    esp_timer_cb_t callback;
+    void* arg;
+    uint64_t period_us;
+    uint64_t next_us;
+};
+typedef MockTimer* esp_timer_handle_t;
+
+namespace mock {
+inline std::vector<MockTimer*> timers;
+
+// Lässt die simulierte Zeit um 'ms' laufen und ruft dabei jeden fälligen Timer auf
+inline void timer_run(uint32_t ms) {
+    uint64_t end = now_us + (uint64_t)ms * 1000;
+    for (;;) {
+        MockTimer* next = nullptr;
+        for (MockTimer* t : timers) {
+            if (t->period_us && t->next_us <= end && (!next || t->next_us < next->next_us)) next = t;
+        }
+        if (!next) break;
+        now_us = next->next_us;
+        next->next_us += next->period_us;
+        next->callback(next->arg);
+    }
+    now_us = end;
+}
+}
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+    *handle = new MockTimer{args->callback, args->arg, 0, 0};
+    mock::timers.push_back(*handle);
+    return ESP_OK;
+}
+inline esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us) {
+    timer->period_us = period_us;
+    timer->next_us = mock::now_us + period_us;
+    return ESP_OK;
+}
+inline esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    timer->period_us = 0;
+    return ESP_OK;
+}
+inline int64_t esp_timer_get_time() { return (int64_t)mock::now_us; }
@@ -0,0 +1,174 @@
+#pragma once
+// Kleiner HTTP/ICY-Server für Host-Tests: lauscht auf 127.0.0.1 an einem freien Port und
+// beantwortet jede Anfrage nach einer festen Route (Statuszeile und Header, Body, danach auf
+// Wunsch Stream-Bytes mit bekanntem Muster). Jede Verbindung läuft in einem eigenen Thread.
+// Die Stream-Bytes laufen durch StreamFaultInjector: Bandbreite, Jitter, Stalls und Abbrüche
+// je Route. Weiterleitungsfehler (Schleifen, kaputtes Location) sind einfach Routen.
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "stream_fault.h"
+
+class IcyServer {
+public:
+    struct Route {
+        std::string head;            // Statuszeile und Header, je mit "\r\n", ohne Leerzeile
+        std::string body;            // direkt nach dem Header
+        size_t stream_bytes = 0;     // danach so viele Bytes streamByte(i)
+        StreamFaultConfig fault = noFaults();  // Störungen beim Senden der Stream-Bytes
+        uint32_t seed = 1;           // Zufall für den Jitter, je Verbindung um eins weitergezählt
+    };
+
+    // Ungestörtes Netz, unabhängig von den STREAM_FAULT_*-Flags des Builds
+    static StreamFaultConfig noFaults() {
+        StreamFaultConfig c;
+        c.bandwidth_kbps = 0;
+        c.jitter_ms = 0;
+        c.stall_every_s = 0;
+        c.disconnect_every_s = 0;
+        return c;
+    }
+
+    // Byte i des simulierten Streams
+    static uint8_t streamByte(size_t i) { return (uint8_t)(i * 7 + (i >> 9)); }
+
+    IcyServer() {
+        _fd = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(_fd, (sockaddr*)&addr, sizeof(addr));
+        listen(_fd, 16);
+        socklen_t len = sizeof(addr);
+        getsockname(_fd, (sockaddr*)&addr, &len);
+        _port = ntohs(addr.sin_port);
+        _accept = std::thread([this] { acceptLoop(); });
+    }
+
+    ~IcyServer() {
+        _stop = true;
+        _accept.join();
+        for (std::thread& t : _workers) t.join();
+        ::close(_fd);
+    }
+
+    void route(const std::string& path, const Route& r) {
+        std::lock_guard<std::mutex> g(_lock);
+        _routes[path] = r;
+    }
+
+    std::string url(const std::string& path) const {
+        return "http://127.0.0.1:" + std::to_string(_port) + path;
+    }
+    uint16_t port() const { return _port; }
+
+    // Angenommene Verbindungen und die Anfragen darauf (Anfragezeile und Header)
+    uint32_t connections() const { return _connections; }
+    std::vector<std::string> requests() {
+        std::lock_guard<std::mutex> g(_lock);
+        return _requests;
+    }
+
+private:
+    int _fd;
+    uint16_t _port = 0;
+    std::atomic<bool> _stop{false};
+    std::atomic<uint32_t> _connections{0};
+    std::thread _accept;
+    std::vector<std::thread> _workers;
+    std::mutex _lock;
+    std::map<std::string, Route> _routes;
+    std::vector<std::string> _requests;
+
+    static uint32_t now() {
+        using namespace std::chrono;
+        return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    void acceptLoop() {
+        while (!_stop) {
+            pollfd p = { _fd, POLLIN, 0 };
+            if (poll(&p, 1, 20) <= 0) continue;
+            int c = accept(_fd, nullptr, nullptr);
+            if (c < 0) continue;
+            _connections++;
+            _workers.emplace_back([this, c] { serve(c); });
+        }
+    }
+
+    bool sendAll(int c, const void* data, size_t len) {
+        const char* p = (const char*)data;
+        while (len > 0 && !_stop) {
+            pollfd w = { c, POLLOUT, 0 };
+            if (poll(&w, 1, 20) <= 0) continue;
+            ssize_t n = ::send(c, p, len, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            p += n;
+            len -= (size_t)n;
+        }
+        return len == 0;
+    }
+
+    void serve(int c) {
+        std::string req;
+        char buf[512];
+        while (req.find("\r\n\r\n") == std::string::npos && !_stop) {
+            pollfd p = { c, POLLIN, 0 };
+            if (poll(&p, 1, 20) <= 0) continue;
+            ssize_t n = recv(c, buf, sizeof(buf), 0);
+            if (n <= 0) break;
+            req.append(buf, (size_t)n);
+        }
+
+        Route r;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> g(_lock);
+            _requests.push_back(req);
+            size_t sp = req.find(' ');
+            size_t end = sp == std::string::npos ? sp : req.find(' ', sp + 1);
+            if (end != std::string::npos) {
+                auto it = _routes.find(req.substr(sp + 1, end - sp - 1));
+                if (it != _routes.end()) {
+                    r = it->second;
+                    found = true;
+                }
+            }
+        }
+        if (!found) r.head = "HTTP/1.0 404 Not Found\r\n";
+
+        std::string head = r.head + "\r\n" + r.body;
+        bool ok = sendAll(c, head.data(), head.size());
+        StreamFaultInjector fault(r.seed + _connections, r.fault);
+        fault.begin(now());
+        uint8_t chunk[1024];
+        for (size_t sent = 0; ok && sent < r.stream_bytes && !_stop;) {
+            bool cut;
+            size_t n = fault.allow(now(), (uint32_t)std::min(sizeof(chunk), r.stream_bytes - sent), cut);
+            if (cut) break;
+            if (n == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            for (size_t i = 0; i < n; i++) chunk[i] = streamByte(sent + i);
+            ok = sendAll(c, chunk, n);
+            fault.consumed(now(), (uint32_t)n);
+            sent += n;
+        }
+        ::close(c);
+    }
+};
@@ -0,0 +1,71 @@
+#pragma once
+// StreamTransport über einen echten TCP-Socket für Host-Tests (z.B. gegen IcyServer)
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+#include <chrono>
+#include <thread>
+
+#include "http_stream.h"
+
+class PosixTransport : public StreamTransport {
+public:
+    ~PosixTransport() override { close(); }
+
+    bool connect(const char* host, uint16_t port, uint32_t timeout_ms) override {
+        close();
+        addrinfo hints = {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* res = nullptr;
+        char service[8];
+        snprintf(service, sizeof(service), "%u", port);
+        if (getaddrinfo(host, service, &hints, &res) != 0 || !res) return false;
+        _fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        timeval tv = { (time_t)(timeout_ms / 1000), (suseconds_t)(timeout_ms % 1000) * 1000 };
+        if (_fd >= 0) setsockopt(_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        bool ok = _fd >= 0 && ::connect(_fd, res->ai_addr, res->ai_addrlen) == 0;
+        freeaddrinfo(res);
+        if (!ok) close();
+        connects++;
+        return ok;
+    }
+
+    bool send(const char* data, size_t len) override {
+        while (len > 0) {
+            ssize_t n = ::send(_fd, data, len, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            data += n;
+            len -= (size_t)n;
+        }
+        return true;
+    }
+
+    int32_t receive(uint8_t* dst, size_t len) override {
+        if (_fd < 0) return -1;
+        ssize_t n = recv(_fd, dst, len, MSG_DONTWAIT);
+        if (n > 0) return (int32_t)n;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return 0;
+        return -1;
+    }
+
+    void close() override {
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+    }
+
+    uint32_t millis() override {
+        using namespace std::chrono;
+        return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    void idle() override { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    uint32_t connects = 0;
+
+private:
+    int _fd = -1;
+};
@@ -0,0 +1,5 @@
+#pragma once
+// Attrappe der tas5805m-Bibliothek: nur die Konstanten, die settings.cpp braucht
+#define TAS5805M_VOLUME_DEFAULT 48
+#define TAS5805M_VOLUME_MIN 0
+#define TAS5805M_VOLUME_MAX 255
@@ -0,0 +1,127 @@
+// Bluetooth-Datenpfad: Effekte in-place auf dem Paketpuffer, aufgerufen wie vom A2DP-Stack
+#include <unity.h>
+#include <string.h>
+#include <vector>
+
+#include "a2dp_dsp.h"
+#include "bass_boost.h"
+#include "equalizer.h"
+
+#define PACKET_FRAMES 128  // typisches SBC-Paket
+
+static std::vector<int16_t> packet;
+
+void setUp() {
+    packet.resize(PACKET_FRAMES * 2);
+    uint32_t x = 11;
+    for (int16_t& s : packet) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        s = (int16_t)((int32_t)(x & 0x3FFF) - 0x2000);
+    }
+}
+
+void tearDown() {}
+
+static void enableBand(AudioEffectEQT<BiquadQ31>& eq) {
+    EQBand band = { BIQUAD_PEAKING, 1, 2000, 6.0f, 1.0f };
+    eq.SetBand(2, band);
+}
+
+// Die Kette im Stack liefert dasselbe wie die Effekte direkt hintereinander, im selben Puffer
+static void test_effects_run_in_place_in_order() {
+    AudioEffectBassBoostT<BiquadQ31> bass(nullptr, 9.0f), ref_bass(nullptr, 9.0f);
+    AudioEffectEQT<BiquadQ31> eq(nullptr), ref_eq(nullptr);
+    enableBand(eq);
+    enableBand(ref_eq);
+
+    A2DPDspVolumeControl volume;
+    TEST_ASSERT_TRUE(volume.addEffect(&bass));
+    TEST_ASSERT_TRUE(volume.addEffect(&eq));
+    volume.setSampleRate(44100);
+    ref_bass.SetRate(44100);
+    ref_eq.SetRate(44100);
+
+    A2DPVolumeControl& stack = volume;
+    for (int p = 0; p < 20; p++) {
+        std::vector<int16_t> ref = packet;
+        ref_bass.ProcessInPlace(ref.data(), PACKET_FRAMES);
+        ref_eq.ProcessInPlace(ref.data(), PACKET_FRAMES);
+
+        std::vector<int16_t> buf = packet;
+        stack.update_audio_data((uint8_t*)buf.data(), PACKET_FRAMES * 4);
+        TEST_ASSERT_EQUAL_INT16_ARRAY(ref.data(), buf.data(), PACKET_FRAMES * 2);
+    }
+}
+
+// Die Rate aus dem Callback des Stacks wird erst im Datenpfad übernommen
+static void test_rate_is_applied_in_data_path() {
+    AudioEffectBassBoostT<BiquadQ31> bass(nullptr);
+    A2DPDspVolumeControl volume;
+    volume.addEffect(&bass);
+
+    volume.setSampleRate(48000);
+    TEST_ASSERT_EQUAL(0, bass.GetRate());
+    A2DPVolumeControl& stack = volume;
+    stack.update_audio_data((uint8_t*)packet.data(), PACKET_FRAMES * 4);
+    TEST_ASSERT_EQUAL(48000, bass.GetRate());
+}
+
+// Lautstärke des Stacks zuerst, danach die Effekte
+static void test_volume_applies_before_effects() {
+    AudioEffectBassBoostT<BiquadQ31> bass(nullptr, 6.0f), ref_bass(nullptr, 6.0f);
+    A2DPDspVolumeControl volume;
+    volume.addEffect(&bass);
+    volume.setSampleRate(44100);
+    ref_bass.SetRate(44100);
+    volume.set_volume(64);
+
+    std::vector<int16_t> ref = packet;
+    for (int16_t& s : ref) s = (int16_t)((int32_t)s * (64 * 0x1000 / 127) / 0x1000);
+    ref_bass.ProcessInPlace(ref.data(), PACKET_FRAMES);
+
+    A2DPVolumeControl& stack = volume;
+    stack.update_audio_data((uint8_t*)packet.data(), PACKET_FRAMES * 4);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(ref.data(), packet.data(), PACKET_FRAMES * 2);
+}
+
+static void test_limits_and_empty_packets() {
+    AudioEffectBassBoostT<BiquadQ31> a(nullptr), b(nullptr), c(nullptr);
+    A2DPDspVolumeControl volume;
+    TEST_ASSERT_TRUE(volume.addEffect(&a));
+    TEST_ASSERT_TRUE(volume.addEffect(&b));
+    TEST_ASSERT_FALSE(volume.addEffect(&c));
+
+    volume.update_audio_data((Frame*)nullptr, PACKET_FRAMES);
+    std::vector<int16_t> buf = packet;
+    volume.update_audio_data((Frame*)(void*)buf.data(), 0);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(packet.data(), buf.data(), PACKET_FRAMES * 2);
+}
+
+// Ungerade ausgerichteter Paketpuffer: ohne DSP durchgereicht statt unausgerichtet gelesen
+static void test_misaligned_packet_is_passed_through() {
+    AudioEffectBassBoostT<BiquadQ31> bass(nullptr, 9.0f);
+    A2DPDspVolumeControl volume;
+    volume.addEffect(&bass);
+    volume.setSampleRate(44100);
+    A2DPVolumeControl& stack = volume;
+
+    std::vector<uint8_t> buf(PACKET_FRAMES * 4 + 2);
+    memcpy(buf.data() + 1, packet.data(), PACKET_FRAMES * 4);
+    stack.update_audio_data(buf.data() + 1, PACKET_FRAMES * 4);
+    TEST_ASSERT_EQUAL_MEMORY(packet.data(), buf.data() + 1, PACKET_FRAMES * 4);
+
+    // Derselbe Puffer ausgerichtet wird gefiltert
+    memcpy(buf.data(), packet.data(), PACKET_FRAMES * 4);
+    stack.update_audio_data(buf.data(), PACKET_FRAMES * 4);
+    TEST_ASSERT_NOT_EQUAL(0, memcmp(packet.data(), buf.data(), PACKET_FRAMES * 4));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_effects_run_in_place_in_order);
+    RUN_TEST(test_rate_is_applied_in_data_path);
+    RUN_TEST(test_volume_applies_before_effects);
+    RUN_TEST(test_limits_and_empty_packets);
+    RUN_TEST(test_misaligned_packet_is_passed_through);
+    return UNITY_END();
+}
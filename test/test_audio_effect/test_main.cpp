@@ -0,0 +1,146 @@
+// AudioEffectBlock: Einzel- und Block-Pfad, Gegendruck der Ausgabe, Weiterreichen des Formats
+#include <unity.h>
+#include <vector>
+
+#include "bass_boost.h"
+
+#define FRAMES 3000  // kein Vielfaches von DSP_BLOCK_FRAMES
+
+static std::vector<int16_t> input;
+
+void setUp() {
+    input.resize(FRAMES * 2);
+    uint32_t x = 7;
+    for (size_t i = 0; i < input.size(); i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        input[i] = (int16_t)((int32_t)(x & 0x3FFF) - 0x2000);
+    }
+}
+
+void tearDown() {}
+
+// Referenz: derselbe Filter ohne Ausgabe, in einem Stück
+static std::vector<int16_t> reference() {
+    std::vector<int16_t> out = input;
+    AudioEffectBassBoostT<BiquadQ31> bass(nullptr, 9.0f);
+    bass.SetRate(44100);
+    bass.ProcessInPlace(out.data(), FRAMES);
+    return out;
+}
+
+static void test_sample_path_matches_block_path() {
+    std::vector<int16_t> ref = reference();
+
+    AudioOutputCapture single;
+    AudioEffectBassBoostT<BiquadQ31> a(&single, 9.0f);
+    a.SetRate(44100);
+    std::vector<int16_t> work = input;
+    for (int i = 0; i < FRAMES; i++) TEST_ASSERT_TRUE(a.ConsumeSample(&work[2 * i]));
+    a.flush();
+
+    AudioOutputCapture block;
+    AudioEffectBassBoostT<BiquadQ31> b(&block, 9.0f);
+    b.SetRate(44100);
+    work = input;
+    TEST_ASSERT_EQUAL_UINT16(FRAMES, b.ConsumeSamples(work.data(), FRAMES));
+
+    TEST_ASSERT_EQUAL(FRAMES, single.frames());
+    TEST_ASSERT_EQUAL(FRAMES, block.frames());
+    TEST_ASSERT_EQUAL_INT16_ARRAY(ref.data(), single.samples.data(), FRAMES * 2);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(ref.data(), block.samples.data(), FRAMES * 2);
+    // Der Block-Pfad ruft die Ausgabe pro Block, nicht pro Sample
+    TEST_ASSERT_EQUAL_UINT32(0, block.single_calls);
+    TEST_ASSERT_EQUAL_UINT32((FRAMES + DSP_BLOCK_FRAMES - 1) / DSP_BLOCK_FRAMES, block.block_calls);
+}
+
+// Nimmt die Ausgabe nur einen Teil ab, darf der Rest weder verloren gehen noch doppelt gefiltert werden
+static void test_backpressure_keeps_order_and_filters_once() {
+    std::vector<int16_t> ref = reference();
+
+    AudioOutputCapture out;
+    out.accept = 100;
+    AudioEffectBassBoostT<BiquadQ31> bass(&out, 9.0f);
+    bass.SetRate(44100);
+
+    std::vector<int16_t> work = input;
+    uint32_t done = 0;
+    while (done < FRAMES) {
+        uint16_t n = FRAMES - done > 500 ? 500 : FRAMES - done;
+        done += bass.ConsumeSamples(&work[2 * done], n);
+        bass.loop();
+    }
+    for (int i = 0; i < 100 && out.frames() < FRAMES; i++) bass.loop();
+
+    TEST_ASSERT_EQUAL(FRAMES, out.frames());
+    TEST_ASSERT_EQUAL_INT16_ARRAY(ref.data(), out.samples.data(), FRAMES * 2);
+}
+
+static void test_sample_path_reports_full_output() {
+    AudioOutputCapture out;
+    out.accept = 0;
+    AudioEffectBassBoostT<BiquadQ31> bass(&out, 0.0f);
+    std::vector<int16_t> work = input;
+
+    // Ein voller Block wird gesammelt, danach meldet ConsumeSample() Gegendruck an den Decoder
+    int accepted = 0;
+    while (accepted < FRAMES && bass.ConsumeSample(&work[2 * accepted])) accepted++;
+    TEST_ASSERT_EQUAL(DSP_BLOCK_FRAMES, accepted);
+
+    out.accept = 0xFFFF;
+    TEST_ASSERT_TRUE(bass.ConsumeSample(&work[2 * accepted]));
+    TEST_ASSERT_EQUAL(DSP_BLOCK_FRAMES, out.frames());
+}
+
+static void test_format_and_stop_reach_next_stage() {
+    AudioOutputCapture out;
+    AudioEffectBassBoostT<BiquadQ31> bass(&out);
+    TEST_ASSERT_TRUE(bass.begin());
+    bass.SetRate(48000);
+    TEST_ASSERT_EQUAL(48000, out.rate());
+    TEST_ASSERT_EQUAL(48000, bass.GetRate());
+    TEST_ASSERT_TRUE(bass.stop());
+    TEST_ASSERT_EQUAL_UINT32(1, out.stops);
+}
+
+static void test_bypass_passes_frames_unchanged() {
+    AudioOutputCapture out;
+    AudioEffectBassBoostT<BiquadQ31> bass(&out, 12.0f);
+    bass.SetBypass(true);
+    std::vector<int16_t> work = input;
+    bass.ConsumeSamples(work.data(), FRAMES);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(input.data(), out.samples.data(), FRAMES * 2);
+}
+
+// Nach dem Abbau der Radio-Ausgabe hängt die Stufe ohne Nachfolger; Daten werden verworfen
+static void test_without_next_stage_drops_frames() {
+    AudioOutputCapture out;
+    out.accept = 0;
+    AudioEffectBassBoostT<BiquadQ31> bass(&out, 9.0f);
+    std::vector<int16_t> work = input;
+    bass.ConsumeSamples(work.data(), 500);  // bleibt im Sammelblock hängen
+
+    bass.SetNext(nullptr);
+    TEST_ASSERT_EQUAL_UINT16(FRAMES, bass.ConsumeSamples(work.data(), FRAMES));
+    TEST_ASSERT_TRUE(bass.ConsumeSample(&work[0]));
+    bass.flush();
+    TEST_ASSERT_TRUE(bass.loop());
+
+    // Wieder angehängt: nur, was danach kommt, erreicht die Ausgabe
+    out.accept = 0xFFFF;
+    bass.stop();
+    bass.SetNext(&out);
+    work = input;
+    TEST_ASSERT_EQUAL_UINT16(FRAMES, bass.ConsumeSamples(work.data(), FRAMES));
+    TEST_ASSERT_EQUAL(FRAMES, out.frames());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_sample_path_matches_block_path);
+    RUN_TEST(test_backpressure_keeps_order_and_filters_once);
+    RUN_TEST(test_sample_path_reports_full_output);
+    RUN_TEST(test_format_and_stop_reach_next_stage);
+    RUN_TEST(test_bypass_passes_frames_unchanged);
+    RUN_TEST(test_without_next_stage_drops_frames);
+    return UNITY_END();
+}
@@ -0,0 +1,104 @@
+// Bass-Shelf: Frequenzgang bei den Abtastraten der Tabelle, Ratenwechsel ohne Sprung
+#include <unity.h>
+#include <complex>
+#include <algorithm>
+#include <vector>
+
+#include "bass_boost.h"
+
+void setUp() {}
+void tearDown() {}
+
+static double shelfDb(float gain_db, double freq, double rate) {
+    BiquadCoefficients k;
+    biquad_design(k, BIQUAD_LOWSHELF, 200, gain_db, BIQUAD_Q_BUTTERWORTH, rate);
+    std::complex<double> z1 = std::polar(1.0, -2.0 * M_PI * freq / rate);
+    std::complex<double> z2 = z1 * z1;
+    std::complex<double> h = ((double)k.b0 + (double)k.b1 * z1 + (double)k.b2 * z2) /
+                             (1.0 + (double)k.a1 * z1 + (double)k.a2 * z2);
+    return 20.0 * log10(std::abs(h));
+}
+
+static void sine(std::vector<int16_t>& frames, long start, double freq, int rate) {
+    for (size_t i = 0; i < frames.size() / 2; i++) {
+        frames[2 * i] = frames[2 * i + 1] = (int16_t)lrint(4000.0 * sin(2.0 * M_PI * freq * (start + i) / rate));
+    }
+}
+
+// Pegel eines Sinus hinter dem Filter, nach einer Sekunde Einschwingen (samt Überblendung), in dB
+template <class Kernel>
+static double measuredDb(AudioEffectBassBoostT<Kernel>& bass, double freq, int rate) {
+    bass.SetRate(rate);
+    std::vector<int16_t> frames(rate * 2);
+    sine(frames, 0, freq, rate);
+    bass.ProcessInPlace(frames.data(), rate);
+    sine(frames, rate, freq, rate);
+    double in_sq = 0, out_sq = 0;
+    for (int16_t x : frames) in_sq += (double)x * x;
+    bass.ProcessInPlace(frames.data(), rate);
+    for (int16_t x : frames) out_sq += (double)x * x;
+    return 10.0 * log10(out_sq / in_sq);
+}
+
+static void test_rate_index_picks_nearest_column() {
+    TEST_ASSERT_EQUAL_UINT32(32000, dsp_rates[dsp_rate_index(32000)]);
+    TEST_ASSERT_EQUAL_UINT32(44100, dsp_rates[dsp_rate_index(44100)]);
+    TEST_ASSERT_EQUAL_UINT32(48000, dsp_rates[dsp_rate_index(48000)]);
+    TEST_ASSERT_EQUAL_UINT32(22050, dsp_rates[dsp_rate_index(16000)]);
+    TEST_ASSERT_EQUAL_UINT32(48000, dsp_rates[dsp_rate_index(96000)]);
+    TEST_ASSERT_EQUAL_UINT32(44100, dsp_rates[dsp_rate_index(44000)]);
+}
+
+// Die Eckfrequenz muss bei jeder Rate 200 Hz bleiben, nicht mit der Rate wandern
+template <class Kernel>
+static void responseAtRates() {
+    const int rates[] = { 32000, 44100, 48000 };
+    const double freqs[] = { 50, 200, 1000 };
+    for (int rate : rates) {
+        AudioEffectBassBoostT<Kernel> bass(nullptr, 9.0f);
+        for (double f : freqs) {
+            TEST_ASSERT_FLOAT_WITHIN(0.05f, (float)shelfDb(9.0f, f, rate), (float)measuredDb(bass, f, rate));
+        }
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, 4.5f, (float)measuredDb(bass, 200, rate));
+    }
+}
+
+static void test_response_at_rates_q31() { responseAtRates<BiquadQ31>(); }
+static void test_response_at_rates_float() { responseAtRates<BiquadFloat>(); }
+
+// Ratenwechsel schlägt nur nach und blendet über: der erste Teilblock rechnet noch mit der alten Spalte
+static void test_rate_change_is_ramped() {
+    AudioEffectBassBoostT<BiquadQ31> bass(nullptr, 12.0f), reference(nullptr, 12.0f);
+    bass.SetRate(44100);
+    reference.SetRate(44100);
+
+    std::vector<int16_t> a(4410 * 2), b;
+    sine(a, 0, 100, 44100);
+    b = a;
+    bass.ProcessInPlace(a.data(), 4410);
+    reference.ProcessInPlace(b.data(), 4410);
+
+    bass.SetRate(48000);
+    sine(a, 4410, 100, 44100);
+    b = a;
+    bass.ProcessInPlace(a.data(), 4410);
+    reference.ProcessInPlace(b.data(), 4410);
+
+    TEST_ASSERT_EQUAL_INT16_ARRAY(b.data(), a.data(), DSP_RAMP_STEP_FRAMES * 2);
+    // Kein Sprung am Übergang: die größte Änderung zwischen zwei Samples bleibt die des Sinus selbst
+    int max_step = 0, max_step_ref = 0;
+    for (int i = 1; i < 4410; i++) {
+        max_step = std::max(max_step, abs(a[2 * i] - a[2 * (i - 1)]));
+        max_step_ref = std::max(max_step_ref, abs(b[2 * i] - b[2 * (i - 1)]));
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(max_step_ref * 11 / 10, max_step);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_rate_index_picks_nearest_column);
+    RUN_TEST(test_response_at_rates_q31);
+    RUN_TEST(test_response_at_rates_float);
+    RUN_TEST(test_rate_change_is_ramped);
+    return UNITY_END();
+}
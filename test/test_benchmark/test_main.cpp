@@ -0,0 +1,328 @@
+// Benchmarks der Host-Module mit Grenzwerten: "pio test -e native -f test_benchmark".
+// Jede Messung meldet ns/Sample (Sample = Stereo-Frame wie bei AudioOutput::ConsumeSample)
+// bzw. Ereignisse/s und schlägt fehl, wenn sie schlechter ist als ihre Grenze. Die Grenzen liegen
+// großzügig über den Werten eines aktuellen x86-Rechners, damit nur echte Rückschritte auffallen;
+// -D BENCH_LIMIT_SCALE=N lockert alle Grenzen um den Faktor N.
+#include <unity.h>
+#include <chrono>
+
+#include "bass_boost.h"
+#include "equalizer.h"
+#include "a2dp_dsp.h"
+#include "drift_resampler.h"
+#include "input_classifier.h"
+#include "jitter_buffer.h"
+#include "volume_engine.h"
+#include "timeshift.h"
+#include "stream_format.h"
+#include "power_governor.h"
+#include "telemetry.h"
+
+#ifndef BENCH_LIMIT_SCALE
+#define BENCH_LIMIT_SCALE 1
+#endif
+// Mindestdauer einer Messung; gewertet wird der beste von drei Durchgängen
+#define BENCH_MIN_NS 20000000.0
+
+#define BENCH_FRAMES 1152
+
+static int16_t input[BENCH_FRAMES * 2];
+static int16_t work[BENCH_FRAMES * 2];
+
+void setUp() {
+    // Rauschen mit -6 dBFS, reproduzierbar
+    uint32_t x = 1;
+    for (int i = 0; i < BENCH_FRAMES * 2; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        input[i] = (int16_t)((int32_t)(x & 0xFFFF) - 32768) / 2;
+    }
+}
+
+void tearDown() {}
+
+static double nowNs() {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Ruft fn() wiederholt auf und liefert die beste mittlere Dauer eines Aufrufs in ns
+template <class F>
+static double measure(F fn) {
+    double best = 1e30;
+    for (int pass = 0; pass < 3; pass++) {
+        uint32_t calls = 0;
+        double start = nowNs();
+        double elapsed;
+        do {
+            fn();
+            calls++;
+            elapsed = nowNs() - start;
+        } while (elapsed < BENCH_MIN_NS / 3);
+        if (elapsed / calls < best) best = elapsed / calls;
+    }
+    return best;
+}
+
+static void gateNs(const char* name, double ns_per_sample, double limit) {
+    limit *= BENCH_LIMIT_SCALE;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s: %.2f ns/Sample (Grenze %.0f)", name, ns_per_sample, limit);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(ns_per_sample <= limit, msg);
+}
+
+static void gateRate(const char* name, double per_second, double limit) {
+    limit /= BENCH_LIMIT_SCALE;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s: %.0f Ereignisse/s (Grenze %.0f)", name, per_second, limit);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(per_second >= limit, msg);
+}
+
+// Nimmt alles ab und verwirft es, damit nur die Effekt-Stufe gemessen wird
+class NullOutput : public AudioOutput {
+public:
+    int32_t sink = 0;
+    bool ConsumeSample(int16_t sample[2]) override { sink += sample[0]; return true; }
+    uint16_t ConsumeSamples(int16_t* frames, uint16_t count) override { sink += frames[0]; return count; }
+};
+
+template <class Effect>
+static double effectNs(Effect& effect) {
+    effect.SetRate(44100);
+    return measure([&] {
+        memcpy(work, input, sizeof(work));
+        effect.ProcessInPlace(work, BENCH_FRAMES);
+    }) / BENCH_FRAMES;
+}
+
+static void test_bass_q31() {
+    AudioEffectBassBoostT<BiquadQ31> bass(nullptr, 6.0f);
+    gateNs("Bass Q31", effectNs(bass), 80);
+}
+
+static void test_bass_float() {
+    AudioEffectBassBoostT<BiquadFloat> bass(nullptr, 6.0f);
+    gateNs("Bass Float", effectNs(bass), 80);
+}
+
+template <class Kernel>
+static void enableAllBands(AudioEffectEQT<Kernel>& eq) {
+    for (uint8_t i = 0; i < EQ_MAX_BANDS; i++) {
+        EQBand band = eq.GetBand(i);
+        band.enabled = 1;
+        band.gain_db = 3.0f;
+        eq.SetBand(i, band);
+    }
+}
+
+static void test_eq_q31_5_bands() {
+    AudioEffectEQT<BiquadQ31> eq(nullptr);
+    enableAllBands(eq);
+    gateNs("EQ Q31, 5 Bänder", effectNs(eq), 400);
+}
+
+static void test_eq_float_5_bands() {
+    AudioEffectEQT<BiquadFloat> eq(nullptr);
+    enableAllBands(eq);
+    gateNs("EQ Float, 5 Bänder", effectNs(eq), 400);
+}
+
+// Der alte Pro-Sample-Pfad (ConsumeSample) gegen den Block-Pfad (ConsumeSamples), samt Weitergabe
+static void test_sample_vs_block_path() {
+    NullOutput out;
+    AudioEffectBassBoostT<BiquadQ31> bass(&out, 6.0f);
+    bass.SetRate(44100);
+
+    double single = measure([&] {
+        for (int i = 0; i < BENCH_FRAMES; i++) bass.ConsumeSample(&work[2 * i]);
+    }) / BENCH_FRAMES;
+    double block = measure([&] {
+        memcpy(work, input, sizeof(work));
+        bass.ConsumeSamples(work, BENCH_FRAMES);
+    }) / BENCH_FRAMES;
+
+    gateNs("Bass Q31 über ConsumeSample", single, 100);
+    gateNs("Bass Q31 über ConsumeSamples", block, 100);
+}
+
+static void test_a2dp_packet() {
+    AudioEffectBassBoostT<BiquadQ31> bass(nullptr, 6.0f);
+    AudioEffectEQT<BiquadQ31> eq(nullptr);
+    enableAllBands(eq);
+    A2DPDspVolumeControl volume;
+    volume.addEffect(&bass);
+    volume.addEffect(&eq);
+    volume.setSampleRate(44100);
+
+    // Ein typisches SBC-Paket: 128 Stereo-Frames, aufgerufen wie vom Stack über die Basisklasse
+    A2DPVolumeControl& stack = volume;
+    double ns = measure([&] {
+        memcpy(work, input, 128 * 4);
+        stack.update_audio_data((uint8_t*)work, 128 * 4);
+    }) / 128;
+    gateNs("A2DP-Paket (Bass + EQ)", ns, 500);
+}
+
+static void test_drift_resampler() {
+    DriftResampler rs;
+    rs.setPpm(500);
+    static int16_t out[(BENCH_FRAMES + 8) * 2];
+    double ns = measure([&] {
+        uint16_t done = 0;
+        while (done < BENCH_FRAMES) {
+            uint16_t consumed;
+            rs.process(input + 2 * done, BENCH_FRAMES - done, consumed, out, BENCH_FRAMES + 8);
+            done += consumed;
+        }
+    }) / BENCH_FRAMES;
+    gateNs("Drift-Resampler", ns, 120);
+}
+
+static void test_button_classifier() {
+    ButtonClassifier buttons;
+    InputEvent ev;
+    uint32_t t = 0;
+    const int n = 10000;
+    double ns = measure([&] {
+        // Drücken, Halten, Loslassen im 5-ms-Takt
+        for (int i = 0; i < n; i++, t += 5) buttons.feed((i / 200) % 2 ? 350 : 3000, t, ev);
+    });
+    gateRate("Tasten-Klassifizierung (ADC-Werte)", n * 1e9 / ns, 2e7);
+}
+
+static void test_jitter_buffer() {
+    JitterBuffer jb;
+    jb.begin(16000, 480000);
+    uint32_t t = 1;
+    const int n = 10000;
+    double ns = measure([&] {
+        for (int i = 0; i < n; i++) {
+            t += 8 + (i % 7);
+            jb.onArrival(t, 1460);
+            jb.update(20000 + (i % 100) * 100, false);
+        }
+    });
+    gateRate("Jitter-Puffer (Ankunft + Abfrage)", n * 1e9 / ns, 5e6);
+}
+
+class NullSink : public VolumeSink {
+public:
+    int32_t code(float db, bool mute) const override { return mute ? -1 : (int32_t)(db * 2); }
+    bool write(int32_t code) override { (void)code; return true; }
+};
+
+static void test_volume_engine() {
+    NullSink sink;
+    VolumeEngine volume;
+    volume.route(&sink, 60);
+    const int n = 10000;
+    double ns = measure([&] {
+        for (int i = 0; i < n; i++) {
+            volume.step((i & 8) ? 1 : -1);
+            volume.tick();
+        }
+    });
+    gateRate("Lautstärke (Raste + Zeitscheibe)", n * 1e9 / ns, 2e6);
+}
+
+// MPEG-1 Layer III, 128 kbit/s, 44,1 kHz: 417 Bytes pro Frame, 26,1 ms
+static uint32_t buildMp3(uint8_t* dst, uint32_t frames) {
+    for (uint32_t f = 0; f < frames; f++) {
+        uint8_t* p = dst + f * 417;
+        memset(p, (uint8_t)f, 417);
+        p[0] = 0xFF; p[1] = 0xFB; p[2] = 0x90; p[3] = 0x00;
+    }
+    return frames * 417;
+}
+
+static void test_timeshift() {
+    static uint8_t mem[1 << 20];
+    static TimeshiftFrame index[4096];
+    static uint8_t stream[417 * 240];
+    uint32_t len = buildMp3(stream, 240);
+
+    TimeshiftHistory ts;
+    ts.init(mem, sizeof(mem), index, 4096);
+    double append_ns = measure([&] {
+        for (uint32_t off = 0; off < len; off += 1024) {
+            ts.append(stream + off, len - off < 1024 ? len - off : 1024);
+        }
+    });
+    gateRate("Zeitversatz: Frames indiziert", 240 * 1e9 / append_ns, 2e6);
+
+    int32_t dir = -1;
+    double seek_ns = measure([&] {
+        for (int i = 0; i < 100; i++) {
+            ts.seek(dir * 10000);
+            dir = -dir;
+        }
+    }) / 100;
+    gateRate("Zeitversatz: Sprünge", 1e9 / seek_ns, 3e5);
+}
+
+static void test_playlist() {
+    static char text[8192];
+    size_t len = 0;
+    len += snprintf(text + len, sizeof(text) - len, "#EXTM3U\n");
+    for (int i = 0; i < 50; i++) {
+        len += snprintf(text + len, sizeof(text) - len,
+                        "#EXTINF:-1 button=\"%d\",Sender %d\nhttp://stream%d.example.com:8000/live.mp3\n",
+                        i % 4, i, i);
+    }
+    double ns = measure([&] {
+        PlaylistReader reader(text, len);
+        PlaylistEntry entry;
+        while (reader.next(entry)) {}
+    });
+    gateRate("M3U-Einträge gelesen", 50 * 1e9 / ns, 4e5);
+}
+
+static void test_power_governor() {
+    PowerGovernor governor;
+    const int n = 10000;
+    double ns = measure([&] {
+        for (int i = 0; i < n; i++) governor.update((i % 50) * 1000000u, 500000, 80);
+    });
+    gateRate("Takt-Regler (Fenster)", n * 1e9 / ns, 1.5e7);
+}
+
+// Aufzeichnen im Audio- bzw. Bluetooth-Task; der Audio-Task zeichnet höchstens etwa 1000-mal pro
+// Sekunde auf (ein Decoder-Durchlauf je Tick), daraus der Anteil an einem Kern
+static void test_telemetry() {
+    const int n = 10000;
+    uint32_t cycles = 0;
+    double decode_ns = measure([&] {
+        for (int i = 0; i < n; i++) telemetry_decode(cycles += 12345);
+    }) / n;
+    gateRate("Telemetrie: telemetry_decode", 1e9 / decode_ns, 4e6);
+    double packet_ns = measure([&] {
+        for (int i = 0; i < n; i++) telemetry_a2dp_packet();
+    }) / n;
+    gateRate("Telemetrie: telemetry_a2dp_packet", 1e9 / packet_ns, 1e7);
+
+    // 1000 Aufzeichnungen pro Sekunde als Anteil an einem Kern
+    char msg[96];
+    snprintf(msg, sizeof(msg), "Telemetrie: %.4f %% eines Kerns bei 1000 Aufrufen/s",
+             (decode_ns > packet_ns ? decode_ns : packet_ns) * 1000 / 1e9 * 100);
+    TEST_MESSAGE(msg);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bass_q31);
+    RUN_TEST(test_bass_float);
+    RUN_TEST(test_eq_q31_5_bands);
+    RUN_TEST(test_eq_float_5_bands);
+    RUN_TEST(test_sample_vs_block_path);
+    RUN_TEST(test_a2dp_packet);
+    RUN_TEST(test_drift_resampler);
+    RUN_TEST(test_button_classifier);
+    RUN_TEST(test_jitter_buffer);
+    RUN_TEST(test_volume_engine);
+    RUN_TEST(test_timeshift);
+    RUN_TEST(test_playlist);
+    RUN_TEST(test_power_governor);
+    RUN_TEST(test_telemetry);
+    return UNITY_END();
+}
@@ -0,0 +1,264 @@
+// Filterentwurf und Rechenkerne gegen Referenz-Frequenzgänge
+#include <unity.h>
+#include <complex>
+#include <math.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#include "biquad.h"
+
+#define RATE 44100.0f
+
+void setUp() {}
+void tearDown() {}
+
+// Betrag des Frequenzgangs der Koeffizienten bei 'freq' in dB
+static double responseDb(const BiquadCoefficients& k, double freq, double rate = RATE) {
+    std::complex<double> z1 = std::polar(1.0, -2.0 * M_PI * freq / rate);
+    std::complex<double> z2 = z1 * z1;
+    std::complex<double> h = ((double)k.b0 + (double)k.b1 * z1 + (double)k.b2 * z2) /
+                             (1.0 + (double)k.a1 * z1 + (double)k.a2 * z2);
+    return 20.0 * log10(std::abs(h));
+}
+
+// Gemessener Pegel eines Sinus bei 'freq' hinter dem Kern, nach dem Einschwingen, in dB
+template <class Kernel>
+static double measuredDb(const BiquadCoefficients& k, double freq) {
+    typename Kernel::Coeffs c;
+    Kernel::load(c, k);
+    typename Kernel::State s;
+    const double amp = 4000.0;
+    const int settle = (int)(RATE / 2), len = (int)RATE;
+    double in_sq = 0, out_sq = 0;
+    for (int i = 0; i < settle + len; i++) {
+        int16_t x = (int16_t)lrint(amp * sin(2.0 * M_PI * freq * i / RATE));
+        int16_t y = Kernel::toPcm(Kernel::step(c, s, Kernel::fromPcm(x)));
+        if (i >= settle) {
+            in_sq += (double)x * x;
+            out_sq += (double)y * y;
+        }
+    }
+    return 10.0 * log10(out_sq / in_sq);
+}
+
+static void test_lowshelf_reference_points() {
+    BiquadCoefficients k;
+    biquad_design(k, BIQUAD_LOWSHELF, 200, 6.0f, BIQUAD_Q_BUTTERWORTH, RATE);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 6.0f, (float)responseDb(k, 0.0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 3.0f, (float)responseDb(k, 200.0));  // halber Gain an der Eckfrequenz
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, (float)responseDb(k, RATE / 2));
+}
+
+static void test_highshelf_reference_points() {
+    BiquadCoefficients k;
+    biquad_design(k, BIQUAD_HIGHSHELF, 8000, -9.0f, BIQUAD_Q_BUTTERWORTH, RATE);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, (float)responseDb(k, 0.0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -4.5f, (float)responseDb(k, 8000.0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -9.0f, (float)responseDb(k, RATE / 2));
+}
+
+static void test_peaking_reference_points() {
+    BiquadCoefficients k;
+    biquad_design(k, BIQUAD_PEAKING, 1000, 12.0f, 1.0f, RATE);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 12.0f, (float)responseDb(k, 1000.0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, (float)responseDb(k, 0.0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, (float)responseDb(k, RATE / 2));
+    // Symmetrisch um die Mittenfrequenz (logarithmisch)
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, (float)responseDb(k, 500.0), (float)responseDb(k, 2000.0));
+}
+
+static void test_highpass_reference_points() {
+    BiquadCoefficients k;
+    biquad_design(k, BIQUAD_HIGHPASS, 80, 0.0f, BIQUAD_Q_BUTTERWORTH, RATE);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, -3.01f, (float)responseDb(k, 80.0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, (float)responseDb(k, 5000.0));
+    // Zweite Ordnung: 12 dB pro Oktave unterhalb der Eckfrequenz
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, -24.0f, (float)responseDb(k, 20.0));
+}
+
+// Beide Kerne müssen den Frequenzgang ihrer Koeffizienten auch tatsächlich rechnen
+static void test_kernels_follow_design_response() {
+    BiquadCoefficients k;
+    biquad_design(k, BIQUAD_LOWSHELF, 150, 10.0f, BIQUAD_Q_BUTTERWORTH, RATE);
+    const double freqs[] = { 40, 150, 1000, 8000 };
+    for (double f : freqs) {
+        double expected = responseDb(k, f);
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, (float)expected, (float)measuredDb<BiquadFloat>(k, f));
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, (float)expected, (float)measuredDb<BiquadQ31>(k, f));
+    }
+}
+
+// Referenz: Direct Form I in double mit Zustand in double und denselben (Float-)Koeffizienten,
+// erst am Ausgang auf int16 gerundet und begrenzt
+struct BiquadDoubleRef {
+    double b0, b1, b2, a1, a2;
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+    explicit BiquadDoubleRef(const BiquadCoefficients& k)
+        : b0(k.b0), b1(k.b1), b2(k.b2), a1(k.a1), a2(k.a2) {}
+
+    int16_t step(int16_t in) {
+        double x = in;
+        double y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+        x2 = x1; x1 = x;
+        y2 = y1; y1 = y;
+        long r = lrint(y);
+        return (int16_t)(r > 32767 ? 32767 : r < -32768 ? -32768 : r);
+    }
+};
+
+// Prüfsignal: logarithmischer Sinus-Sweep 20 Hz bis 20 kHz über eine Sekunde, dann eine Sekunde
+// Rauschen; Pegel so, dass +12 dB nicht übersteuern
+static std::vector<int16_t> sweepAndNoise() {
+    std::vector<int16_t> sig;
+    const double f0 = 20.0, f1 = 20000.0, len = RATE;
+    const double k = log(f1 / f0);
+    for (int i = 0; i < (int)len; i++) {
+        double phase = 2.0 * M_PI * f0 * len / RATE / k * (exp(k * i / len) - 1.0);
+        sig.push_back((int16_t)lrint(7000.0 * sin(phase)));
+    }
+    uint32_t x = 3;
+    for (int i = 0; i < (int)RATE; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        sig.push_back((int16_t)((int32_t)(x & 0x3FFF) - 0x2000));
+    }
+    return sig;
+}
+
+// Größte Abweichung eines Kerns von der double-Referenz in LSB
+template <class Kernel>
+static int maxLsbVsReference(const BiquadCoefficients& k, const std::vector<int16_t>& sig) {
+    typename Kernel::Coeffs c;
+    Kernel::load(c, k);
+    typename Kernel::State s;
+    BiquadDoubleRef ref(k);
+    int max_diff = 0;
+    for (int16_t in : sig) {
+        int y = Kernel::toPcm(Kernel::step(c, s, Kernel::fromPcm(in)));
+        int d = abs(y - ref.step(in));
+        if (d > max_diff) max_diff = d;
+    }
+    return max_diff;
+}
+
+// Q31 rechnet jedes Sample bis auf 1 LSB wie die double-Referenz, auch bei 40 Hz und +12 dB
+static void test_q31_matches_double_reference() {
+    struct Case { BiquadType type; float freq, gain, q; };
+    const Case cases[] = {
+        { BIQUAD_LOWSHELF, 40, 12.0f, BIQUAD_Q_BUTTERWORTH },  // tiefste Ecke, größte Überhöhung
+        { BIQUAD_LOWSHELF, 150, 10.0f, BIQUAD_Q_BUTTERWORTH },
+        { BIQUAD_PEAKING, 1000, 12.0f, 1.0f },
+        { BIQUAD_PEAKING, 60, -12.0f, 2.0f },
+        { BIQUAD_HIGHSHELF, 8000, -9.0f, BIQUAD_Q_BUTTERWORTH },
+        { BIQUAD_HIGHPASS, 80, 0.0f, BIQUAD_Q_BUTTERWORTH },
+    };
+    std::vector<int16_t> sig = sweepAndNoise();
+    for (const Case& c : cases) {
+        BiquadCoefficients k;
+        biquad_design(k, c.type, c.freq, c.gain, c.q, RATE);
+        int q31 = maxLsbVsReference<BiquadQ31>(k, sig);
+        int flt = maxLsbVsReference<BiquadFloat>(k, sig);
+        char msg[96];
+        snprintf(msg, sizeof(msg), "Typ %d, %.0f Hz, %+.0f dB: Q31 %d LSB, Float %d LSB",
+                 (int)c.type, c.freq, c.gain, q31, flt);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(1, q31, msg);
+    }
+}
+
+// Q31 und Float dürfen sich bei tiefer Eckfrequenz und +12 dB nur um wenige LSB unterscheiden
+static void test_q31_matches_float() {
+    BiquadCoefficients k;
+    biquad_design(k, BIQUAD_LOWSHELF, 40, 12.0f, BIQUAD_Q_BUTTERWORTH, RATE);
+    BiquadFloat::Coeffs cf;
+    BiquadQ31::Coeffs cq;
+    BiquadFloat::load(cf, k);
+    BiquadQ31::load(cq, k);
+    BiquadFloat::State sf;
+    BiquadQ31::State sq;
+
+    uint32_t x = 3;
+    int max_diff = 0;
+    for (int i = 0; i < 44100; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        int16_t in = (int16_t)((int32_t)(x & 0x1FFF) - 0x1000);
+        int yf = BiquadFloat::toPcm(BiquadFloat::step(cf, sf, BiquadFloat::fromPcm(in)));
+        int yq = BiquadQ31::toPcm(BiquadQ31::step(cq, sq, BiquadQ31::fromPcm(in)));
+        if (abs(yf - yq) > max_diff) max_diff = abs(yf - yq);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(4, max_diff);
+}
+
+// Fehlerrückführung: ein Gleichanteil kommt bei 40 Hz Eckfrequenz ohne Drift heraus
+static void test_q31_dc_gain_is_exact() {
+    BiquadCoefficients k;
+    biquad_design(k, BIQUAD_LOWSHELF, 40, 6.0f, BIQUAD_Q_BUTTERWORTH, RATE);
+    BiquadQ31::Coeffs c;
+    BiquadQ31::load(c, k);
+    BiquadQ31::State s;
+    int16_t y = 0;
+    for (int i = 0; i < 88200; i++) y = BiquadQ31::toPcm(BiquadQ31::step(c, s, BiquadQ31::fromPcm(1000)));
+    TEST_ASSERT_INT_WITHIN(1, (int)lrint(1000 * pow(10, 6.0 / 20)), y);
+}
+
+static void test_q31_saturates_instead_of_wrapping() {
+    BiquadCoefficients k;
+    biquad_design(k, BIQUAD_LOWSHELF, 200, 12.0f, BIQUAD_Q_BUTTERWORTH, RATE);
+    BiquadQ31::Coeffs c;
+    BiquadQ31::load(c, k);
+    BiquadQ31::State s;
+    int16_t y = 0;
+    for (int i = 0; i < 4410; i++) y = BiquadQ31::toPcm(BiquadQ31::step(c, s, BiquadQ31::fromPcm(30000)));
+    TEST_ASSERT_EQUAL_INT16(32767, y);
+    for (int i = 0; i < 4410; i++) y = BiquadQ31::toPcm(BiquadQ31::step(c, s, BiquadQ31::fromPcm(-30000)));
+    TEST_ASSERT_EQUAL_INT16(-32768, y);
+}
+
+// Der Leser darf nie eine halb geschriebene Kopie übernehmen und nie rückwärts laufen
+struct MailboxPayload {
+    uint32_t v[64];
+};
+
+static void test_mailbox_never_tears() {
+    static CoeffMailbox<MailboxPayload> mailbox;
+    const uint32_t count = 200000;
+    std::thread writer([&] {
+        MailboxPayload p;
+        for (uint32_t i = 1; i <= count; i++) {
+            for (uint32_t& x : p.v) x = i;
+            mailbox.publish(p);
+        }
+    });
+
+    MailboxPayload got;
+    uint32_t last = 0, fetched = 0, torn = 0, backwards = 0;
+    while (last < count) {
+        if (!mailbox.fetch(got)) continue;
+        fetched++;
+        for (uint32_t x : got.v) torn += x != got.v[0];
+        backwards += got.v[0] <= last;
+        last = got.v[0];
+    }
+    writer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL_UINT32(0, backwards);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, fetched);
+    TEST_ASSERT_FALSE(mailbox.fetch(got));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_lowshelf_reference_points);
+    RUN_TEST(test_highshelf_reference_points);
+    RUN_TEST(test_peaking_reference_points);
+    RUN_TEST(test_highpass_reference_points);
+    RUN_TEST(test_kernels_follow_design_response);
+    RUN_TEST(test_q31_matches_double_reference);
+    RUN_TEST(test_q31_matches_float);
+    RUN_TEST(test_q31_dc_gain_is_exact);
+    RUN_TEST(test_q31_saturates_instead_of_wrapping);
+    RUN_TEST(test_mailbox_never_tears);
+    return UNITY_END();
+}
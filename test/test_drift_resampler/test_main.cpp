@@ -0,0 +1,180 @@
+// Driftausgleich für A2DP: Regler und Resampler zusammen wie in a2dp_output.cpp gegen ein Telefon,
+// dessen Takt ±500 ppm abweicht und dessen Pakete mal zu spät kommen; dazu die Tonqualität
+#include <unity.h>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "drift_resampler.h"
+
+// Wie a2dp_output.h: 400 ms Ring bei 44,1 kHz, Ausgabe in Blöcken zu 128 Frames, Ziel halb voll
+#define SIM_RATE 44100
+#define SIM_RING_FRAMES (400 * SIM_RATE / 1000)
+#define SIM_TARGET_FRAMES (SIM_RING_FRAMES / 2)
+#define SIM_BLOCK 128
+// A2DP-Pakete (SBC) liefern einige hundert Frames auf einmal
+#define SIM_PACKET 512
+
+void setUp() {}
+void tearDown() {}
+
+struct DriftRun {
+    uint32_t min_fill = UINT32_MAX;
+    uint32_t max_fill = 0;
+    uint32_t dry = 0;           // Blöcke, in denen der Ring nicht reichte
+    uint32_t overflow = 0;      // Pakete, die nicht mehr in den Ring passten
+    double late_ppm = 0;        // mittlere Korrektur in den letzten zwei Minuten
+    double late_fill = 0;       // mittlerer Füllstand in den letzten zwei Minuten
+    int32_t final_integral = 0;
+};
+
+/**
+ * @brief Simuliert 'seconds' Sekunden Ausgabetakt. Das Telefon liefert 44100 * (1 + drift_ppm)
+ * Frames pro Sekunde des I2S-Takts in Paketen; alle 1,3 s hängt ein Paket 80 ms und kommt dann
+ * zusammen mit dem nächsten. Der Ring wird nur gezählt, die Frames selbst laufen durch den
+ * Resampler.
+ */
+static DriftRun simulate(int32_t drift_ppm, uint32_t seconds) {
+    DriftRun r;
+    DriftResampler resampler;
+    DriftController controller;
+    resampler.reset();
+    controller.reset();
+
+    std::vector<int16_t> in(2 * SIM_BLOCK * 2, 0);
+    std::vector<int16_t> out(2 * SIM_BLOCK);
+    uint32_t fill = SIM_TARGET_FRAMES;   // die Ausgabe startet bei halb vollem Ring
+    double phone = 0;                    // vom Telefon bisher erzeugte Frames (Bruchteil)
+    uint64_t delivered = 0;
+    uint64_t next_late = 13 * SIM_RATE / 10;
+    uint64_t held_until = 0;
+
+    const uint64_t blocks = (uint64_t)seconds * SIM_RATE / SIM_BLOCK;
+    const uint64_t late_from = blocks - 120ull * SIM_RATE / SIM_BLOCK;
+    for (uint64_t b = 0; b < blocks; b++) {
+        uint64_t now = b * SIM_BLOCK;
+
+        // Telefon: ganze Pakete, sobald sie erzeugt sind, außer eines hängt gerade
+        phone += SIM_BLOCK * (1.0 + drift_ppm / 1e6);
+        if (now >= next_late) {
+            held_until = now + 80 * SIM_RATE / 1000;
+            next_late += 13 * SIM_RATE / 10;
+        }
+        while (now >= held_until && phone - delivered >= SIM_PACKET) {
+            if (fill + SIM_PACKET > SIM_RING_FRAMES) r.overflow++;
+            else fill += SIM_PACKET;
+            delivered += SIM_PACKET;
+        }
+
+        // Ausgabe-Task: Korrektur aus dem Füllstand, dann einen Block resamplen
+        resampler.setPpm(controller.update(fill, SIM_TARGET_FRAMES));
+        uint16_t produced = 0;
+        while (produced < SIM_BLOCK) {
+            uint16_t avail = fill < SIM_BLOCK * 2 ? (uint16_t)fill : SIM_BLOCK * 2;
+            if (avail == 0) {
+                r.dry++;
+                break;
+            }
+            uint16_t used;
+            produced += resampler.process(in.data(), avail, used, out.data() + 2 * produced, SIM_BLOCK - produced);
+            fill -= used;
+        }
+
+        if (fill < r.min_fill) r.min_fill = fill;
+        if (fill > r.max_fill) r.max_fill = fill;
+        if (b >= late_from) {
+            r.late_ppm += resampler.ppm();
+            r.late_fill += fill;
+        }
+    }
+    r.late_ppm /= (double)(blocks - late_from);
+    r.late_fill /= (double)(blocks - late_from);
+    r.final_integral = controller.integralPpm();
+    return r;
+}
+
+// Zehn Minuten: nie leer, nie voll; danach gleicht die Korrektur die Drift aus und der Ring
+// steht um die Mitte. Der Regler schwingt mit einer Periode von einigen Minuten ein, deshalb
+// zählen die Mittelwerte der letzten zwei Minuten.
+static void assertConverges(int32_t drift_ppm) {
+    DriftRun r = simulate(drift_ppm, 600);
+    TEST_ASSERT_EQUAL_UINT32(0, r.dry);
+    TEST_ASSERT_EQUAL_UINT32(0, r.overflow);
+    TEST_ASSERT_GREATER_THAN(SIM_BLOCK, r.min_fill);
+    TEST_ASSERT_LESS_THAN(SIM_RING_FRAMES - SIM_PACKET, r.max_fill);
+    TEST_ASSERT_INT32_WITHIN(25, drift_ppm, (int32_t)lrint(r.late_ppm));
+    TEST_ASSERT_INT32_WITHIN(50, drift_ppm, r.final_integral);
+    TEST_ASSERT_INT32_WITHIN(SIM_TARGET_FRAMES / 20, SIM_TARGET_FRAMES, (int32_t)lrint(r.late_fill));
+}
+
+// Telefon 500 ppm schneller als der I2S-Takt: der Ring würde sonst in 400 s überlaufen
+static void test_phone_fast_500_ppm_converges() {
+    assertConverges(500);
+}
+
+// Telefon 500 ppm langsamer: der Ring würde sonst leer laufen
+static void test_phone_slow_500_ppm_converges() {
+    assertConverges(-500);
+}
+
+static void test_no_drift_stays_near_zero() {
+    assertConverges(0);
+}
+
+// Sinus mit 1 kHz bei +500 ppm: Abstand zum idealen, um die Korrektur gestreckten Sinus
+static void test_tone_quality_at_500_ppm() {
+    const double f = 1000.0, amp = 16000.0, step = 1.0 + 500 / 1e6;
+    const uint32_t frames = SIM_RATE;
+    std::vector<int16_t> in(2 * frames), out(2 * frames);
+    for (uint32_t i = 0; i < frames; i++) {
+        in[2 * i] = in[2 * i + 1] = (int16_t)lrint(amp * sin(2 * M_PI * f * i / SIM_RATE));
+    }
+    DriftResampler rs;
+    rs.reset();
+    rs.setPpm(500);
+    uint16_t used = 0;
+    uint32_t pos = 0, produced = 0;
+    while (pos + 256 <= frames && produced + 256 <= frames) {
+        produced += rs.process(in.data() + 2 * pos, 256, used, out.data() + 2 * produced, 256);
+        pos += used;
+    }
+
+    // Ausgang n liegt bei Eingang n * step minus der festen Verzögerung der Stützstellen
+    double best = 0;
+    for (int delay = 0; delay <= 3; delay++) {
+        double sig = 0, noise = 0;
+        for (uint32_t n = 1000; n < produced - 1000; n++) {
+            double ideal = amp * sin(2 * M_PI * f * (n * step - delay) / SIM_RATE);
+            for (int ch = 0; ch < 2; ch++) {
+                double e = out[2 * n + ch] - ideal;
+                sig += ideal * ideal;
+                noise += e * e;
+            }
+        }
+        double snr = 10 * log10(sig / noise);
+        if (snr > best) best = snr;
+    }
+    TEST_ASSERT_GREATER_THAN(75.0, best);
+}
+
+// Die Korrektur wird auf A2DP_DRIFT_MAX_PPM begrenzt, auch bei extremer Abweichung
+static void test_correction_is_limited() {
+    DriftController c;
+    int32_t ppm = 0;
+    for (int i = 0; i < 100000; i++) ppm = c.update(SIM_RING_FRAMES, SIM_TARGET_FRAMES);
+    TEST_ASSERT_EQUAL_INT32(A2DP_DRIFT_MAX_PPM, ppm);
+    TEST_ASSERT_EQUAL_INT32(A2DP_DRIFT_MAX_PPM, c.integralPpm());
+    DriftResampler rs;
+    rs.setPpm(-5000);
+    TEST_ASSERT_EQUAL_INT32(-A2DP_DRIFT_MAX_PPM, rs.ppm());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_phone_fast_500_ppm_converges);
+    RUN_TEST(test_phone_slow_500_ppm_converges);
+    RUN_TEST(test_no_drift_stays_near_zero);
+    RUN_TEST(test_tone_quality_at_500_ppm);
+    RUN_TEST(test_correction_is_limited);
+    return UNITY_END();
+}
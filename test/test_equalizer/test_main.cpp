@@ -0,0 +1,181 @@
+// Parametrischer EQ: Kaskade gegen die Frequenzgänge der einzelnen Bänder, Prüfung der Parameter
+#include <unity.h>
+#include <complex>
+#include <vector>
+
+#include "equalizer.h"
+
+void setUp() {}
+void tearDown() {}
+
+static double responseDb(const EQBand& band, double freq, double rate) {
+    BiquadCoefficients k;
+    biquad_design(k, (BiquadType)band.type, band.freq, band.gain_db, band.q, rate);
+    std::complex<double> z1 = std::polar(1.0, -2.0 * M_PI * freq / rate);
+    std::complex<double> z2 = z1 * z1;
+    std::complex<double> h = ((double)k.b0 + (double)k.b1 * z1 + (double)k.b2 * z2) /
+                             (1.0 + (double)k.a1 * z1 + (double)k.a2 * z2);
+    return 20.0 * log10(std::abs(h));
+}
+
+// Pegel eines Sinus bei 'freq' hinter dem EQ (beide Kanäle), nach dem Einschwingen, in dB
+template <class Kernel>
+static double measuredDb(AudioEffectEQT<Kernel>& eq, double freq, int rate) {
+    eq.SetRate(rate);
+    std::vector<int16_t> frames(rate * 2);
+    const double amp = 4000.0;
+    double in_sq = 0, out_sq = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < rate; i++) {
+            int16_t x = (int16_t)lrint(amp * sin(2.0 * M_PI * freq * (pass * rate + i) / rate));
+            frames[2 * i] = frames[2 * i + 1] = x;
+            if (pass == 1) in_sq += 2.0 * x * x;
+        }
+        eq.ProcessInPlace(frames.data(), rate);
+    }
+    for (int i = 0; i < rate * 2; i++) out_sq += (double)frames[i] * frames[i];
+    return 10.0 * log10(out_sq / in_sq);
+}
+
+static const EQBand low  = { BIQUAD_LOWSHELF,  1,   100,  6.0f, BIQUAD_Q_BUTTERWORTH };
+static const EQBand mid  = { BIQUAD_PEAKING,   1,  1500, -4.0f, 1.0f };
+static const EQBand high = { BIQUAD_HIGHSHELF, 1, 10000,  3.0f, BIQUAD_Q_BUTTERWORTH };
+
+template <class Kernel>
+static void cascadeMatchesBandProduct() {
+    AudioEffectEQT<Kernel> eq(nullptr);
+    TEST_ASSERT_TRUE(eq.SetBand(0, low));
+    TEST_ASSERT_TRUE(eq.SetBand(2, mid));
+    TEST_ASSERT_TRUE(eq.SetBand(4, high));
+
+    const double freqs[] = { 50, 400, 1500, 5000, 15000 };
+    for (double f : freqs) {
+        // Kaskade: Frequenzgänge multiplizieren sich, in dB addieren sie sich
+        double expected = responseDb(low, f, 44100) + responseDb(mid, f, 44100) + responseDb(high, f, 44100);
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, (float)expected, (float)measuredDb(eq, f, 44100));
+    }
+}
+
+static void test_cascade_matches_band_product_q31() { cascadeMatchesBandProduct<BiquadQ31>(); }
+static void test_cascade_matches_band_product_float() { cascadeMatchesBandProduct<BiquadFloat>(); }
+
+static void test_disabled_bands_pass_through() {
+    AudioEffectEQT<BiquadQ31> eq(nullptr);
+    EQBand band = mid;
+    band.enabled = 0;
+    band.gain_db = 12.0f;
+    TEST_ASSERT_TRUE(eq.SetBand(1, band));
+
+    std::vector<int16_t> in(2048), out;
+    for (size_t i = 0; i < in.size(); i++) in[i] = (int16_t)(i * 37);
+    out = in;
+    eq.SetRate(44100);
+    eq.ProcessInPlace(out.data(), in.size() / 2);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(in.data(), out.data(), in.size());
+}
+
+static void test_set_band_rejects_invalid_parameters() {
+    AudioEffectEQT<BiquadQ31> eq(nullptr);
+    EQBand band = mid;
+    TEST_ASSERT_FALSE(eq.SetBand(EQ_MAX_BANDS, band));
+
+    band = mid; band.type = BIQUAD_HIGHPASS + 1;
+    TEST_ASSERT_FALSE(eq.SetBand(1, band));
+    band = mid; band.freq = 19;
+    TEST_ASSERT_FALSE(eq.SetBand(1, band));
+    band = mid; band.freq = 20001;
+    TEST_ASSERT_FALSE(eq.SetBand(1, band));
+    band = mid; band.q = 0.0f;
+    TEST_ASSERT_FALSE(eq.SetBand(1, band));
+    band = mid; band.q = NAN;
+    TEST_ASSERT_FALSE(eq.SetBand(1, band));
+    band = mid; band.gain_db = 15.5f;
+    TEST_ASSERT_FALSE(eq.SetBand(1, band));
+    band = mid; band.gain_db = -15.5f;
+    TEST_ASSERT_FALSE(eq.SetBand(1, band));
+
+    // Abgelehnte Bänder lassen die vorige Einstellung stehen
+    TEST_ASSERT_EQUAL_UINT16(400, eq.GetBand(1).freq);
+    TEST_ASSERT_FALSE(eq.GetBand(1).enabled);
+}
+
+// Ein Band bei 18 kHz gibt es bei 32 kHz nicht, bei 44,1 kHz schon
+static void test_band_above_nyquist_is_skipped() {
+    AudioEffectEQT<BiquadFloat> eq(nullptr);
+    EQBand band = { BIQUAD_PEAKING, 1, 18000, 12.0f, 1.0f };
+    TEST_ASSERT_TRUE(eq.SetBand(3, band));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, (float)measuredDb(eq, 14000, 32000));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, (float)responseDb(band, 14000, 44100), (float)measuredDb(eq, 14000, 44100));
+}
+
+static void sine(std::vector<int16_t>& frames, int start, double freq) {
+    for (size_t i = 0; i < frames.size() / 2; i++) {
+        frames[2 * i] = frames[2 * i + 1] = (int16_t)lrint(4000.0 * sin(2.0 * M_PI * freq * (start + i) / 44100));
+    }
+}
+
+// Gain-Änderung eines aktiven Bands: Überblendung statt Sprung
+static void test_gain_change_is_ramped() {
+    AudioEffectEQT<BiquadQ31> eq(nullptr), unchanged(nullptr);
+    EQBand band = { BIQUAD_PEAKING, 1, 1000, 0.0f, 1.0f };
+    eq.SetBand(2, band);
+    unchanged.SetBand(2, band);
+    eq.SetRate(44100);
+    unchanged.SetRate(44100);
+
+    std::vector<int16_t> a(4410 * 2), b;
+    sine(a, 0, 1000);
+    b = a;
+    eq.ProcessInPlace(a.data(), 4410);
+    unchanged.ProcessInPlace(b.data(), 4410);
+
+    band.gain_db = 12.0f;
+    eq.SetBand(2, band);
+    sine(a, 4410, 1000);
+    b = a;
+    eq.ProcessInPlace(a.data(), 4410);
+    unchanged.ProcessInPlace(b.data(), 4410);
+
+    // Der erste Teilblock läuft noch mit den alten Koeffizienten
+    TEST_ASSERT_EQUAL_INT16_ARRAY(b.data(), a.data(), DSP_RAMP_STEP_FRAMES * 2);
+    // Danach steigt der Pegel schrittweise: kein Teilblock springt um mehr als ~1 dB
+    double previous = 0;
+    for (int step = 0; step < DSP_RAMP_STEPS; step++) {
+        double peak = 0;
+        for (int i = 0; i < DSP_RAMP_STEP_FRAMES; i++) {
+            double v = fabs((double)a[2 * (step * DSP_RAMP_STEP_FRAMES + i)]);
+            if (v > peak) peak = v;
+        }
+        if (step > 0) TEST_ASSERT_TRUE(peak < previous * 1.15);
+        previous = peak;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 12.0f, (float)measuredDb(eq, 1000, 44100));
+}
+
+// Einschalten eines Bands verschiebt die Belegung und wird sofort übernommen
+static void test_enabling_band_applies_immediately() {
+    AudioEffectEQT<BiquadQ31> eq(nullptr);
+    eq.SetRate(44100);
+    EQBand band = { BIQUAD_PEAKING, 1, 1000, 12.0f, 1.0f };
+    eq.SetBand(2, band);
+
+    std::vector<int16_t> a(2048 * 2);
+    sine(a, 0, 1000);
+    std::vector<int16_t> in = a;
+    eq.ProcessInPlace(a.data(), 2048);
+    int differing = 0;
+    for (int i = 0; i < DSP_RAMP_STEP_FRAMES * 2; i++) differing += a[i] != in[i];
+    TEST_ASSERT_GREATER_THAN(DSP_RAMP_STEP_FRAMES, differing);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_cascade_matches_band_product_q31);
+    RUN_TEST(test_cascade_matches_band_product_float);
+    RUN_TEST(test_disabled_bands_pass_through);
+    RUN_TEST(test_set_band_rejects_invalid_parameters);
+    RUN_TEST(test_band_above_nyquist_is_skipped);
+    RUN_TEST(test_gain_change_is_ramped);
+    RUN_TEST(test_enabling_band_applies_immediately);
+    return UNITY_END();
+}
@@ -0,0 +1,237 @@
+// HTTP-Stream gegen einen lokalen Server: Weiterleitungen, Playlists, Header und Lesen aus
+// derselben Antwort (keine zweite Anfrage), Fehlerfälle
+#include <unity.h>
+#include <memory>
+#include <vector>
+
+#include "http_stream.h"
+#include "posix_transport.h"
+#include "icy_server.h"
+
+static std::unique_ptr<IcyServer> server;
+
+void setUp() {
+    server.reset(new IcyServer());
+}
+
+void tearDown() {
+    server.reset();
+}
+
+static IcyServer::Route stream(const char* headers, size_t bytes) {
+    IcyServer::Route r;
+    r.head = std::string("HTTP/1.0 200 OK\r\n") + headers;
+    r.stream_bytes = bytes;
+    return r;
+}
+
+static IcyServer::Route redirect(const char* status, const std::string& location) {
+    IcyServer::Route r;
+    r.head = std::string(status) + "\r\nLocation: " + location + "\r\n";
+    return r;
+}
+
+// Liest, bis 'want' Bytes da sind oder die Verbindung endet
+static std::vector<uint8_t> readAll(HttpStream& http, StreamTransport& net, size_t want) {
+    std::vector<uint8_t> out;
+    uint8_t buf[700];
+    uint32_t start = net.millis();
+    while (out.size() < want && net.millis() - start < 5000) {
+        int32_t got = http.read(buf, sizeof(buf));
+        if (got < 0) break;
+        if (got == 0) net.idle();
+        out.insert(out.end(), buf, buf + got);
+    }
+    return out;
+}
+
+static void assertPattern(const std::vector<uint8_t>& data) {
+    for (size_t i = 0; i < data.size(); i++) {
+        if (data[i] != IcyServer::streamByte(i)) TEST_FAIL_MESSAGE("Stream-Byte falsch");
+    }
+}
+
+static void test_direct_stream_reads_same_response() {
+    server->route("/live", stream("Content-Type: audio/mpeg\r\nicy-br: 128\r\nicy-sr: 44100\r\n", 100000));
+    PosixTransport net;
+    HttpStream http(net);
+    StationInfo info;
+    TEST_ASSERT_TRUE(http.open(server->url("/live").c_str(), info));
+    TEST_ASSERT_EQUAL_STRING(server->url("/live").c_str(), info.url);
+    TEST_ASSERT_EQUAL_STRING("audio/mpeg", info.content_type);
+    TEST_ASSERT_EQUAL_UINT16(128, info.bitrate_kbps);
+    TEST_ASSERT_EQUAL_UINT32(44100, info.sample_rate);
+
+    std::vector<uint8_t> data = readAll(http, net, 100000);
+    TEST_ASSERT_EQUAL(100000, data.size());
+    assertPattern(data);
+    // Ende des Streams: geschlossen
+    uint8_t b;
+    while (http.read(&b, 1) == 0) net.idle();
+    TEST_ASSERT_FALSE(http.isOpen());
+
+    // Genau eine Anfrage, HTTP/1.0 ohne Icy-MetaData
+    TEST_ASSERT_EQUAL_UINT32(1, server->connections());
+    TEST_ASSERT_EQUAL_UINT32(1, http.requests());
+    std::string req = server->requests()[0];
+    TEST_ASSERT_EQUAL(0, req.find("GET /live HTTP/1.0\r\n"));
+    TEST_ASSERT_TRUE(req.find("Host: 127.0.0.1:") != std::string::npos);
+    TEST_ASSERT_TRUE(req.find("Icy-MetaData") == std::string::npos);
+}
+
+// Absolute, host-relative und verzeichnis-relative Weiterleitungen hintereinander
+static void test_redirect_chain_streams_from_final_hop() {
+    server->route("/a", redirect("HTTP/1.1 302 Found", server->url("/b")));
+    server->route("/b", redirect("HTTP/1.1 301 Moved Permanently", "/dir/c"));
+    server->route("/dir/c", redirect("HTTP/1.1 307 Temporary Redirect", "live.aac?sid=1"));
+    server->route("/dir/live.aac?sid=1", stream("content-type: audio/aac\r\nICY-BR: 64\r\n", 5000));
+
+    PosixTransport net;
+    HttpStream http(net);
+    StationInfo info;
+    TEST_ASSERT_TRUE(http.open(server->url("/a").c_str(), info));
+    TEST_ASSERT_EQUAL_STRING(server->url("/dir/live.aac?sid=1").c_str(), info.url);
+    TEST_ASSERT_EQUAL_STRING("audio/aac", info.content_type);
+    TEST_ASSERT_EQUAL_UINT16(64, info.bitrate_kbps);
+
+    std::vector<uint8_t> data = readAll(http, net, 5000);
+    TEST_ASSERT_EQUAL(5000, data.size());
+    assertPattern(data);
+    // Eine Verbindung je Schritt, keine zusätzliche für die Header
+    TEST_ASSERT_EQUAL_UINT32(4, server->connections());
+}
+
+// Shoutcast 1 antwortet mit "ICY 200 OK"; Rate und Bitrate aus ice-audio-info
+static void test_icy_status_and_audio_info() {
+    IcyServer::Route r;
+    r.head = "ICY 200 OK\r\nContent-Type: audio/mpeg\r\n"
+             "ice-audio-info: ice-samplerate=48000;ice-bitrate=192;ice-channels=2\r\n";
+    r.body = "ABC";
+    server->route("/;", r);
+
+    PosixTransport net;
+    HttpStream http(net);
+    StationInfo info;
+    TEST_ASSERT_TRUE(http.open(server->url("/;").c_str(), info));
+    TEST_ASSERT_EQUAL_UINT32(48000, info.sample_rate);
+    TEST_ASSERT_EQUAL_UINT16(192, info.bitrate_kbps);
+    std::vector<uint8_t> data = readAll(http, net, 3);
+    TEST_ASSERT_EQUAL(3, data.size());
+    TEST_ASSERT_EQUAL_UINT8('A', data[0]);
+}
+
+static void test_playlists_are_followed() {
+    IcyServer::Route m3u;
+    m3u.head = "HTTP/1.0 200 OK\r\nContent-Type: audio/x-mpegurl\r\n";
+    m3u.body = "#EXTM3U\r\n#EXTINF:-1,Test\r\nhttps://secure.example/x\r\n" + server->url("/pls") + "\r\n";
+    server->route("/list.m3u", m3u);
+    IcyServer::Route pls;
+    pls.head = "HTTP/1.0 200 OK\r\nContent-Type: audio/x-scpls\r\n";
+    pls.body = "[playlist]\nNumberOfEntries=1\nFile1=" + server->url("/stream") + "\nTitle1=Test\n";
+    server->route("/pls", pls);
+    server->route("/stream", stream("Content-Type: audio/mpeg\r\n", 2000));
+
+    PosixTransport net;
+    HttpStream http(net);
+    StationInfo info;
+    TEST_ASSERT_TRUE(http.open(server->url("/list.m3u").c_str(), info));
+    TEST_ASSERT_EQUAL_STRING(server->url("/stream").c_str(), info.url);
+    std::vector<uint8_t> data = readAll(http, net, 2000);
+    TEST_ASSERT_EQUAL(2000, data.size());
+    assertPattern(data);
+    TEST_ASSERT_EQUAL_UINT32(3, server->connections());
+}
+
+static void test_failures() {
+    PosixTransport net;
+    HttpStream http(net);
+    StationInfo info;
+
+    // Schleife: nach STATION_MAX_REDIRECTS Weiterleitungen ist Schluss
+    server->route("/loop", redirect("HTTP/1.1 302 Found", "/loop"));
+    TEST_ASSERT_FALSE(http.open(server->url("/loop").c_str(), info));
+    TEST_ASSERT_EQUAL_UINT32(STATION_MAX_REDIRECTS + 1, server->connections());
+    TEST_ASSERT_FALSE(http.isOpen());
+
+    server->route("/tls", redirect("HTTP/1.1 302 Found", "https://example.com/live"));
+    TEST_ASSERT_FALSE(http.open(server->url("/tls").c_str(), info));
+    server->route("/empty", IcyServer::Route{ "HTTP/1.1 302 Found\r\n", "", 0 });
+    TEST_ASSERT_FALSE(http.open(server->url("/empty").c_str(), info));
+    TEST_ASSERT_FALSE(http.open(server->url("/missing").c_str(), info));
+    IcyServer::Route garbage;
+    garbage.head = "SSH-2.0-OpenSSH\r\n";
+    server->route("/garbage", garbage);
+    TEST_ASSERT_FALSE(http.open(server->url("/garbage").c_str(), info));
+    TEST_ASSERT_FALSE(http.open("https://example.com/", info));
+
+    // Playlist ohne brauchbaren Eintrag
+    IcyServer::Route hls;
+    hls.head = "HTTP/1.0 200 OK\r\nContent-Type: application/vnd.apple.mpegurl\r\n";
+    hls.body = "#EXTM3U\n#EXT-X-TARGETDURATION:10\nseg1.ts\n";
+    server->route("/hls.m3u8", hls);
+    TEST_ASSERT_FALSE(http.open(server->url("/hls.m3u8").c_str(), info));
+    TEST_ASSERT_FALSE(http.isOpen());
+}
+
+// Ein Port, auf dem niemand lauscht
+static void test_connect_refused() {
+    uint16_t port = server->port();
+    server.reset();
+    PosixTransport net;
+    HttpStream http(net);
+    StationInfo info;
+    char url[64];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/live", port);
+    TEST_ASSERT_FALSE(http.open(url, info));
+}
+
+// Gemerktes Ziel als URL: open() darf in dieselbe StationInfo schreiben, aus der die URL kommt
+static void test_open_with_url_from_info() {
+    server->route("/live", stream("Content-Type: audio/mpeg\r\n", 10));
+    PosixTransport net;
+    HttpStream http(net);
+    StationInfo info;
+    snprintf(info.url, sizeof(info.url), "%s", server->url("/live").c_str());
+    TEST_ASSERT_TRUE(http.open(info.url, info));
+    TEST_ASSERT_EQUAL_STRING(server->url("/live").c_str(), info.url);
+}
+
+static void test_resolve_location() {
+    char out[STATION_URL_MAX];
+    TEST_ASSERT_TRUE(HttpStream::resolveLocation("http://a.de/x/y.pls", "http://b.de/s", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("http://b.de/s", out);
+    TEST_ASSERT_TRUE(HttpStream::resolveLocation("http://a.de:8000/x/y.pls", "/live", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("http://a.de:8000/live", out);
+    TEST_ASSERT_TRUE(HttpStream::resolveLocation("http://a.de/x/y?p=/q", "z.mp3", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("http://a.de/x/z.mp3", out);
+    TEST_ASSERT_TRUE(HttpStream::resolveLocation("http://a.de", "z.mp3", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("http://a.de/z.mp3", out);
+    TEST_ASSERT_TRUE(HttpStream::resolveLocation("http://a.de/x", "//c.de/s", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("http://c.de/s", out);
+    TEST_ASSERT_FALSE(HttpStream::resolveLocation("http://a.de/x", "https://c.de/s", out, sizeof(out)));
+    TEST_ASSERT_FALSE(HttpStream::resolveLocation("http://a.de/x", "/abcdefgh", out, 16));
+
+    char host[16];
+    uint16_t port;
+    const char* path;
+    TEST_ASSERT_TRUE(HttpStream::splitUrl("http://radio.de:8080", host, sizeof(host), port, path));
+    TEST_ASSERT_EQUAL_STRING("radio.de", host);
+    TEST_ASSERT_EQUAL_UINT16(8080, port);
+    TEST_ASSERT_EQUAL_STRING("/", path);
+    TEST_ASSERT_FALSE(HttpStream::splitUrl("http://radio.de:99999/", host, sizeof(host), port, path));
+    TEST_ASSERT_FALSE(HttpStream::splitUrl("http://:80/", host, sizeof(host), port, path));
+    TEST_ASSERT_FALSE(HttpStream::splitUrl("http://a-very-long-host-name.de/", host, sizeof(host), port, path));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_direct_stream_reads_same_response);
+    RUN_TEST(test_redirect_chain_streams_from_final_hop);
+    RUN_TEST(test_icy_status_and_audio_info);
+    RUN_TEST(test_playlists_are_followed);
+    RUN_TEST(test_failures);
+    RUN_TEST(test_connect_refused);
+    RUN_TEST(test_open_with_url_from_info);
+    RUN_TEST(test_resolve_location);
+    return UNITY_END();
+}
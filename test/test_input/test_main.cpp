@@ -0,0 +1,193 @@
+// Eingabe: Timer-Abtastung der Tasten-Leiter und des Drehgebers bis in die Queue (input.cpp mit
+// simuliertem ADC, Timer und PCNT), dazu Entprellung, Hysterese und Beschleunigung an Verläufen
+#include <unity.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <esp_timer.h>
+#include <ESP32Encoder.h>
+#include "input.h"
+
+#define ADC_IDLE 3000
+#define ADC_BUTTON1 50
+#define ADC_BUTTON2 350
+#define ADC_BUTTON3 800
+
+static std::vector<InputEvent> drain() {
+    std::vector<InputEvent> events;
+    InputEvent ev;
+    while (input_wait(ev, 0)) events.push_back(ev);
+    return events;
+}
+
+static void runWithAdc(uint16_t value, uint32_t ms) {
+    mock::analog[BUTTON_ADC_PIN] = value;
+    mock::timer_run(ms);
+}
+
+void setUp() {
+    static bool started = false;
+    if (!started) {
+        init_input();
+        started = true;
+    }
+    mock::analog_source = nullptr;
+    runWithAdc(ADC_IDLE, 500);
+    drain();
+}
+
+void tearDown() {}
+
+static void test_press_and_release_through_timer_and_queue() {
+    uint32_t reads = mock::analog_reads;
+    uint32_t start = millis();
+    runWithAdc(ADC_BUTTON2, 200);
+    // 40 Abtastungen zu je INPUT_OVERSAMPLE ADC-Werten
+    TEST_ASSERT_EQUAL_UINT32(200 / INPUT_SAMPLE_MS * INPUT_OVERSAMPLE, mock::analog_reads - reads);
+
+    std::vector<InputEvent> ev = drain();
+    TEST_ASSERT_EQUAL(1, ev.size());
+    TEST_ASSERT_EQUAL(INPUT_PRESS, ev[0].type);
+    TEST_ASSERT_EQUAL_UINT8(2, ev[0].button);
+    // Gedrückt gilt nach INPUT_DEBOUNCE_MS, auf die Abtastung genau
+    TEST_ASSERT_UINT32_WITHIN(INPUT_SAMPLE_MS, start + INPUT_DEBOUNCE_MS + INPUT_SAMPLE_MS, ev[0].ms);
+
+    runWithAdc(ADC_IDLE, 200);
+    ev = drain();
+    TEST_ASSERT_EQUAL(1, ev.size());
+    TEST_ASSERT_EQUAL(INPUT_RELEASE, ev[0].type);
+    TEST_ASSERT_EQUAL_UINT8(2, ev[0].button);
+}
+
+static void test_long_press_once() {
+    runWithAdc(ADC_BUTTON1, 3000);
+    std::vector<InputEvent> ev = drain();
+    TEST_ASSERT_EQUAL(2, ev.size());
+    TEST_ASSERT_EQUAL(INPUT_PRESS, ev[0].type);
+    TEST_ASSERT_EQUAL(INPUT_LONG_PRESS, ev[1].type);
+    TEST_ASSERT_EQUAL_UINT8(1, ev[1].button);
+    TEST_ASSERT_UINT32_WITHIN(INPUT_SAMPLE_MS, ev[0].ms + INPUT_LONG_PRESS_MS, ev[1].ms);
+}
+
+// Aufgezeichneter Verlauf: Prellen beim Drücken, sauber gedrückt, dann Rauschen knapp an der
+// Grenze zu Taste 3 (innerhalb der Hysterese der gehaltenen Taste)
+static uint32_t trace_start;
+static uint16_t bouncingTrace(uint8_t pin) {
+    (void)pin;
+    uint32_t t = millis() - trace_start;
+    if (t < 60) return (t / 5) % 2 ? ADC_IDLE : ADC_BUTTON2;
+    if (t < 160) return ADC_BUTTON2;
+    if (t < 400) return (uint16_t)(INPUT_ADC_BUTTON2 - 10 + rand() % 50);  // 590..639
+    return ADC_IDLE;
+}
+
+static void test_recorded_bounce_and_boundary_noise() {
+    srand(1);
+    trace_start = millis();
+    mock::analog_source = bouncingTrace;
+    mock::timer_run(600);
+    std::vector<InputEvent> ev = drain();
+    TEST_ASSERT_EQUAL(2, ev.size());
+    TEST_ASSERT_EQUAL(INPUT_PRESS, ev[0].type);
+    TEST_ASSERT_EQUAL_UINT8(2, ev[0].button);
+    // Das Prellen verlängert die Entprellzeit, löst aber nichts aus
+    TEST_ASSERT_GREATER_OR_EQUAL(trace_start + 60 + INPUT_DEBOUNCE_MS, ev[0].ms);
+    TEST_ASSERT_EQUAL(INPUT_RELEASE, ev[1].type);
+    TEST_ASSERT_EQUAL_UINT8(2, ev[1].button);
+    // Losgelassen erst nach dem Ende des Verlaufs plus Entprellzeit
+    TEST_ASSERT_GREATER_OR_EQUAL(trace_start + 400 + INPUT_DEBOUNCE_MS, ev[1].ms);
+}
+
+// Direkt von Taste 1 auf Taste 3: erst loslassen, dann die neue drücken
+static void test_direct_switch_between_buttons() {
+    runWithAdc(ADC_BUTTON1, 100);
+    runWithAdc(ADC_BUTTON3, 200);
+    std::vector<InputEvent> ev = drain();
+    TEST_ASSERT_EQUAL(3, ev.size());
+    TEST_ASSERT_EQUAL(INPUT_PRESS, ev[0].type);
+    TEST_ASSERT_EQUAL_UINT8(1, ev[0].button);
+    TEST_ASSERT_EQUAL(INPUT_RELEASE, ev[1].type);
+    TEST_ASSERT_EQUAL_UINT8(1, ev[1].button);
+    TEST_ASSERT_EQUAL(INPUT_PRESS, ev[2].type);
+    TEST_ASSERT_EQUAL_UINT8(3, ev[2].button);
+}
+
+static void test_hysteresis_at_band_edges() {
+    TEST_ASSERT_EQUAL_UINT8(1, ButtonClassifier::classify(INPUT_ADC_BUTTON1 - 1, 0));
+    TEST_ASSERT_EQUAL_UINT8(2, ButtonClassifier::classify(INPUT_ADC_BUTTON1, 0));
+    TEST_ASSERT_EQUAL_UINT8(2, ButtonClassifier::classify(INPUT_ADC_BUTTON2 + INPUT_ADC_HYSTERESIS - 1, 2));
+    TEST_ASSERT_EQUAL_UINT8(3, ButtonClassifier::classify(INPUT_ADC_BUTTON2 + INPUT_ADC_HYSTERESIS, 2));
+    TEST_ASSERT_EQUAL_UINT8(3, ButtonClassifier::classify(INPUT_ADC_BUTTON2 - INPUT_ADC_HYSTERESIS, 3));
+    TEST_ASSERT_EQUAL_UINT8(3, ButtonClassifier::classify(INPUT_ADC_BUTTON3 + INPUT_ADC_HYSTERESIS - 1, 3));
+    TEST_ASSERT_EQUAL_UINT8(0, ButtonClassifier::classify(INPUT_ADC_BUTTON3 + INPUT_ADC_HYSTERESIS, 3));
+    TEST_ASSERT_EQUAL_UINT8(0, ButtonClassifier::classify(4095, 0));
+}
+
+// Langsam: jede Raste einzeln; der PCNT zählt beim Rechtsdrehen herunter
+static void test_slow_encoder_detents() {
+    for (int i = 0; i < 5; i++) {
+        mock::encoder_count--;
+        mock::timer_run(200);
+    }
+    std::vector<InputEvent> ev = drain();
+    TEST_ASSERT_EQUAL(5, ev.size());
+    for (const InputEvent& e : ev) {
+        TEST_ASSERT_EQUAL(INPUT_ENCODER, e.type);
+        TEST_ASSERT_EQUAL_INT16(1, e.delta);
+    }
+    mock::encoder_count += 2;
+    mock::timer_run(200);
+    ev = drain();
+    TEST_ASSERT_EQUAL(1, ev.size());
+    TEST_ASSERT_EQUAL_INT16(-2, ev[0].delta);
+}
+
+// Schnell (eine Raste je Abtastung = 200 Rasten/s): vervielfacht, höchstens INPUT_ACCEL_MAX
+static void test_fast_encoder_is_accelerated() {
+    mock::timer_run(500);
+    for (int i = 0; i < 12; i++) {
+        mock::encoder_count--;
+        mock::timer_run(INPUT_SAMPLE_MS);
+    }
+    std::vector<InputEvent> ev = drain();
+    int32_t sum = 0;
+    for (const InputEvent& e : ev) {
+        TEST_ASSERT_LESS_OR_EQUAL(INPUT_ACCEL_MAX, e.delta);
+        sum += e.delta;
+    }
+    TEST_ASSERT_EQUAL(12, ev.size());
+    TEST_ASSERT_EQUAL_INT32(1 + 11 * INPUT_ACCEL_MAX, sum);
+
+    EncoderAccel accel;
+    TEST_ASSERT_EQUAL_INT16(1, accel.apply(1, 1000));
+    TEST_ASSERT_EQUAL_INT16(2, accel.apply(1, 1025));   // 40 Rasten/s
+    TEST_ASSERT_EQUAL_INT16(-4, accel.apply(-1, 1026));
+    TEST_ASSERT_EQUAL_INT16(0, accel.apply(0, 1027));
+}
+
+// Volle Queue (loop() hängt): Rasten gehen nicht verloren, sondern kommen gesammelt nach
+static void test_full_queue_keeps_detents() {
+    for (int i = 0; i < 40; i++) {
+        mock::encoder_count--;
+        mock::timer_run(100);
+    }
+    std::vector<InputEvent> ev = drain();
+    TEST_ASSERT_EQUAL(INPUT_QUEUE_LENGTH, ev.size());
+    mock::timer_run(INPUT_SAMPLE_MS);
+    std::vector<InputEvent> rest = drain();
+    TEST_ASSERT_EQUAL(1, rest.size());
+    TEST_ASSERT_EQUAL_INT16(40 - INPUT_QUEUE_LENGTH, rest[0].delta);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_press_and_release_through_timer_and_queue);
+    RUN_TEST(test_long_press_once);
+    RUN_TEST(test_recorded_bounce_and_boundary_noise);
+    RUN_TEST(test_direct_switch_between_buttons);
+    RUN_TEST(test_hysteresis_at_band_edges);
+    RUN_TEST(test_slow_encoder_detents);
+    RUN_TEST(test_fast_encoder_is_accelerated);
+    RUN_TEST(test_full_queue_keeps_detents);
+    return UNITY_END();
+}
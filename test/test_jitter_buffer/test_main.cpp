@@ -0,0 +1,137 @@
+// Jitter-Puffer: Zustandsautomat (Vorpuffern, Aussetzer, Stream-Ende) und Anpassung der Zieltiefe
+#include <unity.h>
+
+#include "jitter_buffer.h"
+
+#define BYTE_RATE 16000          // 128 kbit/s
+#define CAPACITY (BYTE_RATE * 30) // 30 s Ring
+
+static JitterBuffer jb;
+
+void setUp() {
+    jb.begin(BYTE_RATE, CAPACITY);
+}
+
+void tearDown() {}
+
+static void test_prefill_before_playing() {
+    TEST_ASSERT_EQUAL(JitterBuffer::JB_BUFFERING, jb.state());
+    TEST_ASSERT_EQUAL_UINT32(JITTER_PREFILL_MS, jb.targetMs());
+    const uint32_t prefill = BYTE_RATE * JITTER_PREFILL_MS / 1000;
+    TEST_ASSERT_FALSE(jb.update(prefill - 1, false));
+    TEST_ASSERT_TRUE(jb.update(prefill, false));
+    TEST_ASSERT_EQUAL(JitterBuffer::JB_PLAYING, jb.state());
+    // Einmal gestartet läuft er auch unter der Zieltiefe weiter
+    TEST_ASSERT_TRUE(jb.update(JITTER_UNDERRUN_BYTES, false));
+}
+
+static void test_underrun_rebuffers() {
+    jb.update(BYTE_RATE * 3, false);
+    TEST_ASSERT_FALSE(jb.update(JITTER_UNDERRUN_BYTES - 1, false));
+    TEST_ASSERT_EQUAL(JitterBuffer::JB_BUFFERING, jb.state());
+    TEST_ASSERT_EQUAL_UINT32(1, jb.underruns());
+    TEST_ASSERT_FALSE(jb.update(BYTE_RATE, false));
+    TEST_ASSERT_TRUE(jb.update(BYTE_RATE * 2, false));
+    TEST_ASSERT_EQUAL_UINT32(1, jb.underruns());
+}
+
+static void test_source_end_plays_out() {
+    // Ende beim Vorpuffern: der Rest wird ohne Zieltiefe gespielt
+    TEST_ASSERT_TRUE(jb.update(1000, true));
+    TEST_ASSERT_EQUAL(JitterBuffer::JB_PLAYING, jb.state());
+    // Beim Leerlaufen nach dem Ende kein Aussetzer, der Decoder soll das Ende sehen
+    TEST_ASSERT_TRUE(jb.update(100, true));
+    TEST_ASSERT_TRUE(jb.update(0, true));
+    TEST_ASSERT_EQUAL_UINT32(0, jb.underruns());
+
+    jb.begin(BYTE_RATE, CAPACITY);
+    TEST_ASSERT_TRUE(jb.update(0, true));
+}
+
+static void test_skip_prefill_plays_at_once() {
+    jb.skipPrefill();
+    TEST_ASSERT_TRUE(jb.update(BYTE_RATE / 2, false));
+}
+
+static void test_steady_source_keeps_minimum_target() {
+    uint32_t t = 1;
+    for (int i = 0; i < 6000; i++, t += 10) jb.onArrival(t, 160);
+    TEST_ASSERT_EQUAL_UINT32(JITTER_PREFILL_MS, jb.targetMs());
+    TEST_ASSERT_LESS_OR_EQUAL(1, jb.jitterMs());
+}
+
+// Lange Lücke hebt die Zieltiefe an, danach klingt sie mit ca. 45 s Halbwertszeit wieder ab
+static void test_stall_raises_target_then_decays() {
+    uint32_t t = 1;
+    for (int i = 0; i < 100; i++, t += 10) jb.onArrival(t, 160);
+    t += 3000;
+    jb.onArrival(t, 160);
+    TEST_ASSERT_GREATER_OR_EQUAL(6000, jb.targetMs());
+
+    for (int i = 0; i < 4500; i++, t += 10) jb.onArrival(t, 160);  // 45 s
+    uint32_t after_45s = jb.targetMs();
+    // 2 x Spitzenlücke: 6000 ms nach einer Halbwertszeit etwa 3000 ms
+    TEST_ASSERT_UINT32_WITHIN(300, 3000, after_45s);
+
+    for (int i = 0; i < 30000; i++, t += 10) jb.onArrival(t, 160);  // 5 min
+    TEST_ASSERT_EQUAL_UINT32(JITTER_PREFILL_MS, jb.targetMs());
+}
+
+static void test_target_capped_by_ring_and_max() {
+    JitterBuffer small;
+    small.begin(BYTE_RATE, BYTE_RATE * 5);  // 5 s Ring -> höchstens 4 s
+    uint32_t t = 1;
+    small.onArrival(t, 160);
+    small.onArrival(t += 8000, 160);
+    TEST_ASSERT_EQUAL_UINT32(4000, small.targetMs());
+
+    t = 1;
+    jb.onArrival(t, 160);
+    jb.onArrival(t += 20000, 160);
+    TEST_ASSERT_EQUAL_UINT32(JITTER_MAX_MS, jb.targetMs());
+}
+
+// Eine gewollte Pause des Schreibers (Ring voll) zählt nicht als Lücke
+static void test_throttle_gap_is_ignored() {
+    uint32_t t = 1;
+    for (int i = 0; i < 100; i++, t += 10) jb.onArrival(t, 160);
+    jb.onThrottled();
+    t += 5000;
+    jb.onArrival(t, 160);
+    jb.onArrival(t += 10, 160);
+    TEST_ASSERT_EQUAL_UINT32(JITTER_PREFILL_MS, jb.targetMs());
+}
+
+// Quelle mit 3-s-Stockern alle 60 s: nach dem ersten Aussetzer wächst die Tiefe, danach keiner mehr
+static void test_simulated_stalling_source() {
+    uint32_t fill = 0, t = 1;
+    uint32_t next_stall = 30000;
+    for (uint32_t ms = 0; ms < 600000; ms += 10, t += 10) {
+        if (t >= next_stall + 3000) next_stall += 60000;
+        bool stalled = t >= next_stall;
+        if (!stalled && fill + 320 < CAPACITY) {
+            // Das Netz liefert doppelt so schnell, bis die Zieltiefe plus Reserve erreicht ist
+            uint32_t bytes = jb.fillMs(fill) < jb.targetMs() + 2000 ? 320 : 160;
+            fill += bytes;
+            jb.onArrival(t, bytes);
+        }
+        if (jb.update(fill, false)) fill -= fill < 160 ? fill : 160;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(1, jb.underruns());
+    // Letzter Stocker vor 30 s: die Tiefe liegt noch deutlich über dem Minimum
+    TEST_ASSERT_GREATER_OR_EQUAL(3000, jb.targetMs());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_prefill_before_playing);
+    RUN_TEST(test_underrun_rebuffers);
+    RUN_TEST(test_source_end_plays_out);
+    RUN_TEST(test_skip_prefill_plays_at_once);
+    RUN_TEST(test_steady_source_keeps_minimum_target);
+    RUN_TEST(test_stall_raises_target_then_decays);
+    RUN_TEST(test_target_capped_by_ring_and_max);
+    RUN_TEST(test_throttle_gap_is_ignored);
+    RUN_TEST(test_simulated_stalling_source);
+    return UNITY_END();
+}
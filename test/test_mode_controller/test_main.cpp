@@ -0,0 +1,136 @@
+// Moduswechsel: welche Schritte je Übergang laufen, Zeitmessung und Rückfall auf den Neustart
+#include <unity.h>
+#include <string>
+
+#include "mode_controller.h"
+
+// Teilsysteme als Attrappe: protokolliert die Schritte, jeder kostet simulierte Zeit
+class FakeSubsystems : public ModeSubsystems {
+public:
+    std::string log;
+    uint32_t now = 0;
+    uint32_t heap = 100000;
+    bool fail_radio_up = false;
+    bool fail_radio_down = false;
+    uint32_t restarts = 0;
+    AudioMode restart_target = MODE_IDLE;
+    std::string restart_url;
+
+    bool wifiUp() override { return run("wifi+", 1500000, true); }
+    bool wifiDown() override { return run("wifi-", 80000, true); }
+    bool radioUp(const char* url) override { return run(std::string("radio+(") + url + ")", 30000, !fail_radio_up); }
+    bool radioDown() override { return run("radio-", 20000, !fail_radio_down); }
+    bool bluetoothUp() override { return run("bt+", 5000, true); }
+    bool bluetoothDown() override { return run("bt-", 3000, true); }
+    uint32_t freeHeap() override { return heap; }
+    uint32_t micros() override { return now; }
+    void restart(AudioMode target, const char* url) override {
+        restarts++;
+        restart_target = target;
+        restart_url = url;
+        log += "RESTART ";
+    }
+
+private:
+    bool run(const std::string& name, uint32_t us, bool ok) {
+        log += name + " ";
+        now += us;
+        return ok;
+    }
+};
+
+static FakeSubsystems sub;
+
+void setUp() {
+    sub = FakeSubsystems();
+}
+
+void tearDown() {}
+
+static std::string switchLog(ModeController& mc, AudioMode target, const char* url = "u") {
+    sub.log.clear();
+    TEST_ASSERT_TRUE(mc.switchTo(target, url));
+    TEST_ASSERT_EQUAL(target, mc.mode());
+    return sub.log;
+}
+
+// Jeder Übergang baut nur ab, was der Zielmodus nicht braucht, und nur auf, was fehlt
+static void test_transitions_touch_only_needed_subsystems() {
+    ModeController mc(sub, MODE_RADIO);
+    TEST_ASSERT_EQUAL_STRING("radio- wifi- bt+ ", switchLog(mc, MODE_BLUETOOTH).c_str());
+    TEST_ASSERT_EQUAL_STRING("bt- wifi+ radio+(u) ", switchLog(mc, MODE_RADIO).c_str());
+    TEST_ASSERT_EQUAL_STRING("radio- wifi- ", switchLog(mc, MODE_IDLE).c_str());
+    TEST_ASSERT_EQUAL_STRING("bt+ ", switchLog(mc, MODE_BLUETOOTH).c_str());
+    TEST_ASSERT_EQUAL_STRING("bt- ", switchLog(mc, MODE_IDLE).c_str());
+    TEST_ASSERT_EQUAL_STRING("wifi+ radio+(u) ", switchLog(mc, MODE_RADIO).c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, sub.restarts);
+}
+
+static void test_same_mode_does_nothing() {
+    ModeController mc(sub, MODE_BLUETOOTH);
+    TEST_ASSERT_TRUE(mc.switchTo(MODE_BLUETOOTH));
+    TEST_ASSERT_EQUAL_STRING("", sub.log.c_str());
+}
+
+static void test_timing_per_step() {
+    ModeController mc(sub, MODE_BLUETOOTH);
+    switchLog(mc, MODE_RADIO);
+    const ModeTiming& t = mc.lastTiming();
+    TEST_ASSERT_EQUAL(MODE_BLUETOOTH, t.from);
+    TEST_ASSERT_EQUAL(MODE_RADIO, t.to);
+    TEST_ASSERT_EQUAL_UINT8(3, t.steps);
+    TEST_ASSERT_EQUAL_STRING("BT-Ausgabe ab", t.name[0]);
+    TEST_ASSERT_EQUAL_UINT32(3000, t.us[0]);
+    TEST_ASSERT_EQUAL_STRING("WLAN an", t.name[1]);
+    TEST_ASSERT_EQUAL_UINT32(1500000, t.us[1]);
+    TEST_ASSERT_EQUAL_STRING("Radio an", t.name[2]);
+    TEST_ASSERT_EQUAL_UINT32(30000, t.us[2]);
+    TEST_ASSERT_EQUAL_UINT32(1533000, t.total_us);
+}
+
+static void test_low_heap_restarts_without_touching_subsystems() {
+    ModeController mc(sub, MODE_RADIO);
+    sub.heap = MODE_WARM_MIN_HEAP - 1;
+    TEST_ASSERT_FALSE(mc.switchTo(MODE_BLUETOOTH, "u"));
+    TEST_ASSERT_EQUAL_STRING("RESTART ", sub.log.c_str());
+    TEST_ASSERT_EQUAL(MODE_BLUETOOTH, sub.restart_target);
+    TEST_ASSERT_EQUAL(MODE_RADIO, mc.mode());
+}
+
+// Radio hält nicht an (Audio-Task antwortet nicht): nichts freigeben, sondern neu starten
+static void test_radio_down_failure_restarts() {
+    ModeController mc(sub, MODE_RADIO);
+    sub.fail_radio_down = true;
+    sub.log.clear();
+    TEST_ASSERT_FALSE(mc.switchTo(MODE_BLUETOOTH, "u"));
+    TEST_ASSERT_EQUAL_STRING("radio- RESTART ", sub.log.c_str());
+    TEST_ASSERT_EQUAL_UINT32(1, sub.restarts);
+    TEST_ASSERT_EQUAL(MODE_BLUETOOTH, sub.restart_target);
+    TEST_ASSERT_EQUAL(MODE_RADIO, mc.mode());
+    TEST_ASSERT_EQUAL_UINT8(1, mc.lastTiming().steps);
+
+    sub.log.clear();
+    TEST_ASSERT_FALSE(mc.switchTo(MODE_IDLE));
+    TEST_ASSERT_EQUAL_STRING("radio- RESTART ", sub.log.c_str());
+}
+
+static void test_radio_up_failure_restarts_into_target() {
+    ModeController mc(sub, MODE_IDLE);
+    sub.fail_radio_up = true;
+    sub.log.clear();
+    TEST_ASSERT_FALSE(mc.switchTo(MODE_RADIO, "http://x/"));
+    TEST_ASSERT_EQUAL_STRING("wifi+ radio+(http://x/) RESTART ", sub.log.c_str());
+    TEST_ASSERT_EQUAL(MODE_RADIO, sub.restart_target);
+    TEST_ASSERT_EQUAL_STRING("http://x/", sub.restart_url.c_str());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_transitions_touch_only_needed_subsystems);
+    RUN_TEST(test_same_mode_does_nothing);
+    RUN_TEST(test_timing_per_step);
+    RUN_TEST(test_low_heap_restarts_without_touching_subsystems);
+    RUN_TEST(test_radio_down_failure_restarts);
+    RUN_TEST(test_radio_up_failure_restarts_into_target);
+    return UNITY_END();
+}
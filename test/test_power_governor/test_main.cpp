@@ -0,0 +1,126 @@
+// CPU-Takt aus der Last: Lastverläufe (Fenster mit benötigten MHz) gegen die erwarteten Stufen,
+// Ziellast an der Grenze, Hysterese beim Heruntertakten und die Mindestfrequenz je Modus
+#include <unity.h>
+
+#include "power_governor.h"
+
+// Wie power.cpp: ein Fenster pro POWER_WINDOW_MS (500 ms)
+#define WINDOW_US 500000u
+
+void setUp() {}
+void tearDown() {}
+
+// Zyklen eines Fensters, in dem die Audio-Arbeit 'mhz' MHz belegt
+static uint32_t cycles(uint32_t mhz) {
+    return mhz * WINDOW_US;
+}
+
+struct TraceStep {
+    uint16_t needed_mhz;  // gemessene Last im Fenster
+    uint16_t floor_mhz;   // Mindestfrequenz des Modus
+    uint16_t windows;     // so viele Fenster in Folge
+    uint16_t expect_mhz;  // Takt nach dem letzten dieser Fenster
+};
+
+static void runTrace(PowerGovernor& g, const TraceStep* steps, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t mhz = 0;
+        for (uint16_t w = 0; w < steps[i].windows; w++) {
+            mhz = g.update(cycles(steps[i].needed_mhz), WINDOW_US, steps[i].floor_mhz);
+        }
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(steps[i].expect_mhz, mhz, "Schritt des Lastverlaufs");
+    }
+}
+
+// Ohne Last vom Start (240 MHz) in zwei Stufen herunter, je nach POWER_DOWN_WINDOWS Fenstern
+static void test_idle_steps_down_one_level_at_a_time() {
+    PowerGovernor g;
+    TEST_ASSERT_EQUAL_UINT16(240, g.mhz());
+    for (int i = 0; i < POWER_DOWN_WINDOWS - 1; i++) g.update(0, WINDOW_US, 80);
+    TEST_ASSERT_EQUAL_UINT16(240, g.mhz());
+    TEST_ASSERT_EQUAL_UINT16(160, g.update(0, WINDOW_US, 80));
+    for (int i = 0; i < POWER_DOWN_WINDOWS - 1; i++) g.update(0, WINDOW_US, 80);
+    TEST_ASSERT_EQUAL_UINT16(160, g.mhz());
+    TEST_ASSERT_EQUAL_UINT16(80, g.update(0, WINDOW_US, 80));
+    TEST_ASSERT_EQUAL_UINT32(2, g.switches());
+}
+
+// Ziellast 50 %: 40 MHz Arbeit passen auf 80 MHz, ein Zyklus mehr nicht mehr (aufgerundet)
+static void test_target_load_boundary() {
+    static const TraceStep idle[] = { { 0, 80, 2 * POWER_DOWN_WINDOWS, 80 } };
+    PowerGovernor g;
+    runTrace(g, idle, 1);
+    TEST_ASSERT_EQUAL_UINT16(80, g.update(cycles(40), WINDOW_US, 80));
+    TEST_ASSERT_EQUAL_UINT32(40, g.neededMhz());
+    TEST_ASSERT_EQUAL_UINT16(160, g.update(cycles(40) + 1, WINDOW_US, 80));
+    TEST_ASSERT_EQUAL_UINT32(41, g.neededMhz());
+    TEST_ASSERT_EQUAL_UINT16(160, g.update(cycles(80), WINDOW_US, 80));
+    TEST_ASSERT_EQUAL_UINT16(240, g.update(cycles(81), WINDOW_US, 80));
+    // Mehr, als selbst 240 MHz unter der Ziellast schaffen: volle Frequenz
+    TEST_ASSERT_EQUAL_UINT16(240, g.update(cycles(200), WINDOW_US, 80));
+}
+
+// Radio: MP3 dekodieren, Senderwechsel mit Pufferpause, HE-AAC, Lastspitze beim Ausregeln
+static void test_radio_trace() {
+    static const TraceStep trace[] = {
+        { 0, 80, 4, 240 },                       // Verbinden: noch nichts gemessen
+        { 22, 80, POWER_DOWN_WINDOWS, 160 },     // MP3 128 kbps
+        { 22, 80, POWER_DOWN_WINDOWS, 80 },
+        { 22, 80, 20, 80 },
+        { 0, 80, 3, 80 },                        // Senderwechsel, puffert
+        { 55, 80, 1, 160 },                      // HE-AAC: sofort hinauf
+        { 55, 80, 30, 160 },
+        { 95, 80, 1, 240 },                      // Spitze (Bass und EQ neu berechnet)
+        { 55, 80, POWER_DOWN_WINDOWS - 1, 240 }, // noch nicht lange genug ruhig
+        { 55, 80, 1, 160 },
+        { 55, 80, 30, 160 },                     // bleibt: 80 MHz reichen nie
+    };
+    PowerGovernor g;
+    runTrace(g, trace, sizeof(trace) / sizeof(trace[0]));
+    TEST_ASSERT_EQUAL_UINT32(5, g.switches());
+}
+
+// Kurze Lastpausen (Puffern, Pakete fehlen) schalten nicht hin und her
+static void test_short_pauses_do_not_switch() {
+    PowerGovernor g;
+    g.update(cycles(100), WINDOW_US, 80);
+    for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < POWER_DOWN_WINDOWS - 1; i++) g.update(0, WINDOW_US, 80);
+        g.update(cycles(100), WINDOW_US, 80);
+    }
+    TEST_ASSERT_EQUAL_UINT16(240, g.mhz());
+    TEST_ASSERT_EQUAL_UINT32(0, g.switches());
+}
+
+// Bluetooth: nie unter POWER_BT_MIN_MHZ, auch ohne gemessene Last; der Wechsel gilt sofort
+static void test_mode_floor() {
+    static const TraceStep trace[] = {
+        { 10, 80, 2 * POWER_DOWN_WINDOWS, 80 },   // IDLE bzw. leichtes Radio
+        { 10, 160, 1, 160 },                      // Wechsel zu Bluetooth: sofort
+        { 0, 160, 5 * POWER_DOWN_WINDOWS, 160 },  // keine gemessene Arbeit, bleibt
+        { 90, 160, 1, 240 },                      // Bass und EQ auf den A2DP-Paketen
+        { 30, 160, 2 * POWER_DOWN_WINDOWS, 160 },
+        { 30, 80, POWER_DOWN_WINDOWS, 80 },       // zurück zu Radio: herunter erst nach Ruhe
+    };
+    PowerGovernor g;
+    runTrace(g, trace, sizeof(trace) / sizeof(trace[0]));
+}
+
+// Ein Fenster der Länge 0 (loop() zweimal in derselben Mikrosekunde) ändert nichts
+static void test_empty_window_keeps_level() {
+    PowerGovernor g;
+    TEST_ASSERT_EQUAL_UINT16(240, g.update(0, 0, 80));
+    TEST_ASSERT_EQUAL_UINT32(0, g.neededMhz());
+    TEST_ASSERT_EQUAL_UINT32(0, g.switches());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_steps_down_one_level_at_a_time);
+    RUN_TEST(test_target_load_boundary);
+    RUN_TEST(test_radio_trace);
+    RUN_TEST(test_short_pauses_do_not_switch);
+    RUN_TEST(test_mode_floor);
+    RUN_TEST(test_empty_window_keeps_level);
+    return UNITY_END();
+}
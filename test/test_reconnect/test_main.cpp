@@ -0,0 +1,177 @@
+// Wiederverbindung: Backoff-Folge, Streuung, Deckel, Zustandswechsel und Überlauf von millis()
+#include <unity.h>
+#include <algorithm>
+
+#include "reconnect.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_disconnect_waits_base_delay() {
+    ReconnectPolicy rc(42);
+    rc.onDisconnect(1000);
+    TEST_ASSERT_EQUAL(ReconnectPolicy::RC_WAITING, rc.state());
+    TEST_ASSERT_UINT32_WITHIN(RECONNECT_BASE_MS / 4, RECONNECT_BASE_MS * 3 / 4, rc.backoffMs());
+
+    uint32_t due_at = 1000 + rc.backoffMs();
+    TEST_ASSERT_FALSE(rc.due(due_at - 1));
+    TEST_ASSERT_EQUAL_UINT32(1, rc.remainingMs(due_at - 1));
+    TEST_ASSERT_TRUE(rc.due(due_at));
+    TEST_ASSERT_EQUAL(ReconnectPolicy::RC_CONNECTING, rc.state());
+    // Während ein Versuch läuft, ist kein weiterer fällig
+    TEST_ASSERT_FALSE(rc.due(due_at + 100000));
+}
+
+// Jeder Fehlversuch verdoppelt die Obergrenze; gestreut wird zwischen halber und ganzer Wartezeit
+static void test_failures_double_backoff_up_to_cap() {
+    ReconnectPolicy rc(7);
+    uint32_t now = 0;
+    rc.onDisconnect(now);
+    for (uint16_t failure = 1; failure <= 20; failure++) {
+        now += rc.backoffMs();
+        TEST_ASSERT_TRUE(rc.due(now));
+        rc.onFailure(now);
+        TEST_ASSERT_EQUAL_UINT16(failure, rc.failures());
+
+        uint32_t d = std::min<uint32_t>(RECONNECT_BASE_MS << std::min<uint16_t>(failure, 16), RECONNECT_MAX_MS);
+        TEST_ASSERT_GREATER_OR_EQUAL(d / 2, rc.backoffMs());
+        TEST_ASSERT_LESS_OR_EQUAL(d, rc.backoffMs());
+    }
+}
+
+// Auch nach sehr vielen Fehlversuchen kein Überlauf der Verdopplung
+static void test_failure_counter_saturates() {
+    ReconnectPolicy rc(3);
+    rc.onDisconnect(0);
+    for (uint32_t i = 0; i < 70000; i++) rc.onFailure(0);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, rc.failures());
+    TEST_ASSERT_LESS_OR_EQUAL(RECONNECT_MAX_MS, rc.backoffMs());
+    TEST_ASSERT_GREATER_OR_EQUAL(RECONNECT_MAX_MS / 2, rc.backoffMs());
+}
+
+static void test_success_resets() {
+    ReconnectPolicy rc(5);
+    rc.onDisconnect(0);
+    rc.onFailure(0);
+    rc.onFailure(0);
+    rc.due(100000);
+    rc.onSuccess();
+    TEST_ASSERT_EQUAL(ReconnectPolicy::RC_CONNECTED, rc.state());
+    TEST_ASSERT_EQUAL_UINT16(0, rc.failures());
+    TEST_ASSERT_EQUAL_UINT32(0, rc.backoffMs());
+    TEST_ASSERT_EQUAL_UINT32(0, rc.remainingMs(100000));
+
+    // Nächster Verlust beginnt wieder bei der Basis
+    rc.onDisconnect(200000);
+    TEST_ASSERT_LESS_OR_EQUAL(RECONNECT_BASE_MS, rc.backoffMs());
+}
+
+static void test_trigger_is_due_immediately() {
+    ReconnectPolicy rc(9);
+    rc.onDisconnect(0);
+    rc.onFailure(0);
+    rc.onFailure(0);
+    rc.trigger(5000);
+    TEST_ASSERT_EQUAL_UINT16(0, rc.failures());
+    TEST_ASSERT_EQUAL_UINT32(0, rc.remainingMs(5000));
+    TEST_ASSERT_TRUE(rc.due(5000));
+}
+
+// Gezählt wird nur, was nach einem Verlust oder Fehlversuch wieder verbunden hat; der erste
+// Aufbau nach trigger() (Start, Senderwechsel) ist keine Wiederverbindung
+static void test_reconnects_count_only_after_loss() {
+    ReconnectPolicy rc(21);
+    rc.trigger(0);
+    TEST_ASSERT_TRUE(rc.due(0));
+    rc.onSuccess();
+    TEST_ASSERT_EQUAL_UINT32(0, rc.reconnects());
+
+    // Senderwechsel
+    rc.trigger(1000);
+    TEST_ASSERT_TRUE(rc.due(1000));
+    rc.onSuccess();
+    TEST_ASSERT_EQUAL_UINT32(0, rc.reconnects());
+
+    // Verbindung verloren und wieder da
+    rc.onDisconnect(2000);
+    TEST_ASSERT_TRUE(rc.due(2000 + rc.backoffMs()));
+    rc.onSuccess();
+    TEST_ASSERT_EQUAL_UINT32(1, rc.reconnects());
+
+    // Senderwechsel, erster Versuch scheitert, der zweite klappt
+    rc.trigger(10000);
+    TEST_ASSERT_TRUE(rc.due(10000));
+    rc.onFailure(10000);
+    TEST_ASSERT_TRUE(rc.due(10000 + rc.backoffMs()));
+    rc.onSuccess();
+    TEST_ASSERT_EQUAL_UINT32(2, rc.reconnects());
+
+    // Ein onSuccess() ohne laufenden Versuch zählt nicht
+    rc.onSuccess();
+    TEST_ASSERT_EQUAL_UINT32(2, rc.reconnects());
+}
+
+// Ein zweites onDisconnect() während des Backoffs setzt die Folge nicht zurück
+static void test_disconnect_ignored_while_reconnecting() {
+    ReconnectPolicy rc(11);
+    rc.onDisconnect(0);
+    rc.onFailure(0);
+    rc.onFailure(0);
+    uint32_t backoff = rc.backoffMs();
+    rc.onDisconnect(10);
+    TEST_ASSERT_EQUAL_UINT16(2, rc.failures());
+    TEST_ASSERT_EQUAL_UINT32(backoff, rc.backoffMs());
+}
+
+// millis() läuft nach ca. 49 Tagen über; fällig bleibt fällig
+static void test_due_across_millis_overflow() {
+    ReconnectPolicy rc(13);
+    uint32_t now = 0xFFFFFF00u;
+    rc.onDisconnect(now);
+    uint32_t due_at = now + rc.backoffMs();  // läuft über
+    TEST_ASSERT_TRUE(due_at < now);
+    TEST_ASSERT_FALSE(rc.due(now + 1));
+    TEST_ASSERT_GREATER_THAN_UINT32(0, rc.remainingMs(now + 1));
+    TEST_ASSERT_TRUE(rc.due(due_at));
+}
+
+// Gleicher Seed, gleiche Folge; verschiedene Geräte streuen über den ganzen Bereich
+static void test_jitter_is_reproducible_and_spread() {
+    ReconnectPolicy a(1234), b(1234);
+    a.onDisconnect(0);
+    b.onDisconnect(0);
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_UINT32(a.backoffMs(), b.backoffMs());
+        a.onFailure(0);
+        b.onFailure(0);
+    }
+
+    // 200 Geräte nach 4 Fehlversuchen (Obergrenze 8 s): Werte über die ganze obere Hälfte verteilt
+    uint32_t lo = UINT32_MAX, hi = 0, buckets[4] = {};
+    for (uint32_t dev = 1; dev <= 200; dev++) {
+        ReconnectPolicy rc(dev * 2654435761u);
+        rc.onDisconnect(0);
+        for (int i = 0; i < 4; i++) rc.onFailure(0);
+        uint32_t v = rc.backoffMs();
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+        buckets[std::min<uint32_t>((v - 4000) * 4 / 4001, 3)]++;
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(4000, lo);
+    TEST_ASSERT_LESS_OR_EQUAL(8000, hi);
+    for (uint32_t n : buckets) TEST_ASSERT_GREATER_THAN_UINT32(20, n);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_disconnect_waits_base_delay);
+    RUN_TEST(test_failures_double_backoff_up_to_cap);
+    RUN_TEST(test_failure_counter_saturates);
+    RUN_TEST(test_success_resets);
+    RUN_TEST(test_trigger_is_due_immediately);
+    RUN_TEST(test_reconnects_count_only_after_loss);
+    RUN_TEST(test_disconnect_ignored_while_reconnecting);
+    RUN_TEST(test_due_across_millis_overflow);
+    RUN_TEST(test_jitter_is_reproducible_and_spread);
+    return UNITY_END();
+}
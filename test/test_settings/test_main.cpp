@@ -0,0 +1,147 @@
+// Einstellungsspeicher: Laden, gesammeltes Schreiben nach der Ruhezeit, nur geänderte Schlüssel,
+// und dass Zugriffe aus anderen Tasks nicht auf einen laufenden Flash-Schreibzugriff warten
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <Preferences.h>
+
+#include "settings.h"
+
+void setUp() {
+    mock::reset();
+    mock::nvs_clear();
+    settings_load();
+}
+
+void tearDown() {}
+
+static uint32_t nvsUInt(const char* key) {
+    const std::vector<uint8_t>& v = mock::nvs["audio_config"][key];
+    uint32_t value = 0;
+    if (v.size() == sizeof(value)) memcpy(&value, v.data(), sizeof(value));
+    return value;
+}
+
+static void test_load_reads_stored_values() {
+    Preferences p;
+    p.begin("audio_config");
+    p.putUInt("audio_mode", 1);
+    p.putUInt("audio_volume", 77);
+    p.putString("radio_url", "http://radio/live");
+    p.end();
+
+    settings_load();
+    TEST_ASSERT_EQUAL_UINT32(1, settings_mode());
+    TEST_ASSERT_EQUAL(77, settings_volume());
+    TEST_ASSERT_EQUAL_STRING("http://radio/live", settings_radio_url().c_str());
+    TEST_ASSERT_EQUAL_STRING("", settings_bt_addr().c_str());
+    EQBand bands[EQ_MAX_BANDS];
+    TEST_ASSERT_FALSE(settings_eq_bands(bands));
+}
+
+// Schnell gedrehter Encoder: ein Schreibzugriff, wenn SETTINGS_FLUSH_DELAY_MS Ruhe war
+static void test_changes_are_coalesced() {
+    uint32_t before = settings_flash_writes();
+    for (int v = 10; v < 60; v++) {
+        mock::advance_ms(50);
+        settings_set_volume(v);
+        TEST_ASSERT_FALSE(settings_poll());
+    }
+    mock::advance_ms(SETTINGS_FLUSH_DELAY_MS - 1);
+    TEST_ASSERT_FALSE(settings_poll());
+    mock::advance_ms(1);
+    TEST_ASSERT_TRUE(settings_poll());
+    TEST_ASSERT_EQUAL_UINT32(1, mock::nvs_writes);
+    TEST_ASSERT_EQUAL_UINT32(before + 1, settings_flash_writes());
+    TEST_ASSERT_EQUAL_UINT32(59, nvsUInt("audio_volume"));
+    // Nichts mehr offen
+    mock::advance_ms(SETTINGS_FLUSH_DELAY_MS);
+    TEST_ASSERT_FALSE(settings_poll());
+}
+
+static void test_only_changed_keys_are_written() {
+    settings_set_mode(settings_mode());
+    settings_set_radio_url("");
+    settings_flush();
+    TEST_ASSERT_EQUAL_UINT32(0, mock::nvs_writes);
+
+    settings_set_mode(2);
+    settings_set_bt_addr("ab:cd:ef:12:34:56");
+    EQBand bands[EQ_MAX_BANDS] = {};
+    bands[1] = { BIQUAD_PEAKING, 1, 2000, 6.0f, 1.0f };
+    settings_set_eq_bands(bands);
+    settings_flush();
+    TEST_ASSERT_EQUAL_UINT32(3, mock::nvs_writes);
+    TEST_ASSERT_EQUAL_UINT32(2, nvsUInt("audio_mode"));
+    TEST_ASSERT_TRUE(mock::nvs["audio_config"].count("radio_url") == 0);
+
+    // Gleiche Bänder noch einmal: kein Schreiben
+    settings_set_eq_bands(bands);
+    settings_flush();
+    TEST_ASSERT_EQUAL_UINT32(3, mock::nvs_writes);
+
+    settings_load();
+    EQBand loaded[EQ_MAX_BANDS];
+    TEST_ASSERT_TRUE(settings_eq_bands(loaded));
+    TEST_ASSERT_EQUAL_MEMORY(bands, loaded, sizeof(bands));
+}
+
+// Der Flash-Zugriff läuft ohne den Mutex: Getter und Setter aus anderen Tasks warten nicht darauf.
+// Eine Änderung während des Schreibens geht mit dem nächsten Schreiben raus.
+static void test_access_during_flash_write_does_not_block() {
+    settings_set_volume(40);
+    settings_set_radio_url("http://a/");
+    mock::nvs_write_us = 150000;  // 150 ms je Schlüssel
+
+    std::atomic<bool> done{false};
+    std::thread flusher([&] {
+        settings_flush();
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+    auto start = std::chrono::steady_clock::now();
+    int volume = settings_volume();
+    settings_set_volume(41);
+    String url = settings_radio_url();
+    auto waited = std::chrono::steady_clock::now() - start;
+    bool still_writing = !done;
+    flusher.join();
+
+    TEST_ASSERT_TRUE(still_writing);
+    TEST_ASSERT_LESS_THAN(50, (int)std::chrono::duration_cast<std::chrono::milliseconds>(waited).count());
+    TEST_ASSERT_EQUAL(40, volume);
+    TEST_ASSERT_EQUAL_STRING("http://a/", url.c_str());
+
+    // Geschrieben wurde der Stand vom Aufruf, die neue Lautstärke ist wieder offen
+    TEST_ASSERT_EQUAL_UINT32(40, nvsUInt("audio_volume"));
+    mock::nvs_write_us = 0;
+    settings_flush();
+    TEST_ASSERT_EQUAL_UINT32(41, nvsUInt("audio_volume"));
+    TEST_ASSERT_EQUAL_UINT32(3, mock::nvs_writes);
+}
+
+// Zwei Schreiber gleichzeitig (loop() und Neustart): der neuere Stand steht am Ende im NVS
+static void test_concurrent_flushes_keep_latest_value() {
+    mock::nvs_write_us = 50000;
+    settings_set_volume(10);
+    std::thread first([] { settings_flush(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    settings_set_volume(20);
+    settings_flush();
+    first.join();
+    mock::nvs_write_us = 0;
+    TEST_ASSERT_EQUAL_UINT32(20, nvsUInt("audio_volume"));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_load_reads_stored_values);
+    RUN_TEST(test_changes_are_coalesced);
+    RUN_TEST(test_only_changed_keys_are_written);
+    RUN_TEST(test_access_during_flash_write_does_not_block);
+    RUN_TEST(test_concurrent_flushes_keep_latest_value);
+    return UNITY_END();
+}
@@ -0,0 +1,133 @@
+// SPSC-Ring: Randfälle am Pufferende und ein Schreiber-/Leser-Paar in zwei Threads
+#include <unity.h>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+static uint8_t mem[1024];
+static SpscRing ring;
+
+void setUp() {
+    memset(mem, 0, sizeof(mem));
+    ring.init(mem, sizeof(mem));
+}
+
+void tearDown() {}
+
+static void test_one_byte_stays_free() {
+    TEST_ASSERT_EQUAL(1023, ring.capacity());
+    std::vector<uint8_t> data(2000, 0x5A);
+    TEST_ASSERT_EQUAL(1023, ring.write(data.data(), data.size()));
+    TEST_ASSERT_EQUAL(1023, ring.fill());
+    TEST_ASSERT_EQUAL(0, ring.space());
+    uint8_t* span;
+    TEST_ASSERT_EQUAL(0, ring.writeSpan(&span));
+
+    std::vector<uint8_t> out(2000);
+    TEST_ASSERT_EQUAL(1023, ring.read(out.data(), out.size()));
+    TEST_ASSERT_EQUAL(0, ring.fill());
+    const uint8_t* rspan;
+    TEST_ASSERT_EQUAL(0, ring.readSpan(&rspan));
+}
+
+// Über das Pufferende hinweg: Spans enden am Ende, read()/write() setzen vorne fort
+static void test_wrap_around_keeps_order() {
+    std::vector<uint8_t> a(700), b(600), out(700);
+    for (size_t i = 0; i < a.size(); i++) a[i] = (uint8_t)i;
+    for (size_t i = 0; i < b.size(); i++) b[i] = (uint8_t)(i * 7 + 3);
+
+    ring.write(a.data(), a.size());
+    TEST_ASSERT_EQUAL(700, ring.read(out.data(), out.size()));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(a.data(), out.data(), a.size());
+    TEST_ASSERT_EQUAL(0, ring.fill());
+
+    uint8_t* span;
+    TEST_ASSERT_EQUAL(324, ring.writeSpan(&span));
+    TEST_ASSERT_EQUAL_PTR(mem + 700, span);
+
+    TEST_ASSERT_EQUAL(600, ring.write(b.data(), b.size()));
+    TEST_ASSERT_EQUAL(600, ring.fill());
+    const uint8_t* rspan;
+    TEST_ASSERT_EQUAL(324, ring.readSpan(&rspan));
+
+    TEST_ASSERT_EQUAL(600, ring.read(out.data(), out.size()));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(b.data(), out.data(), b.size());
+}
+
+// Schreibindex am Ende bei Leseindex 0: das letzte Byte bleibt frei
+static void test_write_span_stops_before_tail_at_zero() {
+    std::vector<uint8_t> data(1023, 1);
+    uint8_t* span;
+    TEST_ASSERT_EQUAL(1023, ring.writeSpan(&span));
+    ring.write(data.data(), 1000);
+    TEST_ASSERT_EQUAL(23, ring.writeSpan(&span));
+    ring.produce(23);
+    TEST_ASSERT_EQUAL(0, ring.writeSpan(&span));
+    TEST_ASSERT_EQUAL(1023, ring.fill());
+}
+
+static void test_clear_drops_everything() {
+    std::vector<uint8_t> data(500, 9);
+    ring.write(data.data(), data.size());
+    ring.clear();
+    TEST_ASSERT_EQUAL(0, ring.fill());
+    TEST_ASSERT_EQUAL(1023, ring.space());
+}
+
+// Netzwerk-Task und Decoder nachgestellt: ungleiche Häppchen, Spans auf beiden Seiten,
+// ungerade Ringgröße. Jedes Byte muss genau einmal und in der richtigen Reihenfolge ankommen.
+static void test_threaded_producer_consumer() {
+    static uint8_t odd[997];
+    SpscRing r;
+    r.init(odd, sizeof(odd));
+    const size_t total = 8u << 20;
+
+    std::thread producer([&] {
+        size_t sent = 0;
+        uint32_t chunk = 1;
+        while (sent < total) {
+            uint8_t* span;
+            size_t n = r.writeSpan(&span);
+            if (n == 0) { std::this_thread::yield(); continue; }
+            chunk = chunk * 1103515245u + 12345u;
+            size_t want = 1 + (chunk >> 16) % 600;
+            if (n > want) n = want;
+            if (n > total - sent) n = total - sent;
+            for (size_t i = 0; i < n; i++) span[i] = (uint8_t)((sent + i) * 31 + ((sent + i) >> 8));
+            r.produce(n);
+            sent += n;
+        }
+    });
+
+    size_t received = 0, errors = 0;
+    uint32_t chunk = 7;
+    while (received < total) {
+        const uint8_t* span;
+        size_t n = r.readSpan(&span);
+        if (n == 0) { std::this_thread::yield(); continue; }
+        chunk = chunk * 1103515245u + 12345u;
+        size_t want = 1 + (chunk >> 16) % 450;
+        if (n > want) n = want;
+        for (size_t i = 0; i < n; i++) {
+            errors += span[i] != (uint8_t)((received + i) * 31 + ((received + i) >> 8));
+        }
+        r.consume(n);
+        received += n;
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL(0, errors);
+    TEST_ASSERT_EQUAL(total, received);
+    TEST_ASSERT_EQUAL(0, r.fill());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_one_byte_stays_free);
+    RUN_TEST(test_wrap_around_keeps_order);
+    RUN_TEST(test_write_span_stops_before_tail_at_zero);
+    RUN_TEST(test_clear_drops_everything);
+    RUN_TEST(test_threaded_producer_consumer);
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+// Sender-Cache: gemerktes Ziel zuerst öffnen, bei veraltetem Ziel (404, geschlossene Verbindung)
+// genau einmal über die Preset-URL neu auflösen und den Eintrag umschreiben; gegen einen lokalen
+// Server mit HttpStream wie AudioFileSourceStation
+#include <unity.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Preferences.h>
+
+#include "station_cache.h"
+#include "posix_transport.h"
+#include "icy_server.h"
+
+static std::unique_ptr<IcyServer> server;
+
+void setUp() {
+    mock::nvs_clear();
+    mock::serial.clear();
+    server.reset(new IcyServer());
+}
+
+void tearDown() {
+    server.reset();
+}
+
+// Öffnet wie AudioFileSourceRing::openSource() und merkt sich die angefragten Ziele
+struct Opener {
+    HttpStream& http;
+    std::vector<std::string>& urls;
+    bool operator()(const char* url, StationInfo& info) {
+        urls.push_back(url);
+        return http.open(url, info);
+    }
+};
+
+// Preset /preset leitet auf /new weiter, dort läuft der Stream
+static void routeStation() {
+    IcyServer::Route r;
+    r.head = "HTTP/1.1 302 Found\r\nLocation: /new\r\n";
+    server->route("/preset", r);
+    IcyServer::Route live;
+    live.head = "HTTP/1.0 200 OK\r\nContent-Type: audio/aacp\r\nicy-br: 64\r\nicy-sr: 48000\r\n";
+    live.stream_bytes = 1000;
+    server->route("/new", live);
+}
+
+// Eintrag, wie ihn ein früherer Start mit dem alten Ziel hinterlassen hat
+static void cacheTarget(const std::string& preset, const std::string& target) {
+    StationInfo old = {};
+    snprintf(old.url, sizeof(old.url), "%s", target.c_str());
+    snprintf(old.content_type, sizeof(old.content_type), "audio/mpeg");
+    old.bitrate_kbps = 128;
+    old.sample_rate = 44100;
+    station_cache_store(preset.c_str(), old);
+}
+
+static void assertFallback(const std::string& stale) {
+    std::string preset = server->url("/preset");
+    PosixTransport net;
+    HttpStream http(net);
+    std::vector<std::string> urls;
+    uint32_t fallbacks = 0;
+    StationInfo info;
+    TEST_ASSERT_TRUE(station_open(preset.c_str(), info, Opener{ http, urls }, &fallbacks));
+    TEST_ASSERT_TRUE(http.isOpen());
+
+    TEST_ASSERT_EQUAL_UINT32(1, fallbacks);
+    TEST_ASSERT_EQUAL(2, urls.size());
+    TEST_ASSERT_EQUAL_STRING(stale.c_str(), urls[0].c_str());
+    TEST_ASSERT_EQUAL_STRING(preset.c_str(), urls[1].c_str());
+    TEST_ASSERT_EQUAL_STRING(server->url("/new").c_str(), info.url);
+    TEST_ASSERT_TRUE(mock::serial.find("Gemerktes Ziel nicht erreichbar") != std::string::npos);
+
+    // Der Eintrag zeigt jetzt auf das neue Ziel, mit dessen Headern
+    StationInfo cached;
+    TEST_ASSERT_TRUE(station_cache_load(preset.c_str(), cached));
+    TEST_ASSERT_EQUAL_STRING(server->url("/new").c_str(), cached.url);
+    TEST_ASSERT_EQUAL_STRING("audio/aacp", cached.content_type);
+    TEST_ASSERT_EQUAL_UINT16(64, cached.bitrate_kbps);
+    TEST_ASSERT_EQUAL_UINT32(48000, cached.sample_rate);
+
+    // Der nächste Start nimmt das neue Ziel direkt, ohne Weiterleitung und ohne Schreibzugriff
+    uint32_t writes = mock::nvs_writes;
+    urls.clear();
+    fallbacks = 0;
+    TEST_ASSERT_TRUE(station_open(preset.c_str(), info, Opener{ http, urls }, &fallbacks));
+    TEST_ASSERT_EQUAL_UINT32(0, fallbacks);
+    TEST_ASSERT_EQUAL(1, urls.size());
+    TEST_ASSERT_EQUAL_STRING(server->url("/new").c_str(), urls[0].c_str());
+    TEST_ASSERT_EQUAL_UINT32(writes, mock::nvs_writes);
+    http.close();
+}
+
+// Ohne Eintrag: voller Weg, kein Rückfall, das Ziel wird gemerkt
+static void test_first_start_resolves_and_stores() {
+    routeStation();
+    std::string preset = server->url("/preset");
+    PosixTransport net;
+    HttpStream http(net);
+    std::vector<std::string> urls;
+    uint32_t fallbacks = 0;
+    StationInfo info;
+    TEST_ASSERT_TRUE(station_open(preset.c_str(), info, Opener{ http, urls }, &fallbacks));
+    TEST_ASSERT_EQUAL_UINT32(0, fallbacks);
+    TEST_ASSERT_EQUAL(1, urls.size());
+    StationInfo cached;
+    TEST_ASSERT_TRUE(station_cache_load(preset.c_str(), cached));
+    TEST_ASSERT_EQUAL_STRING(server->url("/new").c_str(), cached.url);
+    http.close();
+}
+
+// Das gemerkte Ziel gibt es nicht mehr
+static void test_stale_target_404_falls_back_once() {
+    routeStation();
+    IcyServer::Route gone;
+    gone.head = "HTTP/1.0 404 Not Found\r\n";
+    server->route("/old", gone);
+    cacheTarget(server->url("/preset"), server->url("/old"));
+    assertFallback(server->url("/old"));
+}
+
+// Das gemerkte Ziel nimmt die Verbindung an und schließt sie ohne Statuszeile
+static void test_stale_target_closing_falls_back_once() {
+    routeStation();
+    server->route("/old", IcyServer::Route{});
+    cacheTarget(server->url("/preset"), server->url("/old"));
+    assertFallback(server->url("/old"));
+}
+
+// Auch die Preset-URL scheitert: ein Rückfall, false, der alte Eintrag bleibt unverändert
+static void test_both_fail() {
+    cacheTarget(server->url("/preset"), server->url("/old"));
+    PosixTransport net;
+    HttpStream http(net);
+    std::vector<std::string> urls;
+    uint32_t fallbacks = 0;
+    StationInfo info;
+    TEST_ASSERT_FALSE(station_open(server->url("/preset").c_str(), info, Opener{ http, urls }, &fallbacks));
+    TEST_ASSERT_EQUAL_UINT32(1, fallbacks);
+    TEST_ASSERT_EQUAL(2, urls.size());
+    StationInfo cached;
+    TEST_ASSERT_TRUE(station_cache_load(server->url("/preset").c_str(), cached));
+    TEST_ASSERT_EQUAL_STRING(server->url("/old").c_str(), cached.url);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_start_resolves_and_stores);
+    RUN_TEST(test_stale_target_404_falls_back_once);
+    RUN_TEST(test_stale_target_closing_falls_back_once);
+    RUN_TEST(test_both_fail);
+    return UNITY_END();
+}
@@ -0,0 +1,327 @@
+// Gestörtes Netz Ende zu Ende: StreamReader (der Netzwerk-Task von stream_ring.cpp) mit
+// HttpStream gegen den lokalen Server mit Bandbreite, Jitter, Stalls, Abbrüchen und kaputten
+// Weiterleitungen, dahinter ein Leser mit der Stream-Bitrate. Läuft in Echtzeit; je Szenario
+// werden Aussetzer, Zeit bis zum ersten Ton und Wiederverbindungsdauer ausgegeben.
+#include <unity.h>
+#include <stdio.h>
+#include <memory>
+#include <vector>
+
+#include "http_stream.h"
+#include "stream_reader.h"
+#include "posix_transport.h"
+#include "icy_server.h"
+
+// 128 kbit/s wie STREAM_BITRATE_KBPS, Ring für 15 s
+#define HARNESS_BYTE_RATE 16000
+#define HARNESS_RING_BYTES (15 * HARNESS_BYTE_RATE)
+
+/**
+ * @brief StreamReader über HttpStream und der Audio-Task in einem Thread, ohne FreeRTOS. Als
+ * Quelle prüft der Harness jedes empfangene Byte gegen das Muster des Servers (je Verbindung ab 0).
+ */
+class StreamHarness : private StreamReaderSource {
+public:
+    PosixTransport net;
+    HttpStream http{net};
+    ReconnectPolicy reconnect{17};
+    JitterBuffer jitter;
+    SpscRing ring;
+    StreamReader reader{*this, ring, jitter, reconnect};
+
+    uint32_t opens = 0;           // erfolgreiche open()
+    uint32_t failed_opens = 0;
+    uint32_t losses = 0;          // erkannte Verbindungsverluste
+    uint32_t corrupt = 0;         // Bytes, die nicht zum Muster passen
+    uint32_t played = 0;          // vom Leser verbrauchte Bytes
+    uint32_t first_audio_ms = 0;  // ab start(), 0 = noch nichts gespielt
+    uint32_t connect_ms = 0;      // ab start() bis zur ersten Verbindung (samt Fehlversuchen)
+    std::vector<uint32_t> reconnect_ms;  // Dauer vom Verlust bis zur neuen Verbindung
+
+    explicit StreamHarness(const std::string& url, uint32_t preroll = 0) : _url(url) {
+        _mem.resize(HARNESS_RING_BYTES + 1);
+        ring.init(_mem.data(), _mem.size());
+        jitter.begin(HARNESS_BYTE_RATE, ring.capacity());
+        if (preroll > 0) {
+            std::vector<uint8_t> silence(preroll);
+            ring.write(silence.data(), silence.size());
+            jitter.skipPrefill();
+        }
+        _start = net.millis();
+        _lastPlay = _start;
+        reader.begin(_start);
+    }
+
+    void run(uint32_t ms) {
+        uint32_t end = net.millis() + ms;
+        while ((int32_t)(net.millis() - end) < 0) {
+            bool busy = readerStep();
+            playerStep();
+            if (!busy) net.idle();
+        }
+    }
+
+    void setUrl(const std::string& url) { _url = url; }
+
+    // Kennzahlen des Szenarios für das Test-Protokoll
+    void report(const char* scenario) {
+        uint32_t max_ms = 0, sum_ms = 0;
+        for (uint32_t ms : reconnect_ms) {
+            sum_ms += ms;
+            if (ms > max_ms) max_ms = ms;
+        }
+        char audio[32];
+        if (played > 0) snprintf(audio, sizeof(audio), "nach %u ms", first_audio_ms);
+        else snprintf(audio, sizeof(audio), "noch nicht");
+        char msg[200];
+        snprintf(msg, sizeof(msg), "%s: %u Aussetzer, verbunden nach %u ms, erster Ton %s, "
+                 "%u Neuverbindungen (Mittel %u ms, max. %u ms)", scenario, jitter.underruns(),
+                 connect_ms, audio, (unsigned)reconnect_ms.size(),
+                 reconnect_ms.empty() ? 0 : sum_ms / (uint32_t)reconnect_ms.size(), max_ms);
+        TEST_MESSAGE(msg);
+    }
+
+private:
+    std::vector<uint8_t> _mem;
+    std::string _url;
+    uint32_t _start;
+    uint32_t _lastPlay;
+    size_t _offset = 0;    // Position im Muster der aktuellen Verbindung
+    uint64_t _owed = 0;    // Bytes * 1000, die der Leser seit _lastPlay verbrauchen darf
+
+    bool openStream() override {
+        StationInfo info;
+        _offset = 0;
+        return http.open(_url.c_str(), info);
+    }
+
+    int32_t readStream(uint8_t* dst, size_t len) override {
+        int32_t got = http.read(dst, len);
+        for (int32_t i = 0; i < got; i++) {
+            if (dst[i] != IcyServer::streamByte(_offset + i)) corrupt++;
+        }
+        if (got > 0) _offset += got;
+        return got;
+    }
+
+    void closeStream() override { http.close(); }
+    uint32_t millis() override { return net.millis(); }
+
+    bool readerStep() {
+        switch (reader.step()) {
+        case StreamReader::SR_CONNECTED:
+            opens++;
+            if (opens == 1) connect_ms = reader.reconnectMs();
+            else reconnect_ms.push_back(reader.reconnectMs());
+            return true;
+        case StreamReader::SR_CONNECT_FAILED:
+            failed_opens++;
+            return true;
+        case StreamReader::SR_LOST:
+            losses++;
+            return false;
+        case StreamReader::SR_DATA:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void playerStep() {
+        uint32_t now = net.millis();
+        _owed += (uint64_t)(now - _lastPlay) * HARNESS_BYTE_RATE;
+        _lastPlay = now;
+        if (!jitter.update(ring.fill(), false)) {
+            _owed = 0;  // pausiert: die Wiedergabe holt nichts nach
+            return;
+        }
+        const uint8_t* span;
+        while (_owed >= 1000) {
+            size_t n = ring.readSpan(&span);
+            if (n == 0) break;
+            if (n > _owed / 1000) n = _owed / 1000;
+            ring.consume(n);
+            played += n;
+            _owed -= (uint64_t)n * 1000;
+        }
+        if (played > 0 && first_audio_ms == 0) first_audio_ms = now - _start;
+    }
+};
+
+static std::unique_ptr<IcyServer> server;
+
+void setUp() {
+    server.reset(new IcyServer());
+}
+
+void tearDown() {
+    server.reset();
+}
+
+static IcyServer::Route faultyStream(const StreamFaultConfig& fault) {
+    IcyServer::Route r;
+    r.head = "HTTP/1.0 200 OK\r\nContent-Type: audio/mpeg\r\n";
+    r.stream_bytes = 100u << 20;
+    r.fault = fault;
+    return r;
+}
+
+// Doppelte Stream-Bitrate: Vorpuffer nach der halben Zeit, danach keine Aussetzer
+static void test_fast_link_prefills_and_plays() {
+    StreamFaultConfig f = IcyServer::noFaults();
+    f.bandwidth_kbps = 256;
+    server->route("/live", faultyStream(f));
+    StreamHarness h(server->url("/live"));
+    h.run(2000);
+    h.report("Schnelle Leitung (256 kbps)");
+
+    TEST_ASSERT_EQUAL_UINT32(1, h.opens);
+    TEST_ASSERT_EQUAL_UINT32(0, h.reconnect.reconnects());
+    TEST_ASSERT_EQUAL_UINT32(0, h.corrupt);
+    TEST_ASSERT_EQUAL_UINT32(0, h.jitter.underruns());
+    TEST_ASSERT_EQUAL(JitterBuffer::JB_PLAYING, h.jitter.state());
+    TEST_ASSERT_UINT32_WITHIN(300, JITTER_PREFILL_MS / 2, h.first_audio_ms);
+}
+
+// Halbe Stream-Bitrate nach dem Preroll: der Puffer läuft leer und füllt sich neu, die
+// Verbindung bleibt dabei stehen
+static void test_slow_link_rebuffers_without_reconnect() {
+    StreamFaultConfig f = IcyServer::noFaults();
+    f.bandwidth_kbps = 64;
+    server->route("/live", faultyStream(f));
+    StreamHarness h(server->url("/live"), HARNESS_BYTE_RATE / 2);
+    h.run(1800);
+    h.report("Langsame Leitung (64 kbps)");
+
+    TEST_ASSERT_EQUAL_UINT32(1, h.jitter.underruns());
+    TEST_ASSERT_EQUAL(JitterBuffer::JB_BUFFERING, h.jitter.state());
+    TEST_ASSERT_EQUAL_UINT32(1, h.opens);
+    TEST_ASSERT_EQUAL_UINT32(0, h.losses);
+    TEST_ASSERT_EQUAL_UINT32(0, h.corrupt);
+}
+
+// Zufällige Pausen nach jedem Häppchen: gemessener Jitter steigt, Daten bleiben korrekt
+static void test_jitter_is_measured() {
+    StreamFaultConfig f = IcyServer::noFaults();
+    f.bandwidth_kbps = 256;
+    f.jitter_ms = 200;
+    server->route("/live", faultyStream(f));
+    StreamHarness h(server->url("/live"));
+    h.run(1500);
+    h.report("Jitter 200 ms");
+
+    TEST_ASSERT_GREATER_THAN(10, h.jitter.jitterMs());
+    TEST_ASSERT_GREATER_OR_EQUAL(JITTER_PREFILL_MS, h.jitter.targetMs());
+    TEST_ASSERT_EQUAL_UINT32(1, h.opens);
+    TEST_ASSERT_EQUAL_UINT32(0, h.corrupt);
+}
+
+// Stall kürzer als das Timeout: keine neue Verbindung, aber die Lücke vertieft den Puffer
+static void test_short_stall_deepens_buffer() {
+    StreamFaultConfig f = IcyServer::noFaults();
+    f.bandwidth_kbps = 256;
+    f.stall_every_s = 2;
+    f.stall_ms = 1200;
+    server->route("/live", faultyStream(f));
+    StreamHarness h(server->url("/live"));
+    h.reader.setStallTimeout(2000);
+    h.run(3400);
+    h.report("Stall 1,2 s unter dem Timeout");
+
+    TEST_ASSERT_EQUAL_UINT32(1, h.opens);
+    TEST_ASSERT_EQUAL_UINT32(0, h.losses);
+    // Zieltiefe etwa 2 x Lücke (der Spitzenwert klingt pro Sekunde um 1/64 ab)
+    TEST_ASSERT_GREATER_THAN(JITTER_PREFILL_MS, h.jitter.targetMs());
+    TEST_ASSERT_GREATER_OR_EQUAL(2 * f.stall_ms * 9 / 10, h.jitter.targetMs());
+    TEST_ASSERT_EQUAL_UINT32(0, h.jitter.underruns());
+}
+
+// Stall länger als das Timeout: Verbindung gilt als tot und wird neu aufgebaut
+static void test_long_stall_reconnects() {
+    StreamFaultConfig f = IcyServer::noFaults();
+    f.bandwidth_kbps = 256;
+    f.stall_every_s = 1;
+    f.stall_ms = 5000;
+    server->route("/live", faultyStream(f));
+    StreamHarness h(server->url("/live"));
+    h.reader.setStallTimeout(500);
+    h.run(2500);
+    h.report("Stall 5 s über dem Timeout");
+
+    TEST_ASSERT_GREATER_OR_EQUAL(1, h.losses);
+    TEST_ASSERT_EQUAL_UINT32(h.losses + 1, h.opens);
+    TEST_ASSERT_EQUAL_UINT32(0, h.failed_opens);
+    TEST_ASSERT_EQUAL_UINT32(0, h.corrupt);
+}
+
+// Server kappt jede Sekunde: Neuaufbau nach der Basis-Wartezeit, der Puffer überbrückt die Lücken
+static void test_disconnects_are_bridged_by_the_buffer() {
+    StreamFaultConfig f = IcyServer::noFaults();
+    f.bandwidth_kbps = 384;
+    f.disconnect_every_s = 1;
+    server->route("/live", faultyStream(f));
+    StreamHarness h(server->url("/live"));
+    h.run(3500);
+    h.report("Abbruch jede Sekunde");
+
+    TEST_ASSERT_GREATER_OR_EQUAL(2, h.losses);
+    TEST_ASSERT_EQUAL(h.losses, h.reconnect_ms.size());
+    TEST_ASSERT_EQUAL_UINT32(h.losses, h.reconnect.reconnects());
+    for (uint32_t ms : h.reconnect_ms) {
+        TEST_ASSERT_GREATER_OR_EQUAL(RECONNECT_BASE_MS / 2, ms);
+        TEST_ASSERT_LESS_OR_EQUAL(RECONNECT_BASE_MS + 100, ms);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, h.reconnect.failures());
+    TEST_ASSERT_EQUAL_UINT32(0, h.jitter.underruns());
+    TEST_ASSERT_EQUAL_UINT32(0, h.corrupt);
+    TEST_ASSERT_EQUAL_UINT32(server->connections(), h.opens);
+}
+
+// Kaputtes Location und Weiterleitungsschleife: jeder Versuch scheitert, der Backoff wächst;
+// ist der Sender wieder erreichbar, läuft der Stream und die Fehler sind vergessen
+static void test_redirect_faults_back_off_then_recover() {
+    IcyServer::Route a, b, bad;
+    a.head = "HTTP/1.1 302 Found\r\nLocation: /b\r\n";
+    b.head = "HTTP/1.1 302 Found\r\nLocation: " + server->url("/a") + "\r\n";
+    bad.head = "HTTP/1.1 301 Moved\r\nLocation: ftp://[broken\r\n";
+    server->route("/a", a);
+    server->route("/b", b);
+    server->route("/bad", bad);
+
+    StreamHarness h(server->url("/bad"));
+    h.run(100);
+    TEST_ASSERT_EQUAL_UINT32(1, h.failed_opens);
+    TEST_ASSERT_EQUAL_UINT32(1, server->connections());
+    TEST_ASSERT_EQUAL_UINT16(1, h.reconnect.failures());
+
+    // Schleife: STATION_MAX_REDIRECTS Weiterleitungen, dann aufgeben
+    h.setUrl(server->url("/a"));
+    h.run(h.reconnect.remainingMs(h.net.millis()) + 50);
+    TEST_ASSERT_EQUAL_UINT32(2, h.failed_opens);
+    TEST_ASSERT_EQUAL_UINT32(1 + STATION_MAX_REDIRECTS + 1, server->connections());
+    TEST_ASSERT_EQUAL_UINT16(2, h.reconnect.failures());
+    TEST_ASSERT_GREATER_OR_EQUAL(RECONNECT_BASE_MS, h.reconnect.backoffMs());
+    TEST_ASSERT_EQUAL_UINT32(0, h.opens);
+
+    server->route("/a", faultyStream(IcyServer::noFaults()));
+    h.run(h.reconnect.remainingMs(h.net.millis()) + 100);
+    h.report("Weiterleitungsfehler, dann erreichbar");
+    TEST_ASSERT_EQUAL_UINT32(1, h.opens);
+    TEST_ASSERT_EQUAL(ReconnectPolicy::RC_CONNECTED, h.reconnect.state());
+    TEST_ASSERT_EQUAL_UINT16(0, h.reconnect.failures());
+    TEST_ASSERT_EQUAL_UINT32(1, h.reconnect.reconnects());
+    TEST_ASSERT_GREATER_THAN(0, h.played);
+    TEST_ASSERT_EQUAL_UINT32(0, h.corrupt);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fast_link_prefills_and_plays);
+    RUN_TEST(test_slow_link_rebuffers_without_reconnect);
+    RUN_TEST(test_jitter_is_measured);
+    RUN_TEST(test_short_stall_deepens_buffer);
+    RUN_TEST(test_long_stall_reconnects);
+    RUN_TEST(test_disconnects_are_bridged_by_the_buffer);
+    RUN_TEST(test_redirect_faults_back_off_then_recover);
+    return UNITY_END();
+}
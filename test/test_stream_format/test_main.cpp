@@ -0,0 +1,135 @@
+// Codec- und Playlist-Erkennung, M3U- und PLS-Einträge; die Playlists liegen in Puffern genau
+// ihrer Länge ohne '\0' wie im HTTP-Puffer (mit -fsanitize=address fällt jedes Überlesen auf)
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "stream_format.h"
+
+void setUp() {}
+void tearDown() {}
+
+struct Playlist {
+    std::vector<char> buf;
+    std::vector<PlaylistEntry> entries;
+    PlaylistFormat format;
+};
+
+static Playlist readAll(const std::string& text) {
+    Playlist p;
+    p.buf.assign(text.begin(), text.end());
+    PlaylistReader reader(p.buf.data(), p.buf.size());
+    p.format = reader.format();
+    PlaylistEntry e;
+    while (reader.next(e)) p.entries.push_back(e);
+    return p;
+}
+
+static void test_codec_and_playlist_detection() {
+    TEST_ASSERT_EQUAL(CODEC_AAC, stream_codec("audio/aacp; charset=utf-8", "http://a/x.mp3"));
+    TEST_ASSERT_EQUAL(CODEC_MP3, stream_codec("audio/mpeg", "http://a/x.aac"));
+    TEST_ASSERT_EQUAL(CODEC_AAC, stream_codec("", "http://a/x.AAC?sid=1"));
+    TEST_ASSERT_EQUAL(CODEC_MP3, stream_codec(nullptr, "http://a/live"));
+    TEST_ASSERT_EQUAL(PLAYLIST_PLS, playlist_format("http://a/x", "audio/x-scpls"));
+    TEST_ASSERT_EQUAL(PLAYLIST_M3U, playlist_format("http://a/x.m3u8#t", ""));
+    // Audio-Content-Type hat Vorrang vor der Endung
+    TEST_ASSERT_EQUAL(PLAYLIST_NONE, playlist_format("http://a/x.m3u", "audio/mpeg"));
+}
+
+static void test_m3u_titles_and_buttons() {
+    Playlist p = readAll("\xEF\xBB\xBF#EXTM3U\r\n"
+                         "#EXTINF:-1 button=\"2\" logo=\"a,b\",Radio Eins\r\n"
+                         "http://one.example/live\r\n"
+                         "\r\n"
+                         "#EXTINF:-1,Ohne Taste\n"
+                         "kein-url\n"
+                         "https://two.example/aac\n"
+                         "#EXTINF:-1 button=\"300\",Zu groß\n"
+                         "  http://three.example/  \n");
+    TEST_ASSERT_EQUAL(PLAYLIST_M3U, p.format);
+    TEST_ASSERT_EQUAL(3, p.entries.size());
+    TEST_ASSERT_EQUAL_STRING("Radio Eins", p.entries[0].title);
+    TEST_ASSERT_EQUAL_UINT8(2, p.entries[0].button);
+    TEST_ASSERT_EQUAL_STRING("http://one.example/live", p.entries[0].url);
+    // Die ungültige Zeile nimmt Titel und Taste aus ihrem #EXTINF mit
+    TEST_ASSERT_EQUAL_STRING("", p.entries[1].title);
+    TEST_ASSERT_EQUAL_STRING("https://two.example/aac", p.entries[1].url);
+    // Tastennummern über 255 gelten als keine Taste
+    TEST_ASSERT_EQUAL_UINT8(0, p.entries[2].button);
+    TEST_ASSERT_EQUAL_STRING("http://three.example/", p.entries[2].url);
+}
+
+static void test_m3u_skips_hls_and_long_urls() {
+    TEST_ASSERT_EQUAL(0, readAll("#EXTM3U\n#EXT-X-TARGETDURATION:6\nhttp://a/seg1.ts\n").entries.size());
+    std::string lng = "http://a/" + std::string(PLAYLIST_URL_MAX, 'x');
+    Playlist p = readAll(lng + "\nhttp://b/ok\n");
+    TEST_ASSERT_EQUAL(1, p.entries.size());
+    TEST_ASSERT_EQUAL_STRING("http://b/ok", p.entries[0].url);
+}
+
+// Der Puffer endet mitten in der Tastennummer, ohne Komma und ohne URL danach
+static void test_m3u_buffer_ends_in_digits() {
+    Playlist p = readAll("#EXTINF:-1 button=\"12");
+    TEST_ASSERT_EQUAL(0, p.entries.size());
+    p = readAll("#EXTINF:-1 button=\"");
+    TEST_ASSERT_EQUAL(0, p.entries.size());
+}
+
+// TitleN darf vor oder hinter FileN stehen; Einträge ohne Nummer oder '=' zählen nicht
+static void test_pls_entries_and_titles() {
+    Playlist p = readAll("[playlist]\r\n"
+                         "Title2=Zweiter\r\n"
+                         "File1=http://one.example/live\r\n"
+                         "Title1=Erster\r\n"
+                         "File2=http://two.example/live\r\n"
+                         "File=http://none.example/\r\n"
+                         "File3 http://none.example/\r\n"
+                         "File4=kein-url\r\n"
+                         "file12=http://twelve.example/\r\n"
+                         "Title1x=falsch\r\n"
+                         "NumberOfEntries=3\r\n");
+    TEST_ASSERT_EQUAL(PLAYLIST_PLS, p.format);
+    TEST_ASSERT_EQUAL(3, p.entries.size());
+    TEST_ASSERT_EQUAL_STRING("http://one.example/live", p.entries[0].url);
+    TEST_ASSERT_EQUAL_STRING("Erster", p.entries[0].title);
+    TEST_ASSERT_EQUAL_STRING("Zweiter", p.entries[1].title);
+    TEST_ASSERT_EQUAL_STRING("http://twelve.example/", p.entries[2].url);
+    // "Title1" passt nicht zu File12
+    TEST_ASSERT_EQUAL_STRING("", p.entries[2].title);
+}
+
+// Der Puffer endet mitten in einer Nummer: in "File" und beim Suchen des Titels in "Title"
+static void test_pls_buffer_ends_in_digits() {
+    Playlist p = readAll("[playlist]\nFile1=http://a/live\nTitle1=A\nFile23");
+    TEST_ASSERT_EQUAL(1, p.entries.size());
+    TEST_ASSERT_EQUAL_STRING("A", p.entries[0].title);
+
+    p = readAll("[playlist]\nFile12=http://a/live\nTitle1");
+    TEST_ASSERT_EQUAL(1, p.entries.size());
+    TEST_ASSERT_EQUAL_STRING("", p.entries[0].title);
+
+    p = readAll("[playlist]\nFile7=http://a/live\nTitle");
+    TEST_ASSERT_EQUAL(1, p.entries.size());
+    TEST_ASSERT_EQUAL_STRING("", p.entries[0].title);
+}
+
+// Überlange Nummern laufen nicht über, die Einträge bleiben lesbar
+static void test_pls_huge_index() {
+    Playlist p = readAll("[playlist]\nFile99999999999999999999=http://a/live\nTitle5=B\n");
+    TEST_ASSERT_EQUAL(1, p.entries.size());
+    TEST_ASSERT_EQUAL_STRING("http://a/live", p.entries[0].url);
+    TEST_ASSERT_EQUAL_STRING("", p.entries[0].title);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_codec_and_playlist_detection);
+    RUN_TEST(test_m3u_titles_and_buttons);
+    RUN_TEST(test_m3u_skips_hls_and_long_urls);
+    RUN_TEST(test_m3u_buffer_ends_in_digits);
+    RUN_TEST(test_pls_entries_and_titles);
+    RUN_TEST(test_pls_buffer_ends_in_digits);
+    RUN_TEST(test_pls_huge_index);
+    return UNITY_END();
+}
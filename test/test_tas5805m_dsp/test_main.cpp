@@ -0,0 +1,201 @@
+// TAS5805M-Übersetzung gegen eine Register-Map: Adressen, Byte-Folgen, Book/Page-Wechsel
+#include <unity.h>
+#include <map>
+#include <vector>
+
+#include "tas5805m_dsp.h"
+
+// Register-Map des Verstärkers mit Book/Page-Logik und Protokoll aller Zugriffe
+class RegisterMap : public TasRegisterBus {
+public:
+    struct Write {
+        uint8_t book, page, reg;
+        std::vector<uint8_t> data;
+    };
+
+    uint8_t book = 0, page = 0;
+    std::map<uint32_t, uint8_t> mem;
+    std::vector<Write> log;
+    int fail_after = -1;  // ab diesem Zugriff liefert der Bus einen Fehler
+
+    static uint32_t key(uint8_t book, uint8_t page, uint8_t reg) { return (book << 16) | (page << 8) | reg; }
+
+    bool write(uint8_t reg, const uint8_t* data, uint8_t len) override {
+        if (fail_after >= 0 && (int)log.size() >= fail_after) return false;
+        log.push_back({ book, page, reg, std::vector<uint8_t>(data, data + len) });
+        if (reg == TAS5805M_REG_PAGE) {
+            page = data[0];
+        } else if (reg == TAS5805M_REG_BOOK && page == 0) {
+            book = data[0];
+        } else {
+            for (uint8_t i = 0; i < len; i++) mem[key(book, page, reg + i)] = data[i];
+        }
+        return true;
+    }
+
+    bool read(uint8_t reg, uint8_t* data, uint8_t len) override {
+        for (uint8_t i = 0; i < len; i++) data[i] = mem[key(book, page, reg + i)];
+        return true;
+    }
+
+    uint32_t word(uint8_t b, uint8_t p, uint8_t r) {
+        return ((uint32_t)mem[key(b, p, r)] << 24) | (mem[key(b, p, r + 1)] << 16) |
+               (mem[key(b, p, r + 2)] << 8) | mem[key(b, p, r + 3)];
+    }
+};
+
+static const BiquadCoefficients k = { 1.0f, -0.5f, 0.25f, -1.5f, 0.75f };
+
+void setUp() {}
+void tearDown() {}
+
+static void test_fixed_527_format() {
+    TEST_ASSERT_EQUAL_HEX32(0x08000000, Tas5805mDsp::toFixed527(1.0f));
+    TEST_ASSERT_EQUAL_HEX32(0xFC000000, (uint32_t)Tas5805mDsp::toFixed527(-0.5f));
+    TEST_ASSERT_EQUAL_HEX32(0x00000001, Tas5805mDsp::toFixed527(1.0f / (1 << 27)));
+    TEST_ASSERT_EQUAL_HEX32(0x7FFFFFFF, Tas5805mDsp::toFixed527(16.0f));
+    TEST_ASSERT_EQUAL_HEX32(0x80000000, (uint32_t)Tas5805mDsp::toFixed527(-16.0f));
+}
+
+// Genaue Folge für das erste Biquad links: Page 0, Book 0xAA, Page 0x24, dann 5 Worte Big-Endian
+static void test_first_biquad_byte_sequence() {
+    RegisterMap map;
+    Tas5805mDsp dsp(map);
+    TEST_ASSERT_TRUE(dsp.writeBiquad(0, 0, k));
+
+    const std::vector<std::vector<uint8_t>> expected_data = {
+        { 0x00 }, { 0xAA }, { 0x24 },
+        { 0x08, 0x00, 0x00, 0x00 },  // b0 = 1.0
+        { 0xFC, 0x00, 0x00, 0x00 },  // b1 = -0.5
+        { 0x02, 0x00, 0x00, 0x00 },  // b2 = 0.25
+        { 0x0C, 0x00, 0x00, 0x00 },  // -a1 = 1.5
+        { 0xFA, 0x00, 0x00, 0x00 },  // -a2 = -0.75
+    };
+    const uint8_t expected_reg[] = { 0x00, 0x7F, 0x00, 0x18, 0x1C, 0x20, 0x24, 0x28 };
+
+    TEST_ASSERT_EQUAL(8, map.log.size());
+    for (size_t i = 0; i < map.log.size(); i++) {
+        TEST_ASSERT_EQUAL_HEX8(expected_reg[i], map.log[i].reg);
+        TEST_ASSERT_EQUAL(expected_data[i].size(), map.log[i].data.size());
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected_data[i].data(), map.log[i].data.data(), expected_data[i].size());
+    }
+    TEST_ASSERT_EQUAL_HEX8(0xAA, map.book);
+    TEST_ASSERT_EQUAL_HEX8(0x24, map.page);
+}
+
+static void test_coefficient_addresses() {
+    uint8_t page, reg;
+    Tas5805mDsp::coefficientAddress(0, 0, 0, page, reg);
+    TEST_ASSERT_EQUAL_HEX8(0x24, page); TEST_ASSERT_EQUAL_HEX8(0x18, reg);
+    // BQ6 links: b0 am Ende von Page 0x24, b1 am Anfang von Page 0x25
+    Tas5805mDsp::coefficientAddress(0, 5, 0, page, reg);
+    TEST_ASSERT_EQUAL_HEX8(0x24, page); TEST_ASSERT_EQUAL_HEX8(0x7C, reg);
+    Tas5805mDsp::coefficientAddress(0, 5, 1, page, reg);
+    TEST_ASSERT_EQUAL_HEX8(0x25, page); TEST_ASSERT_EQUAL_HEX8(0x08, reg);
+    // Letztes Wort links und erstes Wort rechts
+    Tas5805mDsp::coefficientAddress(0, 14, 4, page, reg);
+    TEST_ASSERT_EQUAL_HEX8(0x26, page); TEST_ASSERT_EQUAL_HEX8(0x50, reg);
+    Tas5805mDsp::coefficientAddress(1, 0, 0, page, reg);
+    TEST_ASSERT_EQUAL_HEX8(0x26, page); TEST_ASSERT_EQUAL_HEX8(0x64, reg);
+    Tas5805mDsp::coefficientAddress(1, 14, 4, page, reg);
+    TEST_ASSERT_EQUAL_HEX8(0x29, page); TEST_ASSERT_EQUAL_HEX8(0x24, reg);
+}
+
+// Alle 150 Worte landen in Nutzdaten-Registern, ohne sich zu überlappen, mit den richtigen Werten
+static void test_all_biquads_fill_distinct_words() {
+    RegisterMap map;
+    Tas5805mDsp dsp(map);
+    for (uint8_t ch = 0; ch < 2; ch++) {
+        for (uint8_t i = 0; i < TAS5805M_BQ_PER_CHANNEL; i++) TEST_ASSERT_TRUE(dsp.writeBiquad(ch, i, k));
+    }
+
+    std::map<uint32_t, int> seen;
+    for (const RegisterMap::Write& w : map.log) {
+        if (w.reg == TAS5805M_REG_PAGE || (w.reg == TAS5805M_REG_BOOK && w.page == 0)) continue;
+        TEST_ASSERT_EQUAL_HEX8(0xAA, w.book);
+        TEST_ASSERT_EQUAL(4, w.data.size());
+        TEST_ASSERT_GREATER_OR_EQUAL(TAS5805M_PAGE_DATA_START, w.reg);
+        TEST_ASSERT_LESS_OR_EQUAL(0x7C, w.reg);
+        seen[RegisterMap::key(w.book, w.page, w.reg)]++;
+    }
+    TEST_ASSERT_EQUAL(2 * TAS5805M_BQ_PER_CHANNEL * 5, seen.size());
+    for (auto& s : seen) TEST_ASSERT_EQUAL(1, s.second);
+
+    uint8_t page, reg;
+    Tas5805mDsp::coefficientAddress(1, 7, 3, page, reg);
+    TEST_ASSERT_EQUAL_HEX32(0x0C000000, map.word(0xAA, page, reg));
+    // Book wurde nur einmal gewählt, danach nur noch Page-Wechsel
+    int book_writes = 0;
+    for (const RegisterMap::Write& w : map.log) book_writes += w.reg == TAS5805M_REG_BOOK && w.page == 0;
+    TEST_ASSERT_EQUAL(1, book_writes);
+}
+
+// Nach der Sequenz zurück auf Book 0 / Page 0: erst Page 0, dann Book 0
+static void test_restore_default_page() {
+    RegisterMap map;
+    Tas5805mDsp dsp(map);
+    dsp.writeBiquad(1, 3, k);
+    size_t before = map.log.size();
+    TEST_ASSERT_TRUE(dsp.restoreDefaultPage());
+
+    TEST_ASSERT_EQUAL(before + 2, map.log.size());
+    TEST_ASSERT_EQUAL_HEX8(TAS5805M_REG_PAGE, map.log[before].reg);
+    TEST_ASSERT_EQUAL_HEX8(0x00, map.log[before].data[0]);
+    TEST_ASSERT_EQUAL_HEX8(TAS5805M_REG_BOOK, map.log[before + 1].reg);
+    TEST_ASSERT_EQUAL_HEX8(0x00, map.log[before + 1].data[0]);
+    TEST_ASSERT_EQUAL_HEX8(0, map.book);
+    TEST_ASSERT_EQUAL_HEX8(0, map.page);
+}
+
+static void test_eq_enable_toggles_bypass_bit() {
+    RegisterMap map;
+    map.mem[RegisterMap::key(0, 0, TAS5805M_REG_DSP_MISC)] = 0x08 | TAS5805M_DSP_MISC_BYPASS_EQ;
+    Tas5805mDsp dsp(map);
+    TEST_ASSERT_TRUE(dsp.setEqEnabled(true));
+    TEST_ASSERT_EQUAL_HEX8(0x08, map.mem[RegisterMap::key(0, 0, TAS5805M_REG_DSP_MISC)]);
+    TEST_ASSERT_TRUE(dsp.setEqEnabled(false));
+    TEST_ASSERT_EQUAL_HEX8(0x09, map.mem[RegisterMap::key(0, 0, TAS5805M_REG_DSP_MISC)]);
+}
+
+static void test_invalid_biquad_and_bus_errors() {
+    RegisterMap map;
+    Tas5805mDsp dsp(map);
+    TEST_ASSERT_FALSE(dsp.writeBiquad(2, 0, k));
+    TEST_ASSERT_FALSE(dsp.writeBiquad(0, TAS5805M_BQ_PER_CHANNEL, k));
+    TEST_ASSERT_EQUAL(0, map.log.size());
+
+    map.fail_after = 4;
+    TEST_ASSERT_FALSE(dsp.writeBiquad(0, 0, k));
+}
+
+// 0x00 = +24 dB, 0x30 = 0 dB, 0,5 dB pro Schritt, 0xFF = stumm
+static void test_volume_register_mapping() {
+    TEST_ASSERT_EQUAL_HEX8(0x00, Tas5805mVolumeSink::registerValue(24.0f, false));
+    TEST_ASSERT_EQUAL_HEX8(0x00, Tas5805mVolumeSink::registerValue(30.0f, false));
+    TEST_ASSERT_EQUAL_HEX8(0x30, Tas5805mVolumeSink::registerValue(0.0f, false));
+    TEST_ASSERT_EQUAL_HEX8(0x44, Tas5805mVolumeSink::registerValue(-10.0f, false));
+    TEST_ASSERT_EQUAL_HEX8(0xFE, Tas5805mVolumeSink::registerValue(-200.0f, false));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, Tas5805mVolumeSink::registerValue(0.0f, true));
+    TEST_ASSERT_EQUAL_FLOAT(24.0f, Tas5805mVolumeSink::toDb(0x00));
+    TEST_ASSERT_EQUAL_FLOAT(-10.0f, Tas5805mVolumeSink::toDb(0x44));
+
+    RegisterMap map;
+    Tas5805mVolumeSink sink(map);
+    TEST_ASSERT_TRUE(sink.write(sink.code(-3.0f, false)));
+    TEST_ASSERT_EQUAL(1, map.log.size());
+    TEST_ASSERT_EQUAL_HEX8(TAS5805M_REG_DIG_VOL, map.log[0].reg);
+    TEST_ASSERT_EQUAL_HEX8(0x36, map.log[0].data[0]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_527_format);
+    RUN_TEST(test_first_biquad_byte_sequence);
+    RUN_TEST(test_coefficient_addresses);
+    RUN_TEST(test_all_biquads_fill_distinct_words);
+    RUN_TEST(test_restore_default_page);
+    RUN_TEST(test_eq_enable_toggles_bypass_bit);
+    RUN_TEST(test_invalid_biquad_and_bus_errors);
+    RUN_TEST(test_volume_register_mapping);
+    return UNITY_END();
+}
@@ -0,0 +1,167 @@
+// Telemetrie: Fächer des Decoder-Histogramms, Rücksetzen der Intervall-Werte nach telemetry_poll()
+// und der Aufbau der CSV-Zeilen, wie tools/telemetry_csv.py sie erwartet (über mock::serial)
+#include <unity.h>
+#include <string>
+#include <vector>
+
+#include "telemetry.h"
+
+#ifndef TELEMETRY_CSV
+#error "test_telemetry braucht -D TELEMETRY_CSV (siehe [env:native])"
+#endif
+
+static std::vector<std::string> header;
+
+static std::vector<std::string> split(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (;;) {
+        size_t comma = line.find(',', start);
+        fields.push_back(line.substr(start, comma - start));
+        if (comma == std::string::npos) return fields;
+        start = comma + 1;
+    }
+}
+
+// Ein Intervall weiter, telemetry_poll() aufrufen und die Datenzeile ohne "T," liefern;
+// die Kopfzeile (nur beim ersten Mal) landet in 'header'
+static std::vector<std::string> report() {
+    mock::advance_ms(TELEMETRY_INTERVAL_MS);
+    mock::serial.clear();
+    telemetry_poll();
+    std::vector<std::string> row;
+    size_t pos = 0;
+    while (pos < mock::serial.size()) {
+        size_t end = mock::serial.find('\n', pos);
+        std::string line = mock::serial.substr(pos, end - pos);
+        pos = end == std::string::npos ? mock::serial.size() : end + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        TEST_ASSERT_TRUE_MESSAGE(line.rfind("T,", 0) == 0, line.c_str());
+        std::vector<std::string> fields = split(line.substr(2));
+        if (fields[0] == "ms") header = fields;
+        else row = fields;
+    }
+    return row;
+}
+
+static uint32_t column(const std::vector<std::string>& row, const char* name) {
+    for (size_t i = 0; i < header.size(); i++) {
+        if (header[i] == name) return (uint32_t)strtoul(row.at(i).c_str(), nullptr, 10);
+    }
+    TEST_FAIL_MESSAGE(name);
+    return 0;
+}
+
+static uint32_t bucket(const std::vector<std::string>& row, uint8_t i) {
+    char name[8];
+    snprintf(name, sizeof(name), "hist%u", i);
+    return column(row, name);
+}
+
+void setUp() {
+    mock::cpu_mhz = 240;
+    // Vorherige Intervall-Werte abholen; beim ersten Mal kommt dabei die Kopfzeile
+    report();
+}
+
+void tearDown() {}
+
+// Kopf und Zeile haben gleich viele Felder, alle Werte sind Zahlen; die Spalten, die
+// telemetry_csv.py kennt (ms vorne, die Summenzähler), sind da
+static void test_csv_layout_matches_tool() {
+    std::vector<std::string> row = report();
+    TEST_ASSERT_EQUAL(header.size(), row.size());
+    TEST_ASSERT_EQUAL_STRING("ms", header[0].c_str());
+    const char* expected[] = { "underruns", "reconnects", "a2dp_gaps", "decode_avg_us", "heap_min" };
+    for (const char* name : expected) column(row, name);
+    for (const std::string& v : row) {
+        TEST_ASSERT_TRUE_MESSAGE(!v.empty() && v.find_first_not_of("0123456789") == std::string::npos, v.c_str());
+    }
+    TEST_ASSERT_EQUAL_UINT32(millis(), column(row, "ms"));
+    // Die Kopfzeile kommt nur einmal
+    report();
+    TEST_ASSERT_EQUAL(std::string::npos, mock::serial.find("T,ms"));
+}
+
+// Fach 0 < 250 us, jedes weitere doppelt so breit, das letzte nach oben offen
+static void test_histogram_bucket_edges() {
+    const uint32_t us[] = { 0, 249, 250, 499, 500, 999, 1000, 7999, 8000, 15999, 16000, 1000000 };
+    const uint8_t expect[] = { 0, 0, 1, 1, 2, 2, 3, 5, 6, 6, 7, 7 };
+    uint32_t counts[TELEMETRY_DECODE_BUCKETS] = {};
+    for (size_t i = 0; i < sizeof(us) / sizeof(us[0]); i++) {
+        telemetry_decode(us[i] * 240);
+        counts[expect[i]]++;
+    }
+    std::vector<std::string> row = report();
+    for (uint8_t i = 0; i < TELEMETRY_DECODE_BUCKETS; i++) TEST_ASSERT_EQUAL_UINT32(counts[i], bucket(row, i));
+    TEST_ASSERT_EQUAL_UINT32(12, column(row, "decode_calls"));
+    TEST_ASSERT_EQUAL_UINT32(1000000, column(row, "decode_max_us"));
+}
+
+// Die Zeit in us hängt vom aktuellen CPU-Takt ab (Zyklen / MHz)
+static void test_histogram_follows_cpu_clock() {
+    mock::cpu_mhz = 80;
+    telemetry_decode(250 * 80);
+    telemetry_decode(249 * 80);
+    std::vector<std::string> row = report();
+    TEST_ASSERT_EQUAL_UINT32(1, bucket(row, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, bucket(row, 1));
+    TEST_ASSERT_EQUAL_UINT32(250, column(row, "decode_max_us"));
+}
+
+// Intervall-Werte beginnen nach jeder Zeile neu, Summenzähler laufen weiter
+static void test_interval_reset_after_poll() {
+    telemetry_decode(300 * 240);
+    telemetry_decode(100 * 240);
+    telemetry_stream(80, 2);
+    telemetry_stream(35, 2);
+    telemetry_stream(60, 3);
+    telemetry_underrun();
+    std::vector<std::string> row = report();
+    TEST_ASSERT_EQUAL_UINT32(2, column(row, "decode_calls"));
+    TEST_ASSERT_EQUAL_UINT32(200, column(row, "decode_avg_us"));
+    TEST_ASSERT_EQUAL_UINT32(300, column(row, "decode_max_us"));
+    TEST_ASSERT_EQUAL_UINT32(60, column(row, "fill_pct"));
+    TEST_ASSERT_EQUAL_UINT32(35, column(row, "fill_min_pct"));
+    TEST_ASSERT_EQUAL_UINT32(3, column(row, "reconnects"));
+    uint32_t underruns = column(row, "underruns");
+
+    telemetry_stream(70, 3);
+    row = report();
+    TEST_ASSERT_EQUAL_UINT32(0, column(row, "decode_calls"));
+    TEST_ASSERT_EQUAL_UINT32(0, column(row, "decode_avg_us"));
+    TEST_ASSERT_EQUAL_UINT32(0, column(row, "decode_max_us"));
+    for (uint8_t i = 0; i < TELEMETRY_DECODE_BUCKETS; i++) TEST_ASSERT_EQUAL_UINT32(0, bucket(row, i));
+    TEST_ASSERT_EQUAL_UINT32(70, column(row, "fill_min_pct"));
+    TEST_ASSERT_EQUAL_UINT32(underruns, column(row, "underruns"));
+}
+
+// A2DP: Lücken ab TELEMETRY_A2DP_GAP_MS zählen, die längste je Intervall
+static void test_a2dp_gaps() {
+    uint32_t gaps = column(report(), "a2dp_gaps");
+    for (int i = 0; i < 10; i++) {
+        telemetry_a2dp_packet();
+        mock::advance_ms(3);
+    }
+    mock::advance_ms(TELEMETRY_A2DP_GAP_MS - 3 - 1);
+    telemetry_a2dp_packet();
+    mock::advance_ms(TELEMETRY_A2DP_GAP_MS + 10);
+    telemetry_a2dp_packet();
+    std::vector<std::string> row = report();
+    TEST_ASSERT_EQUAL_UINT32(12, column(row, "a2dp_packets"));
+    TEST_ASSERT_EQUAL_UINT32(gaps + 1, column(row, "a2dp_gaps"));
+    TEST_ASSERT_EQUAL_UINT32(TELEMETRY_A2DP_GAP_MS + 10, column(row, "a2dp_max_gap_ms"));
+    row = report();
+    TEST_ASSERT_EQUAL_UINT32(0, column(row, "a2dp_packets"));
+    TEST_ASSERT_EQUAL_UINT32(0, column(row, "a2dp_max_gap_ms"));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_csv_layout_matches_tool);
+    RUN_TEST(test_histogram_bucket_edges);
+    RUN_TEST(test_histogram_follows_cpu_clock);
+    RUN_TEST(test_interval_reset_after_poll);
+    RUN_TEST(test_a2dp_gaps);
+    return UNITY_END();
+}
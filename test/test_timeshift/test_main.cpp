@@ -0,0 +1,302 @@
+// Zeitversetztes Hören: Frame-Index für MP3 und AAC (ADTS), Sprünge auf Frame-Anfänge,
+// Wiederaufsetzen nach Störungen und Überlauf von Ring und Index
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "timeshift.h"
+
+// MPEG 1 Layer III, 128 kbps, 44,1 kHz: 417 Bytes, 1152 Samples
+#define MP3_LEN 417
+// Frame-Dauern in us, wie TimeshiftHistory sie aufsummiert (Einträge runden auf ganze ms)
+#define MP3_US (1152ull * 1000000 / 44100)
+#define AAC_US (1024ull * 1000000 / 44100)
+
+void setUp() {}
+void tearDown() {}
+
+// Frame-Inhalt: die Nummer des Frames (ohne 0xFF, damit der Inhalt keinen Sync enthält)
+static void appendMp3(std::vector<uint8_t>& out, uint32_t frame) {
+    size_t p = out.size();
+    out.resize(p + MP3_LEN, (uint8_t)(frame & 0x7F));
+    out[p] = 0xFF; out[p + 1] = 0xFB; out[p + 2] = 0x90; out[p + 3] = 0x00;
+}
+
+// ADTS ohne CRC, AAC-LC, Stereo; sr_index 4 = 44,1 kHz; blocks Raw-Blöcke zu 1024 Samples
+static void appendAdts(std::vector<uint8_t>& out, uint32_t frame, uint16_t len,
+                       uint8_t blocks = 1, uint8_t sr_index = 4) {
+    size_t p = out.size();
+    out.resize(p + len, (uint8_t)(frame & 0x7F));
+    out[p] = 0xFF;
+    out[p + 1] = 0xF1;
+    out[p + 2] = (uint8_t)(0x40 | (sr_index << 2));
+    out[p + 3] = (uint8_t)(0x80 | ((len >> 11) & 0x03));
+    out[p + 4] = (uint8_t)(len >> 3);
+    out[p + 5] = (uint8_t)(((len & 0x07) << 5) | 0x1F);
+    out[p + 6] = (uint8_t)(0xFC | (blocks - 1));
+}
+
+// Wie der Audio-Task: in Häppchen anhängen
+static void feed(TimeshiftHistory& ts, const std::vector<uint8_t>& data, uint32_t chunk = 1000) {
+    for (size_t off = 0; off < data.size(); off += chunk) {
+        size_t n = data.size() - off < chunk ? data.size() - off : chunk;
+        ts.append(data.data() + off, (uint32_t)n);
+    }
+}
+
+// Liest am Cursor und liefert die Frame-Nummer, wenn dort ein Frame-Anfang steht, sonst -1
+static int frameAtCursor(TimeshiftHistory& ts, uint8_t header) {
+    uint8_t buf[8];
+    if (ts.read(buf, header + 1) != (uint32_t)header + 1) return -1;
+    uint16_t samples;
+    uint32_t rate;
+    if (!TimeshiftHistory::frameLength(buf, &samples, &rate)) return -1;
+    return buf[header];
+}
+
+static void test_frame_length_headers() {
+    uint16_t samples = 0;
+    uint32_t rate = 0;
+    std::vector<uint8_t> f;
+    appendMp3(f, 0);
+    TEST_ASSERT_EQUAL_UINT16(MP3_LEN, TimeshiftHistory::frameLength(f.data(), &samples, &rate));
+    TEST_ASSERT_EQUAL_UINT16(1152, samples);
+    TEST_ASSERT_EQUAL_UINT32(44100, rate);
+
+    f.clear();
+    appendAdts(f, 0, 371);
+    TEST_ASSERT_EQUAL_UINT16(371, TimeshiftHistory::frameLength(f.data(), &samples, &rate));
+    TEST_ASSERT_EQUAL_UINT16(1024, samples);
+    TEST_ASSERT_EQUAL_UINT32(44100, rate);
+
+    // 13-Bit-Länge über drei Bytes, mehrere Raw-Blöcke, 48 kHz
+    f.clear();
+    appendAdts(f, 0, 6000, 4, 3);
+    TEST_ASSERT_EQUAL_UINT16(6000, TimeshiftHistory::frameLength(f.data(), &samples, &rate));
+    TEST_ASSERT_EQUAL_UINT16(4096, samples);
+    TEST_ASSERT_EQUAL_UINT32(48000, rate);
+
+    // Mit CRC (protection_absent = 0) sind 9 Bytes Header das Minimum
+    f[1] = 0xF0;
+    f[3] = 0x80; f[4] = 0x01; f[5] = 0x1F;  // Länge 8
+    TEST_ASSERT_EQUAL_UINT16(0, TimeshiftHistory::frameLength(f.data(), &samples, &rate));
+}
+
+// Falsche Syncs: reservierte Rate, Länge kürzer als der Header, MPEG 2.5 mit Layer 00
+static void test_frame_length_rejects_false_sync() {
+    uint16_t samples;
+    uint32_t rate;
+    std::vector<uint8_t> f;
+    appendAdts(f, 0, 371, 1, 13);
+    TEST_ASSERT_EQUAL_UINT16(0, TimeshiftHistory::frameLength(f.data(), &samples, &rate));
+    f.clear();
+    appendAdts(f, 0, 371);
+    f[3] = 0x80; f[4] = 0x00; f[5] = 0xDF;  // Länge 6
+    TEST_ASSERT_EQUAL_UINT16(0, TimeshiftHistory::frameLength(f.data(), &samples, &rate));
+    f.clear();
+    appendAdts(f, 0, 371);
+    f[1] = 0xE1;
+    TEST_ASSERT_EQUAL_UINT16(0, TimeshiftHistory::frameLength(f.data(), &samples, &rate));
+}
+
+static void test_indexes_mp3() {
+    static uint8_t mem[64 * 1024];
+    static TimeshiftFrame index[256];
+    std::vector<uint8_t> s;
+    for (uint32_t i = 0; i < 100; i++) appendMp3(s, i);
+    TimeshiftHistory ts;
+    ts.init(mem, sizeof(mem), index, 256);
+    feed(ts, s);
+    TEST_ASSERT_EQUAL_UINT32(100, ts.frames());
+    TEST_ASSERT_EQUAL_UINT32(100 * MP3_US / 1000, ts.lengthMs());
+    TEST_ASSERT_EQUAL_UINT32(0, ts.lost());
+}
+
+// AAC-Frames sind unterschiedlich lang; nur der Header sagt, wo der nächste beginnt
+static void test_indexes_adts_with_varying_lengths() {
+    static uint8_t mem[64 * 1024];
+    static TimeshiftFrame index[256];
+    std::vector<uint8_t> s;
+    for (uint32_t i = 0; i < 120; i++) appendAdts(s, i, (uint16_t)(300 + (i * 37) % 200));
+    TimeshiftHistory ts;
+    ts.init(mem, sizeof(mem), index, 256);
+    feed(ts, s, 333);
+    TEST_ASSERT_EQUAL_UINT32(120, ts.frames());
+    TEST_ASSERT_EQUAL_UINT32(120 * AAC_US / 1000, ts.lengthMs());
+
+    // Ein Raw-Block je Frame: 10 s zurück sind 430 Frames, hier also der älteste
+    TEST_ASSERT_EQUAL_UINT32(ts.lengthMs(), ts.seek(-10000));
+    TEST_ASSERT_EQUAL_INT(0, frameAtCursor(ts, 7));
+}
+
+static void test_adts_multiple_raw_blocks_count_time() {
+    static uint8_t mem[64 * 1024];
+    static TimeshiftFrame index[64];
+    std::vector<uint8_t> s;
+    for (uint32_t i = 0; i < 20; i++) appendAdts(s, i, 1400, 4);
+    TimeshiftHistory ts;
+    ts.init(mem, sizeof(mem), index, 64);
+    feed(ts, s);
+    TEST_ASSERT_EQUAL_UINT32(20, ts.frames());
+    TEST_ASSERT_EQUAL_UINT32(20 * 4 * AAC_US / 1000, ts.lengthMs());
+}
+
+// Sprünge landen auf Frame-Anfängen und werden auf den ältesten Frame bzw. live begrenzt
+static void test_seek_lands_on_frames_and_clamps() {
+    static uint8_t mem[256 * 1024];
+    static TimeshiftFrame index[1024];
+    std::vector<uint8_t> s;
+    for (uint32_t i = 0; i < 500; i++) appendMp3(s, i);  // 13 s
+    TimeshiftHistory ts;
+    ts.init(mem, sizeof(mem), index, 1024);
+    feed(ts, s);
+    ts.goLive();
+    TEST_ASSERT_UINT32_WITHIN(1, MP3_US / 1000, ts.delayMs());
+    TEST_ASSERT_EQUAL_UINT32(MP3_LEN, ts.available());
+
+    uint32_t delay = ts.seek(-5000);
+    TEST_ASSERT_UINT32_WITHIN(MP3_US / 1000 + 1, 5000 + MP3_US / 1000, delay);
+    // 5 s sind 191,4 Frames; der Sprung endet auf dem Frame-Anfang davor
+    int frame = frameAtCursor(ts, 4);
+    TEST_ASSERT_EQUAL_INT((499 - (int)((5000000 + MP3_US - 1) / MP3_US)) & 0x7F, frame);
+
+    // Mitten im Frame: seek(0) springt auf dessen Anfang zurück
+    TEST_ASSERT_EQUAL_UINT32(delay, ts.seek(0));
+    TEST_ASSERT_EQUAL_INT(frame, frameAtCursor(ts, 4));
+
+    TEST_ASSERT_EQUAL_UINT32(ts.lengthMs(), ts.seek(-60000));
+    TEST_ASSERT_EQUAL_UINT32(500u * MP3_LEN, ts.available());
+    TEST_ASSERT_UINT32_WITHIN(1, MP3_US / 1000, ts.seek(60000));
+}
+
+// Müll vor und zwischen den Frames (auch 0xFF-Bytes und ein einzelner gültiger Header)
+static void test_resyncs_after_garbage() {
+    static uint8_t mem[64 * 1024];
+    static TimeshiftFrame index[256];
+    srand(7);
+    std::vector<uint8_t> s;
+    for (int i = 0; i < 500; i++) s.push_back((uint8_t)(rand() % 4 ? rand() : 0xFF));
+    appendAdts(s, 99, 400);  // Header ohne Nachfolger an seinem Ende
+    for (int i = 0; i < 100; i++) s.push_back((uint8_t)rand());
+    for (uint32_t i = 0; i < 30; i++) appendAdts(s, i, 350);
+    for (int i = 0; i < 77; i++) s.push_back(0xFF);
+    for (uint32_t i = 30; i < 60; i++) appendAdts(s, i, 350);
+
+    TimeshiftHistory ts;
+    ts.init(mem, sizeof(mem), index, 256);
+    feed(ts, s, 64);
+    TEST_ASSERT_EQUAL_UINT32(60, ts.frames());
+    TEST_ASSERT_EQUAL_UINT32(60 * AAC_US / 1000, ts.lengthMs());
+    ts.seek(-60000);
+    TEST_ASSERT_EQUAL_INT(0, frameAtCursor(ts, 7));
+}
+
+// Der Ring überschreibt die ältesten Daten; deren Einträge verschwinden aus dem Index
+static void test_wraparound_drops_old_frames() {
+    static uint8_t mem[10 * MP3_LEN + 100];
+    static TimeshiftFrame index[64];
+    std::vector<uint8_t> s;
+    for (uint32_t i = 0; i < 50; i++) appendMp3(s, i);
+    TimeshiftHistory ts;
+    ts.init(mem, sizeof(mem), index, 64);
+    feed(ts, s, 300);
+    TEST_ASSERT_EQUAL_UINT32(10, ts.frames());
+    TEST_ASSERT_UINT32_WITHIN(1, 10 * MP3_US / 1000, ts.lengthMs());
+    ts.seek(-60000);
+    TEST_ASSERT_EQUAL_INT(40, frameAtCursor(ts, 4));
+}
+
+// Index kleiner als der Ring: die ältesten Einträge werden geopfert
+static void test_full_index_drops_oldest_entries() {
+    static uint8_t mem[64 * 1024];
+    static TimeshiftFrame index[8];
+    std::vector<uint8_t> s;
+    for (uint32_t i = 0; i < 30; i++) appendMp3(s, i);
+    TimeshiftHistory ts;
+    ts.init(mem, sizeof(mem), index, 8);
+    feed(ts, s);
+    TEST_ASSERT_EQUAL_UINT32(8, ts.frames());
+    TEST_ASSERT_UINT32_WITHIN(1, 8 * MP3_US / 1000, ts.seek(-60000));
+    TEST_ASSERT_EQUAL_INT(22, frameAtCursor(ts, 4));
+}
+
+// Pause: der Schreiber holt den Cursor ein; er rückt auf den ältesten Frame vor und zählt lost()
+static void test_paused_cursor_overtaken() {
+    static uint8_t mem[10 * MP3_LEN + 100];
+    static TimeshiftFrame index[64];
+    std::vector<uint8_t> s;
+    for (uint32_t i = 0; i < 10; i++) appendMp3(s, i);
+    TimeshiftHistory ts;
+    ts.init(mem, sizeof(mem), index, 64);
+    feed(ts, s);
+    ts.seek(-60000);
+    TEST_ASSERT_EQUAL_UINT32(0, ts.lost());
+
+    s.clear();
+    for (uint32_t i = 10; i < 15; i++) appendMp3(s, i);
+    feed(ts, s);
+    TEST_ASSERT_EQUAL_UINT32(5 * MP3_LEN, ts.lost());
+    TEST_ASSERT_LESS_OR_EQUAL(sizeof(mem), ts.available());
+    TEST_ASSERT_EQUAL_INT(5, frameAtCursor(ts, 4));
+}
+
+// Kennzahlen für die README: 300 s eines 128-kbps-Streams in Speicher, wie radio.cpp ihn anlegt
+// (STREAM_BITRATE_KBPS * 1000 / 8 Bytes und TIMESHIFT_FRAMES_PER_SECOND Einträge je Sekunde),
+// dann zufällige Sprünge mit Zeitmessung je Sprung
+static void test_memory_and_seek_report() {
+    const uint32_t seconds = 300, kbps = 128;
+    const uint32_t bytes = seconds * kbps * 1000 / 8;
+    const uint32_t frames = seconds * TIMESHIFT_FRAMES_PER_SECOND;
+    std::vector<uint8_t> mem(bytes);
+    std::vector<TimeshiftFrame> index(frames);
+    std::vector<uint8_t> s;
+    for (uint32_t i = 0; i < seconds * 1000000ull / MP3_US; i++) appendMp3(s, i);
+    TimeshiftHistory ts;
+    ts.init(mem.data(), bytes, index.data(), frames);
+    feed(ts, s);
+    TEST_ASSERT_UINT32_WITHIN(1000, seconds * 1000, ts.lengthMs());
+
+    char msg[128];
+    uint32_t stream_per_min = bytes / seconds * 60;
+    uint32_t index_per_min = TIMESHIFT_FRAMES_PER_SECOND * 60 * (uint32_t)sizeof(TimeshiftFrame);
+    snprintf(msg, sizeof(msg), "Speicher je Minute: %u B Stream + %u B Index = %u B",
+             stream_per_min, index_per_min, stream_per_min + index_per_min);
+    TEST_MESSAGE(msg);
+
+    const uint32_t n = 100000;
+    std::vector<double> ns(n);
+    uint32_t x = 12345;
+    for (uint32_t i = 0; i < n; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        int32_t delta = (int32_t)(x % (2 * seconds * 1000)) - (int32_t)(seconds * 1000);
+        auto start = std::chrono::steady_clock::now();
+        ts.seek(delta);
+        auto end = std::chrono::steady_clock::now();
+        ns[i] = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        if (i % 1000 == 0) TEST_ASSERT_NOT_EQUAL(-1, frameAtCursor(ts, 4));
+    }
+    std::sort(ns.begin(), ns.end());
+    snprintf(msg, sizeof(msg), "Sprung (Index-Suche): Median %.2f us, 99,9 %% %.2f us",
+             ns[n / 2] / 1000, ns[n - n / 1000] / 1000);
+    TEST_MESSAGE(msg);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_length_headers);
+    RUN_TEST(test_frame_length_rejects_false_sync);
+    RUN_TEST(test_indexes_mp3);
+    RUN_TEST(test_indexes_adts_with_varying_lengths);
+    RUN_TEST(test_adts_multiple_raw_blocks_count_time);
+    RUN_TEST(test_seek_lands_on_frames_and_clamps);
+    RUN_TEST(test_resyncs_after_garbage);
+    RUN_TEST(test_wraparound_drops_old_frames);
+    RUN_TEST(test_full_index_drops_oldest_entries);
+    RUN_TEST(test_paused_cursor_overtaken);
+    RUN_TEST(test_memory_and_seek_report);
+    return UNITY_END();
+}
@@ -0,0 +1,164 @@
+// Lautstärke-Engine: Pegelbereich bis +24 dB, Zusammenfassen der Rasten, Rampe, Ausgabewechsel
+#include <unity.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+#include "volume_engine.h"
+#include "tas5805m_dsp.h"
+
+// Protokolliert die Schreibzugriffe auf das Lautstärke-Register
+class VolumeBus : public TasRegisterBus {
+public:
+    std::vector<uint8_t> values;
+    bool fail = false;
+
+    bool write(uint8_t reg, const uint8_t* data, uint8_t len) override {
+        if (fail) return false;
+        TEST_ASSERT_EQUAL_HEX8(TAS5805M_REG_DIG_VOL, reg);
+        TEST_ASSERT_EQUAL_UINT8(1, len);
+        values.push_back(data[0]);
+        return true;
+    }
+    bool read(uint8_t reg, uint8_t* data, uint8_t len) override {
+        (void)reg;
+        (void)data;
+        (void)len;
+        return false;
+    }
+};
+
+static VolumeBus bus;
+
+void setUp() {
+    bus = VolumeBus();
+}
+
+void tearDown() {}
+
+static void tickUntilIdle(VolumeEngine& v) {
+    for (int i = 0; i < 1000 && v.busy(); i++) v.tick();
+}
+
+// Ganz oben ist Register 0x00 (+24 dB), 0 dB ist 0x30, ganz unten stumm
+static void test_level_range_reaches_plus_24_db() {
+    TEST_ASSERT_EQUAL_UINT16(168, VOLUME_LEVELS);
+    TEST_ASSERT_EQUAL_FLOAT(24.0f, VolumeEngine::toDb(VOLUME_LEVELS));
+    TEST_ASSERT_EQUAL_FLOAT(-60.0f, VolumeEngine::toDb(0));
+    TEST_ASSERT_EQUAL_UINT16(120, VolumeEngine::fromDb(0.0f));
+    TEST_ASSERT_EQUAL_UINT16(VOLUME_LEVELS, VolumeEngine::fromDb(30.0f));
+
+    Tas5805mVolumeSink sink(bus);
+    VolumeEngine v(120);
+    v.route(&sink, 120);
+    v.tick();
+    TEST_ASSERT_EQUAL_HEX8(0x30, bus.values.back());
+
+    v.set(VOLUME_LEVELS);
+    tickUntilIdle(v);
+    TEST_ASSERT_EQUAL_HEX8(0x00, bus.values.back());
+    v.step(5);
+    tickUntilIdle(v);
+    TEST_ASSERT_EQUAL_UINT16(VOLUME_LEVELS, v.current());
+
+    v.set(0);
+    tickUntilIdle(v);
+    TEST_ASSERT_EQUAL_HEX8(TAS5805M_DIG_VOL_MUTE, bus.values.back());
+    v.step(-5);
+    tickUntilIdle(v);
+    TEST_ASSERT_EQUAL_UINT16(0, v.target());
+}
+
+// 100 Rasten in 200 ms (eine alle 2 ms), Zeitscheibe 20 ms: je Scheibe höchstens ein Zugriff,
+// kein Sprung größer als die Rampe
+static void test_detents_coalesce_and_ramp() {
+    Tas5805mVolumeSink sink(bus);
+    VolumeEngine v(40);
+    v.route(&sink, 40);
+    v.tick();
+    bus.values.clear();
+
+    uint32_t ticks = 0;
+    for (uint32_t ms = 0; ms < 3000; ms += 2) {
+        if (ms < 200) v.step(1);
+        if (ms % VOLUME_SLICE_MS == 0) {
+            v.tick();
+            ticks++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(140, v.target());
+    TEST_ASSERT_EQUAL_UINT16(140, v.current());
+    TEST_ASSERT_EQUAL_HEX8(Tas5805mVolumeSink::registerValue(VolumeEngine::toDb(140), false), bus.values.back());
+    // Die erste Scheibe sieht erst eine Raste, danach volle Rampenschritte
+    TEST_ASSERT_EQUAL_UINT32(100 / VOLUME_RAMP_LEVELS + 1, bus.values.size());
+    TEST_ASSERT_LESS_OR_EQUAL(ticks, bus.values.size());
+    for (size_t i = 1; i < bus.values.size(); i++) {
+        TEST_ASSERT_LESS_OR_EQUAL(VOLUME_RAMP_LEVELS, abs((int)bus.values[i] - (int)bus.values[i - 1]));
+    }
+}
+
+// Vom Telefon geändert: übernehmen, nicht zurückschreiben
+static void test_sync_does_not_write() {
+    Tas5805mVolumeSink sink(bus);
+    VolumeEngine v(80);
+    v.route(&sink, 80);
+    v.tick();
+    size_t writes = bus.values.size();
+    v.sync(100);
+    TEST_ASSERT_FALSE(v.tick());
+    TEST_ASSERT_EQUAL(writes, bus.values.size());
+    TEST_ASSERT_EQUAL_UINT16(100, v.current());
+    v.step(1);
+    TEST_ASSERT_TRUE(v.tick());
+    TEST_ASSERT_EQUAL_UINT16(101, v.current());
+}
+
+// Neue Ausgabe: ihr Pegel gilt sofort, ohne Rampe
+static void test_route_jumps_to_new_sink() {
+    VolumeBus other;
+    Tas5805mVolumeSink amp(bus), second(other);
+    VolumeEngine v(10);
+    v.route(&amp, 10);
+    v.tick();
+    v.route(&second, 150);
+    TEST_ASSERT_TRUE(v.tick());
+    TEST_ASSERT_EQUAL_UINT16(150, v.current());
+    TEST_ASSERT_EQUAL(1, other.values.size());
+    TEST_ASSERT_EQUAL(1, bus.values.size());
+}
+
+// Fehlgeschlagener Zugriff wird in der nächsten Scheibe wiederholt
+static void test_failed_write_is_retried() {
+    Tas5805mVolumeSink sink(bus);
+    VolumeEngine v(60);
+    v.route(&sink, 60);
+    bus.fail = true;
+    TEST_ASSERT_FALSE(v.tick());
+    bus.fail = false;
+    TEST_ASSERT_TRUE(v.tick());
+    TEST_ASSERT_EQUAL(1, bus.values.size());
+    TEST_ASSERT_EQUAL_UINT32(1, v.writes());
+}
+
+// Rasten aus zwei Tasks gleichzeitig gehen nicht verloren (ohne tick() dazwischen, sonst
+// würde ein Zwischenstand am Rand abgeschnitten)
+static void test_steps_from_two_threads() {
+    VolumeEngine v(84);
+    std::thread up([&] { for (int i = 0; i < 20000; i++) v.step(1); });
+    std::thread down([&] { for (int i = 0; i < 20030; i++) v.step(-1); });
+    up.join();
+    down.join();
+    tickUntilIdle(v);
+    TEST_ASSERT_EQUAL_UINT16(54, v.target());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_level_range_reaches_plus_24_db);
+    RUN_TEST(test_detents_coalesce_and_ramp);
+    RUN_TEST(test_sync_does_not_write);
+    RUN_TEST(test_route_jumps_to_new_sink);
+    RUN_TEST(test_failed_write_is_retried);
+    RUN_TEST(test_steps_from_two_threads);
+    return UNITY_END();
+}
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""Simulated internet radio station with a bad network, for testing the device on the LAN.
+
+Serves an MP3 file (looped) or a byte pattern as a live ICY/HTTP stream and applies the same
+faults as StreamFaultInjector (src/stream_fault.*): bandwidth limit, random jitter after each
+chunk, periodic stalls and forced disconnects. Redirect faults are fixed routes:
+
+  /live              the stream
+  /redirect          302 -> /live
+  /playlist.m3u      M3U playlist -> /live
+  /playlist.pls      PLS playlist -> /live
+  /loop              302 -> /loop2 -> /loop ... (redirect loop)
+  /bad-location      302 with a Location the radio cannot follow
+  /empty-location    302 with an empty Location
+
+Example, then point a station entry at http://<pc>:8000/live:
+
+  tools/icy_sim.py --file test.mp3 --bandwidth-kbps 96 --jitter-ms 300 --stall-every-s 60
+"""
+import argparse
+import random
+import socket
+import socketserver
+import time
+
+CHUNK = 1024
+
+
+class Faults:
+    """Token-Bucket, Jitter, Stalls und Abbrüche wie StreamFaultInjector."""
+
+    def __init__(self, args, seed):
+        self.args = args
+        self.rand = random.Random(seed)
+        now = time.monotonic()
+        self.last_refill = now
+        self.tokens = 0.0
+        self.stall_until = now
+        self.jitter_until = now
+        self.next_stall = now + args.stall_every_s
+        self.next_disconnect = now + args.disconnect_every_s
+
+    def allow(self, want):
+        """(jetzt zu sendende Bytes, Verbindung kappen)"""
+        a = self.args
+        now = time.monotonic()
+        if a.disconnect_every_s > 0 and now >= self.next_disconnect:
+            return 0, True
+        if a.stall_every_s > 0 and now >= self.next_stall:
+            self.stall_until = now + a.stall_ms / 1000.0
+            self.next_stall += a.stall_every_s
+            print("[sim] stall %d ms" % a.stall_ms)
+        if now < self.stall_until:
+            self.last_refill = now
+            return 0, False
+        if a.bandwidth_kbps > 0:
+            per_s = a.bandwidth_kbps * 1000 / 8.0
+            bucket = per_s * max(a.jitter_ms, 100) / 1000.0
+            self.tokens = min(self.tokens + (now - self.last_refill) * per_s, bucket)
+            self.last_refill = now
+        if now < self.jitter_until:
+            return 0, False
+        if a.bandwidth_kbps <= 0:
+            return want, False
+        return min(want, int(self.tokens)), False
+
+    def consumed(self, n):
+        self.tokens = max(self.tokens - n, 0.0)
+        if self.args.jitter_ms > 0:
+            self.jitter_until = time.monotonic() + self.rand.randint(0, self.args.jitter_ms) / 1000.0
+
+
+class Source:
+    """Live-Quelle: die Datei in Schleife (oder das Muster aus test/mocks/icy_server.h) mit der
+    Bitrate, beim Verbinden --burst-s Sekunden auf einmal wie bei Icecast."""
+
+    def __init__(self, args):
+        self.data = open(args.file, "rb").read() if args.file else None
+        self.rate = args.bitrate_kbps * 1000 / 8.0
+        self.start = time.monotonic() - args.burst_s
+        self.pos = 0
+
+    def available(self):
+        return int((time.monotonic() - self.start) * self.rate) - self.pos
+
+    def read(self, n):
+        if self.data:
+            out = bytearray()
+            while len(out) < n:
+                i = (self.pos + len(out)) % len(self.data)
+                out += self.data[i:i + n - len(out)]
+        else:
+            out = bytes(((self.pos + i) * 7 + ((self.pos + i) >> 9)) & 0xFF for i in range(n))
+        self.pos += n
+        return bytes(out)
+
+
+class Handler(socketserver.BaseRequestHandler):
+    def handle(self):
+        args = self.server.args
+        request = b""
+        while b"\r\n\r\n" not in request:
+            part = self.request.recv(1024)
+            if not part:
+                return
+            request += part
+        line = request.split(b"\r\n", 1)[0].decode("latin-1")
+        path = line.split(" ")[1] if line.count(" ") >= 2 else "/"
+        print("[sim] %s %s" % (self.client_address[0], line))
+
+        host = "%s:%d" % (args.advertise or socket.gethostname(), args.port)
+        routes = {
+            "/redirect": "HTTP/1.1 302 Found\r\nLocation: http://%s/live\r\n" % host,
+            "/loop": "HTTP/1.1 302 Found\r\nLocation: /loop2\r\n",
+            "/loop2": "HTTP/1.1 302 Found\r\nLocation: http://%s/loop\r\n" % host,
+            "/bad-location": "HTTP/1.1 302 Found\r\nLocation: ftp://[broken\r\n",
+            "/empty-location": "HTTP/1.1 302 Found\r\nLocation: \r\n",
+        }
+        if path in routes:
+            self.send(routes[path] + "\r\n")
+        elif path == "/playlist.m3u":
+            self.send("HTTP/1.0 200 OK\r\nContent-Type: audio/x-mpegurl\r\n\r\n"
+                      "#EXTM3U\r\n#EXTINF:-1,Simulator\r\nhttp://%s/live\r\n" % host)
+        elif path == "/playlist.pls":
+            self.send("HTTP/1.0 200 OK\r\nContent-Type: audio/x-scpls\r\n\r\n"
+                      "[playlist]\r\nNumberOfEntries=1\r\nFile1=http://%s/live\r\n" % host)
+        elif path == "/live":
+            self.send("ICY 200 OK\r\nContent-Type: audio/mpeg\r\nicy-br: %d\r\nicy-name: Simulator\r\n\r\n"
+                      % args.bitrate_kbps)
+            self.stream(args)
+        else:
+            self.send("HTTP/1.0 404 Not Found\r\n\r\n")
+
+    def send(self, text):
+        self.request.sendall(text.encode("latin-1"))
+
+    def stream(self, args):
+        self.server.connections += 1
+        faults = Faults(args, args.seed + self.server.connections)
+        source = Source(args)
+        sent = 0
+        try:
+            while True:
+                n, cut = faults.allow(min(CHUNK, max(source.available(), 0)))
+                if cut:
+                    print("[sim] disconnect after %d bytes" % sent)
+                    return
+                if n == 0:
+                    time.sleep(0.001)
+                    continue
+                self.request.sendall(source.read(n))
+                faults.consumed(n)
+                sent += n
+        except (BrokenPipeError, ConnectionResetError):
+            print("[sim] client closed after %d bytes" % sent)
+
+
+class Server(socketserver.ThreadingTCPServer):
+    allow_reuse_address = True
+    daemon_threads = True
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("--port", type=int, default=8000)
+    p.add_argument("--advertise", help="host name or IP put into redirects and playlists")
+    p.add_argument("--file", help="MP3 file to stream in a loop (default: byte pattern)")
+    p.add_argument("--bitrate-kbps", type=int, default=128, help="rate of the live source")
+    p.add_argument("--burst-s", type=float, default=2.0, help="data available at once on connect")
+    p.add_argument("--bandwidth-kbps", type=int, default=0, help="link limit (0 = off)")
+    p.add_argument("--jitter-ms", type=int, default=0, help="random pause of up to N ms after each chunk")
+    p.add_argument("--stall-every-s", type=int, default=0, help="no data every N seconds")
+    p.add_argument("--stall-ms", type=int, default=3000, help="length of each stall")
+    p.add_argument("--disconnect-every-s", type=int, default=0, help="drop the connection every N seconds")
+    p.add_argument("--seed", type=int, default=1, help="jitter seed (runs are reproducible)")
+    args = p.parse_args()
+
+    server = Server(("", args.port), Handler)
+    server.args = args
+    server.connections = 0
+    print("[sim] listening on port %d" % args.port)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
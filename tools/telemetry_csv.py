@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Extracts the telemetry lines ("T,...", -D TELEMETRY_CSV) from a serial log.
+
+Writes them as one CSV with the device's header. A new header line or a jump back in `ms` marks
+a reboot; the added column `boot` counts them. Lines cut off or garbled on the serial line (wrong
+field count, non-numeric values) are skipped and reported on stderr.
+
+  tools/telemetry_csv.py serial.log -o telemetry.csv
+  pio device monitor | tools/telemetry_csv.py --summary
+"""
+import argparse
+import csv
+import re
+import sys
+
+# Zähler, die seit dem Start nur wachsen; in der Zusammenfassung zählt der Zuwachs
+CUMULATIVE = ("underruns", "reconnects", "a2dp_gaps")
+
+# "T," am Zeilenanfang oder nach dem Zeitstempel des Monitors, nicht mitten in einem Wort
+MARKER = re.compile(r"(?:^|[^A-Za-z0-9_])T,")
+
+
+def parse(lines):
+    """Liefert (Spaltennamen, Zeilen als Listen von int mit boot vorne, übersprungene Zeilen,
+    Starts, die mit dem Header beginnen und deren Zähler also bei 0 anfangen)."""
+    header = None
+    rows = []
+    skipped = 0
+    boot = 0
+    fresh = set()
+    last_ms = None
+    for raw in lines:
+        # Serielle Logs enthalten oft \r und Zeitstempel des Monitors vor dem "T,"
+        m = MARKER.search(raw.strip())
+        if not m:
+            continue
+        fields = raw.strip()[m.end():].split(",")
+        if fields and fields[0] == "ms":
+            if header is not None:
+                boot += 1
+            header = fields
+            fresh.add(boot)
+            last_ms = None
+            continue
+        if header is None or len(fields) != len(header):
+            skipped += 1
+            continue
+        try:
+            values = [int(v) for v in fields]
+        except ValueError:
+            skipped += 1
+            continue
+        if last_ms is not None and values[0] < last_ms:
+            boot += 1  # Neustart ohne Header (Header ging im Monitor verloren)
+        last_ms = values[0]
+        rows.append([boot] + values)
+    return (["boot"] + header if header else []), rows, skipped, fresh
+
+
+def summary(columns, rows, fresh, out):
+    if not rows:
+        out.write("keine Telemetrie-Zeilen\n")
+        return
+    boots = rows[-1][0] + 1
+    span_s = sum(_span(rows, b) for b in range(boots)) / 1000.0
+    out.write("%d Zeilen, %d Start(s), %.0f s\n" % (len(rows), boots, span_s))
+    for i, name in enumerate(columns):
+        if name in ("boot", "ms"):
+            continue
+        values = [r[i] for r in rows]
+        if name in CUMULATIVE:
+            # Zuwachs je Start, über alle Starts summiert; ohne Header fehlt der Anfang des Starts
+            grown = 0
+            for b in range(boots):
+                seg = [r[i] for r in rows if r[0] == b]
+                if seg:
+                    grown += seg[-1] - (0 if b in fresh else seg[0])
+            out.write("  %-18s +%d\n" % (name, grown))
+        else:
+            out.write("  %-18s min %d  max %d  letzter %d\n" % (name, min(values), max(values), values[-1]))
+
+
+def _span(rows, boot):
+    ms = [r[1] for r in rows if r[0] == boot]
+    return ms[-1] - ms[0] if ms else 0
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("log", nargs="?", help="serial log (default: stdin)")
+    p.add_argument("-o", "--output", help="CSV file (default: stdout)")
+    p.add_argument("--summary", action="store_true", help="print min/max and counter growth instead of CSV")
+    args = p.parse_args()
+
+    src = open(args.log, encoding="utf-8", errors="replace") if args.log else sys.stdin
+    with src:
+        columns, rows, skipped, fresh = parse(src)
+    if skipped:
+        sys.stderr.write("%d beschädigte Telemetrie-Zeile(n) übersprungen\n" % skipped)
+
+    if args.summary:
+        summary(columns, rows, fresh, sys.stdout)
+        return
+    dst = open(args.output, "w", newline="") if args.output else sys.stdout
+    with dst:
+        w = csv.writer(dst, lineterminator="\n")
+        if columns:
+            w.writerow(columns)
+        w.writerows(rows)
+
+
+if __name__ == "__main__":
+    main()